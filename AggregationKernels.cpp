@@ -0,0 +1,298 @@
+#include "AggregationKernels.h"
+#include "db.h"    // getConfigInt()
+#include "utils.h" // readInt()
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define AVX2_KERNELS 1
+#define AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AVX2_KERNELS 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+using namespace std;
+
+// ==========================================
+// BUCKET MAPS
+// ==========================================
+
+int32_t epochDay(int year, int month, int day) {
+    // Civil-to-days over 400-year eras, years starting in March
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = year - era * 400;
+    const int doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+namespace {
+    // One bucket per key
+    BucketMap identityBuckets(int32_t firstKey, int keys) {
+        BucketMap map;
+        map.firstKey = firstKey;
+        map.buckets = static_cast<size_t>(max(keys, 0));
+        map.slotOfKey.resize(map.buckets);
+        for (size_t k = 0; k < map.buckets; k++) map.slotOfKey[k] = static_cast<uint32_t>(k);
+        return map;
+    }
+}
+
+BucketMap dayBuckets(int32_t firstDay, int days) { return identityBuckets(firstDay, days); }
+
+BucketMap hourBuckets(int32_t firstHour, int hours) { return identityBuckets(firstHour, hours); }
+
+BucketMap monthBuckets(int year, int month, int months) {
+    const int first = year * 12 + month - 1;
+    auto monthStart = [first](int m) { int ym = first + m; return epochDay(ym / 12, ym % 12 + 1, 1); };
+
+    BucketMap map;
+    map.firstKey = monthStart(0);
+    map.buckets = static_cast<size_t>(max(months, 0));
+    for (int m = 0; m < months; m++) map.slotOfKey.resize(monthStart(m + 1) - map.firstKey, static_cast<uint32_t>(m));
+    return map;
+}
+
+// ==========================================
+// KERNELS
+// ==========================================
+
+namespace {
+    const size_t BLOCK_ROWS = 2048;  // slots for one block stay in L1
+    const size_t COPIES = 4;         // accumulator sets; a power of two
+
+    bool cpuHasAvx2() {
+#if defined(AVX2_KERNELS) && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        // The OS must save the YMM registers (OSXSAVE + AVX, then XCR0 bits 1 and 2)
+        if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6) return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(AVX2_KERNELS)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        return false;
+#endif
+    }
+
+    bool useAvx2() {
+        static const bool use = getConfigInt("SIMD_KERNELS", 1) != 0 && cpuHasAvx2();
+        return use;
+    }
+
+    // Slot of one row; map.buckets is the spare slot
+    inline uint32_t slotOf(const BucketMap& map, int32_t key, uint8_t status, uint32_t statusMask) {
+        // A key below firstKey wraps to a large offset
+        const uint32_t offset = static_cast<uint32_t>(key) - static_cast<uint32_t>(map.firstKey);
+        const bool inSpan = offset < map.slotOfKey.size();
+        const bool wanted = status < 32 && ((statusMask >> (status & 31)) & 1u) != 0;
+        return (inSpan & wanted) ? map.slotOfKey[inSpan ? offset : 0] : static_cast<uint32_t>(map.buckets);
+    }
+
+    // Row i adds to accumulator set i % COPIES
+    inline void add(BucketStats* sets, size_t stride, size_t i, uint32_t slot, int64_t value) {
+        BucketStats& stats = sets[(i & (COPIES - 1)) * stride + slot];
+        stats.count++;
+        stats.sum += value;
+        stats.min = min(stats.min, value);
+        stats.max = max(stats.max, value);
+    }
+
+    // Portable path: both steps fused, row by row
+    void aggregatePortable(const BucketMap& map, const int32_t* key, const uint8_t* status, const int64_t* value,
+        size_t rows, uint32_t statusMask, BucketStats* sets, size_t stride) {
+        for (size_t i = 0; i < rows; i++) add(sets, stride, i, slotOf(map, key[i], status[i], statusMask), value[i]);
+    }
+
+#ifdef AVX2_KERNELS
+    // AVX2 path: slots for a block of rows 8 at a time, then the block's adds
+    AVX2_TARGET void aggregateAvx2(const BucketMap& map, const int32_t* key, const uint8_t* status, const int64_t* value,
+        size_t rows, uint32_t statusMask, BucketStats* sets, size_t stride) {
+        const __m256i bias = _mm256_set1_epi32(numeric_limits<int32_t>::min());
+        const __m256i first = _mm256_set1_epi32(map.firstKey);
+        const __m256i spanBiased = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(map.slotOfKey.size())), bias);
+        const __m256i spare = _mm256_set1_epi32(static_cast<int32_t>(map.buckets));
+        const __m256i mask = _mm256_set1_epi32(static_cast<int32_t>(statusMask));
+        const __m256i one = _mm256_set1_epi32(1);
+        const int* table = reinterpret_cast<const int*>(map.slotOfKey.data());
+        uint32_t slots[BLOCK_ROWS];
+
+        for (size_t begin = 0; begin < rows; begin += BLOCK_ROWS) {
+            const size_t count = min(BLOCK_ROWS, rows - begin);
+            const int32_t* k = key + begin;
+            const uint8_t* s = status + begin;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i offset = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(k + i)), first);
+                // Unsigned offset < span, as a signed compare of sign-flipped values
+                __m256i inSpan = _mm256_cmpgt_epi32(spanBiased, _mm256_xor_si256(offset, bias));
+                __m256i codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + i)));
+                // Shifts of 32 or more give 0, so codes above 31 never match
+                __m256i wanted = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srlv_epi32(mask, codes), one), one);
+                __m256i keep = _mm256_and_si256(inSpan, wanted);
+                // Lanes not kept read nothing and take the spare slot
+                __m256i slot = _mm256_mask_i32gather_epi32(spare, table, _mm256_and_si256(offset, keep), keep, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(slots + i), slot);
+            }
+            for (; i < count; i++) slots[i] = slotOf(map, k[i], s[i], statusMask);
+            for (i = 0; i < count; i++) add(sets, stride, i, slots[i], value[begin + i]);
+        }
+    }
+#endif
+}
+
+std::vector<BucketStats> bucketAggregate(const BucketMap& map, const int32_t* key, const uint8_t* status,
+    const int64_t* value, size_t rows, uint32_t statusMask, KernelPath path) {
+    vector<BucketStats> result(map.buckets);
+    if (map.buckets == 0 || rows == 0) return result;
+
+    const size_t stride = map.buckets + 1;  // + spare slot
+    vector<BucketStats> sets(COPIES * stride);
+#ifdef AVX2_KERNELS
+    if (path == KernelPath::Auto ? useAvx2() : (path == KernelPath::Avx2 && cpuHasAvx2()))
+        aggregateAvx2(map, key, status, value, rows, statusMask, sets.data(), stride);
+    else
+#endif
+    aggregatePortable(map, key, status, value, rows, statusMask, sets.data(), stride);
+
+    for (size_t b = 0; b < map.buckets; b++) {
+        for (size_t c = 0; c < COPIES; c++) {
+            const BucketStats& part = sets[c * stride + b];
+            result[b].count += part.count;
+            result[b].sum += part.sum;
+            result[b].min = min(result[b].min, part.min);
+            result[b].max = max(result[b].max, part.max);
+        }
+    }
+    return result;
+}
+
+const char* activeKernelPath() {
+    return useAvx2() ? "avx2" : "portable";
+}
+
+// ==========================================
+// BENCHMARK
+// ==========================================
+
+namespace {
+    // The loop the kernels replace: a test and a lookup per row
+    vector<BucketStats> scalarAggregate(const BucketMap& map, const vector<int32_t>& key,
+        const vector<uint8_t>& status, const vector<int64_t>& value, uint8_t wanted) {
+        vector<BucketStats> result(map.buckets);
+        const int64_t span = static_cast<int64_t>(map.slotOfKey.size());
+        for (size_t i = 0; i < key.size(); i++) {
+            if (status[i] != wanted) continue;
+            int64_t offset = static_cast<int64_t>(key[i]) - map.firstKey;
+            if (offset < 0 || offset >= span) continue;
+            BucketStats& stats = result[map.slotOfKey[offset]];
+            stats.count++;
+            stats.sum += value[i];
+            if (value[i] < stats.min) stats.min = value[i];
+            if (value[i] > stats.max) stats.max = value[i];
+        }
+        return result;
+    }
+
+    bool sameStats(const vector<BucketStats>& a, const vector<BucketStats>& b) {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].count != b[i].count || a[i].sum != b[i].sum || a[i].min != b[i].min || a[i].max != b[i].max)
+                return false;
+        }
+        return true;
+    }
+
+    // Best of five runs, in milliseconds; `out` keeps the last result
+    template <typename Fn>
+    double bestMs(Fn fn, vector<BucketStats>& out) {
+        double best = numeric_limits<double>::max();
+        for (int run = 0; run < 5; run++) {
+            auto start = chrono::steady_clock::now();
+            out = fn();
+            best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+void runAggregationKernelBenchmark() {
+    cout << "\n--- Aggregation Kernel Benchmark ---\n";
+    int rows = readInt("Synthetic payments (e.g., 10000000): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (rows < 1000) {
+        cout << "[Error] Use at least 1000 rows.\n";
+        return;
+    }
+
+    // Two years of payments in time order, as they are loaded: 1 in 8
+    // Insufficient (code 1), $1-$500 in cents
+    const int32_t firstDay = epochDay(2024, 1, 1);
+    vector<int32_t> day(rows), hour(rows);
+    vector<uint8_t> status(rows);
+    vector<int64_t> cents(rows);
+    mt19937 rng(42);
+    for (int i = 0; i < rows; i++) hour[i] = firstDay * 24 + static_cast<int32_t>(rng() % (731 * 24));
+    sort(hour.begin(), hour.end());
+    for (int i = 0; i < rows; i++) {
+        day[i] = hour[i] / 24;
+        status[i] = (rng() % 8 == 0) ? 1 : 0;
+        cents[i] = 100 + static_cast<int64_t>(rng() % 50000);
+    }
+
+    struct Case {
+        const char* name;
+        BucketMap map;
+        const vector<int32_t>* keys;
+    };
+    const Case cases[] = {
+        { "Daily (2024)", dayBuckets(firstDay, 366), &day },
+        { "Monthly (24)", monthBuckets(2024, 1, 24), &day },
+        { "Hourly (1 week)", hourBuckets((firstDay + 100) * 24, 168), &hour },
+    };
+
+    bool avx2 = cpuHasAvx2();
+    cout << "Kernel in use: " << activeKernelPath() << (avx2 ? "" : " (no AVX2 on this CPU)") << "\n\n";
+    cout << left << setw(18) << "Bucketing" << right << setw(14) << "Scalar (ms)" << setw(16) << "Portable (ms)"
+        << setw(13) << "AVX2 (ms)" << setw(10) << "Speedup" << setw(8) << "Match" << "\n";
+    cout << string(79, '-') << "\n";
+
+    for (const Case& c : cases) {
+        vector<BucketStats> expected, portable, simd;
+        double scalarMs = bestMs([&]() { return scalarAggregate(c.map, *c.keys, status, cents, 0); }, expected);
+        double portableMs = bestMs([&]() {
+            return bucketAggregate(c.map, c.keys->data(), status.data(), cents.data(), rows, 1u, KernelPath::Portable);
+            }, portable);
+        double simdMs = 0.0;
+        bool match = sameStats(expected, portable);
+        if (avx2) {
+            simdMs = bestMs([&]() {
+                return bucketAggregate(c.map, c.keys->data(), status.data(), cents.data(), rows, 1u, KernelPath::Avx2);
+                }, simd);
+            match = match && sameStats(expected, simd);
+        }
+        double fastest = avx2 ? min(portableMs, simdMs) : portableMs;
+        ostringstream simdCell;
+        if (avx2) simdCell << fixed << setprecision(2) << simdMs;
+        else simdCell << "n/a";
+
+        cout << left << setw(18) << c.name << right << fixed << setprecision(2) << setw(14) << scalarMs
+            << setw(16) << portableMs << setw(13) << simdCell.str()
+            << setw(9) << (fastest > 0 ? scalarMs / fastest : 0.0) << "x" << setw(8) << (match ? "yes" : "NO") << "\n";
+    }
+    cout << "(" << rows << " rows, best of 5 runs each.)\n";
+}
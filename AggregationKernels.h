@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// ==========================================
+// BUCKETED AGGREGATION KERNELS
+// ==========================================
+// Sum, count, min and max of an int64 column, grouped into day, month or hour
+// buckets, over rows whose status code is in a mask. The in-memory sales
+// reports (PaymentAnalytics.h) use these instead of GROUP BY MONTH(TimeStamp).
+//
+// The AVX2 path works through blocks of rows in two steps:
+//   1. slot   key -> bucket through a lookup table, 8 rows per instruction (a
+//             gather for the lookup). The range and status tests are folded
+//             in, and rows that fail go to a spare slot.
+//   2. add    each value into its slot.
+// The portable path does both steps row by row without branches. Either way,
+// four sets of accumulators take turns. Rows arrive in time order, so
+// neighbouring rows often share a bucket, and this way they don't wait on
+// each other's stores.
+// AVX2 is chosen at run time if the CPU and OS support it and SIMD_KERNELS
+// in config.ini is not 0. Otherwise the portable C++ path runs. Both return
+// identical results.
+
+// Days since 1970-01-01 (proleptic Gregorian)
+int32_t epochDay(int year, int month, int day);
+
+// Key -> bucket. Keys are day numbers (epochDay) or hour numbers (day * 24 + hour).
+struct BucketMap {
+    int32_t firstKey = 0;
+    std::vector<uint32_t> slotOfKey;  // indexed by key - firstKey
+    size_t buckets = 0;
+};
+
+BucketMap dayBuckets(int32_t firstDay, int days);
+BucketMap monthBuckets(int year, int month, int months);  // over day keys
+BucketMap hourBuckets(int32_t firstHour, int hours);
+
+struct BucketStats {
+    long long count = 0;
+    int64_t sum = 0;
+    int64_t min = std::numeric_limits<int64_t>::max();  // untouched while count is 0
+    int64_t max = std::numeric_limits<int64_t>::min();
+};
+
+enum class KernelPath { Auto, Portable, Avx2 };
+
+// One BucketStats per bucket of `map`, over rows whose key is mapped and whose
+// status bit is set in `statusMask` (bit n = code n; codes above 31 never
+// match). Avx2 on a CPU without it runs Portable.
+std::vector<BucketStats> bucketAggregate(const BucketMap& map, const int32_t* key, const uint8_t* status,
+    const int64_t* value, size_t rows, uint32_t statusMask, KernelPath path = KernelPath::Auto);
+
+// "avx2" or "portable": what Auto runs on this machine
+const char* activeKernelPath();
+
+// System Maintenance command: both kernel paths against a plain loop on synthetic payments
+void runAggregationKernelBenchmark();
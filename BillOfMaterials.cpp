@@ -0,0 +1,205 @@
+#include "BillOfMaterials.h"
+#include <map>
+#include <mutex>
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+const char* const STANDARD_JOB_TYPE = "Standard";
+
+// ==========================================
+// TABLE & IN-MEMORY COPY
+// ==========================================
+
+namespace {
+    mutex g_bomMutex;
+    bool g_bomLoaded = false;
+    vector<BomLine> g_lines;                           // all lines, grouped by job type
+    map<string, pair<size_t, size_t>> g_ranges;        // job type -> (first, count) in g_lines
+    map<int, string> g_names;                          // InventoryID -> ItemType
+
+    // Caller holds g_bomMutex
+    void loadBom(Connection* con) {
+        vector<BomLine> lines;
+        map<string, pair<size_t, size_t>> ranges;
+        map<int, string> names;
+
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(
+            "SELECT b.JobType, b.InventoryID, ROUND(b.UnitsPerPage * 10000) AS Per10k, i.ItemType "
+            "FROM job_bom b LEFT JOIN inventory i ON i.InventoryID = b.InventoryID "
+            "ORDER BY b.JobType, b.InventoryID"
+        ));
+        while (res->next()) {
+            string jobType = res->getString("JobType");
+            BomLine line;
+            line.inventoryID = res->getInt("InventoryID");
+            line.unitsPer10kPages = res->getInt64("Per10k");
+
+            auto found = ranges.find(jobType);
+            if (found == ranges.end()) ranges[jobType] = make_pair(lines.size(), static_cast<size_t>(1));
+            else found->second.second++;
+            lines.push_back(line);
+
+            if (!res->isNull("ItemType")) names[line.inventoryID] = res->getString("ItemType");
+        }
+
+        g_lines.swap(lines);
+        g_ranges.swap(ranges);
+        g_names.swap(names);
+        g_bomLoaded = true;
+    }
+}
+
+BomRange bomForJobType(sql::Connection* con, const std::string& jobType) {
+    lock_guard<mutex> lock(g_bomMutex);
+    if (!g_bomLoaded) loadBom(con);
+
+    BomRange range;
+    auto found = g_ranges.find(jobType);
+    if (found != g_ranges.end()) {
+        range.first = g_lines.data() + found->second.first;
+        range.count = found->second.second;
+    }
+    return range;
+}
+
+void reloadBillOfMaterials(sql::Connection* con) {
+    lock_guard<mutex> lock(g_bomMutex);
+    loadBom(con);
+}
+
+std::string materialName(sql::Connection* con, int inventoryID) {
+    bomForJobType(con); // make sure the names are loaded
+    lock_guard<mutex> lock(g_bomMutex);
+    auto found = g_names.find(inventoryID);
+    return found != g_names.end() ? found->second : "Item #" + to_string(inventoryID);
+}
+
+// ==========================================
+// NEEDS & WRITES
+// ==========================================
+
+vector<MaterialNeed> materialsForPages(BomRange bom, int pageCount) {
+    vector<MaterialNeed> needs;
+    needs.reserve(bom.count);
+    for (const BomLine& line : bom) needs.push_back({ line.inventoryID, unitsForPages(line, pageCount) });
+    return needs;
+}
+
+vector<MaterialNeed> materialDeltaForPages(BomRange bom, int oldPages, int newPages) {
+    vector<MaterialNeed> needs;
+    for (const BomLine& line : bom) {
+        long long delta = unitsForPages(line, newPages) - unitsForPages(line, oldPages);
+        if (delta != 0) needs.push_back({ line.inventoryID, delta });
+    }
+    return needs;
+}
+
+namespace {
+    // "CASE InventoryID WHEN ? THEN ? ... END" for n items
+    string caseByInventoryID(size_t n) {
+        string sql = "CASE InventoryID";
+        for (size_t i = 0; i < n; i++) sql += " WHEN ? THEN ?";
+        return sql + " END";
+    }
+
+    int bindCase(PreparedStatement* pstmt, int idx, const vector<MaterialNeed>& needs) {
+        for (const MaterialNeed& need : needs) {
+            pstmt->setInt(idx++, need.inventoryID);
+            pstmt->setInt64(idx++, need.units);
+        }
+        return idx;
+    }
+}
+
+void applyMaterialUsage(sql::Connection* con, const std::vector<MaterialNeed>& needs, bool guarded) {
+    vector<MaterialNeed> items;
+    for (const MaterialNeed& need : needs) {
+        if (need.units != 0) items.push_back(need);
+    }
+    if (items.empty()) return;
+
+    // Guarded decrements re-check stock under the row lock, so two terminals
+    // racing past the stock check cannot both take the last units
+    string amount = caseByInventoryID(items.size());
+    string sql = "UPDATE inventory SET Quantity = Quantity - " + amount + " WHERE InventoryID IN (";
+    for (size_t i = 0; i < items.size(); i++) sql += (i == 0) ? "?" : ", ?";
+    sql += ")";
+    if (guarded) sql += " AND Quantity >= " + amount;
+
+    unique_ptr<PreparedStatement> update(con->prepareStatement(sql));
+    int idx = bindCase(update.get(), 1, items);
+    for (const MaterialNeed& need : items) update->setInt(idx++, need.inventoryID);
+    if (guarded) bindCase(update.get(), idx, items);
+
+    if (update->executeUpdate() < static_cast<int>(items.size()) && guarded) {
+        // Rows that passed were already decremented, so the short item cannot be told
+        // apart afterwards; the caller rolls the whole job back
+        throw SQLException("Insufficient inventory (changed by another terminal)");
+    }
+}
+
+namespace {
+    struct UsageRow {
+        MaterialNeed need;
+        string timeStamp;  // empty = NOW()
+    };
+
+    void insertUsageRows(Connection* con, const vector<UsageRow>& rows) {
+        string sql = "INSERT INTO inventoryconsumption (InventoryID, QuantityUsed, TimeStamp) VALUES ";
+        size_t written = 0;
+        for (const UsageRow& row : rows) {
+            if (row.need.units == 0) continue;
+            sql += written++ == 0 ? "" : ", ";
+            sql += row.timeStamp.empty() ? "(?, ?, NOW())" : "(?, ?, ?)";
+        }
+        if (written == 0) return;
+
+        unique_ptr<PreparedStatement> log(con->prepareStatement(sql));
+        int idx = 1;
+        for (const UsageRow& row : rows) {
+            if (row.need.units == 0) continue;
+            log->setInt(idx++, row.need.inventoryID);
+            log->setInt64(idx++, row.need.units);
+            if (!row.timeStamp.empty()) log->setString(idx++, row.timeStamp);
+        }
+        log->executeUpdate();
+    }
+}
+
+void logMaterialUsage(sql::Connection* con, const std::vector<MaterialNeed>& needs, const std::string& timeStamp) {
+    vector<UsageRow> rows;
+    for (const MaterialNeed& need : needs) rows.push_back({ need, timeStamp });
+    insertUsageRows(con, rows);
+}
+
+// ==========================================
+// CROSS-JOB BATCH
+// ==========================================
+
+void ConsumptionBatch::add(const std::vector<MaterialNeed>& needs, const std::string& timeStamp) {
+    for (const MaterialNeed& need : needs) totals_[make_pair(timeStamp, need.inventoryID)] += need.units;
+    jobs_++;
+}
+
+void ConsumptionBatch::flush(sql::Connection* con) {
+    // Stock moves by the per-item sum; the log keeps one row per item and timestamp
+    map<int, long long> byItem;
+    vector<UsageRow> rows;
+    for (const auto& total : totals_) {
+        byItem[total.first.second] += total.second;
+        rows.push_back({ { total.first.second, total.second }, total.first.first });
+    }
+    vector<MaterialNeed> needs;
+    for (const auto& item : byItem) needs.push_back({ item.first, item.second });
+    applyMaterialUsage(con, needs, false);
+    insertUsageRows(con, rows);
+    totals_.clear();
+    jobs_ = 0;
+}
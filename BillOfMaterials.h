@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mysql_connection.h>
+
+// ==========================================
+// BILL OF MATERIALS (consumption ratios)
+// ==========================================
+// `job_bom` says what one job type draws from stock per page:
+//   JobType | InventoryID | UnitsPerPage (DECIMAL, e.g. 1.0000 paper, 0.0100 ink)
+// Each line's need is rounded up per job, so 0.01 ink/page reproduces the old
+// "1 unit per started 100 pages" rule. The table is read once into one flat
+// array (lines grouped by job type); stock checks and consumption writes walk
+// that array, so new items (colour toner, binding...) need only a table row.
+//
+// Schema migration 5 creates the table and seeds the Standard job: Paper 1/page,
+// Ink 0.01/page, resolved to InventoryIDs by ItemType.
+
+// UnitsPerPage is held as an integer per 10,000 pages to keep the math exact
+struct BomLine {
+    int inventoryID;
+    long long unitsPer10kPages;
+};
+
+struct MaterialNeed {
+    int inventoryID;
+    long long units;
+};
+
+// Contiguous slice of the flat BOM array for one job type
+struct BomRange {
+    const BomLine* first = nullptr;
+    size_t count = 0;
+    const BomLine* begin() const { return first; }
+    const BomLine* end() const { return first + count; }
+    bool empty() const { return count == 0; }
+};
+
+extern const char* const STANDARD_JOB_TYPE;
+
+// Lines for a job type (empty range if unknown). Loads the table on first call;
+// throws sql::SQLException if it cannot be read.
+BomRange bomForJobType(sql::Connection* con, const std::string& jobType = STANDARD_JOB_TYPE);
+
+// Re-reads job_bom (after editing it). Not safe while another thread is using a range.
+void reloadBillOfMaterials(sql::Connection* con);
+
+// Units of one line needed for a job (rounded up)
+inline long long unitsForPages(const BomLine& line, int pageCount) {
+    long long scaled = line.unitsPer10kPages * pageCount;
+    return scaled >= 0 ? (scaled + 9999) / 10000 : -((-scaled + 9999) / 10000);
+}
+
+std::vector<MaterialNeed> materialsForPages(BomRange bom, int pageCount);
+
+// Per-item difference when a job changes from oldPages to newPages (positive = draw more)
+std::vector<MaterialNeed> materialDeltaForPages(BomRange bom, int oldPages, int newPages);
+
+// Subtracts all needs from inventory in one UPDATE ... CASE InventoryID. When guarded,
+// a row without enough stock makes it throw sql::SQLException and the caller rolls back.
+void applyMaterialUsage(sql::Connection* con, const std::vector<MaterialNeed>& needs, bool guarded);
+
+// Writes all needs to inventoryconsumption in one multi-row INSERT, dated
+// `timeStamp` ("YYYY-MM-DD HH:MM:SS"; empty = NOW())
+void logMaterialUsage(sql::Connection* con, const std::vector<MaterialNeed>& needs, const std::string& timeStamp = "");
+
+// ItemType for display ("Item #<id>" if unknown); cached with the BOM
+std::string materialName(sql::Connection* con, int inventoryID);
+
+// Coalesces the usage of many jobs into per-item totals and writes them as one
+// UPDATE ... CASE plus one multi-row INSERT (bulk paths: journal replay batches).
+// Usage is only summed within one timestamp, so replayed jobs keep the day,
+// partition and monthly aggregate they were made in.
+// Not thread-safe; the caller owns the transaction around flush().
+class ConsumptionBatch {
+public:
+    // Empty timeStamp means NOW() at flush
+    void add(const std::vector<MaterialNeed>& needs, const std::string& timeStamp = "");
+    bool empty() const { return totals_.empty(); }
+    size_t jobCount() const { return jobs_; }
+
+    // Unguarded write of the totals; clears the batch once the statements have run
+    void flush(sql::Connection* con);
+
+private:
+    std::map<std::pair<std::string, int>, long long> totals_;  // by (timeStamp, InventoryID)
+    size_t jobs_ = 0;
+};
@@ -0,0 +1,288 @@
+#include "ChangeFeed.h"
+#include "ConnectionPool.h" // openPooledConnection()
+#include "db.h"             // getConfigInt(), getConfigValue()
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cppconn/statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+namespace {
+    const int FEED_BATCH_EVENTS = 500;  // events per SHOW BINLOG EVENTS
+    const int FEED_RETRY_S = 5;         // between reconnects while the log is unreadable
+
+    struct Subscription {
+        string table;
+        function<void(const TableChange&)> handler;
+    };
+
+    mutex g_subscribersMutex;
+    vector<Subscription> g_subscribers;
+
+    mutex g_feedMutex;
+    condition_variable g_stopWanted;
+    bool g_running = false;
+    thread g_tailer;
+    atomic<long long> g_deliveredUpToMs(0);  // steady-clock ms of the last poll fully delivered; 0 = none
+
+    long long steadyMs() {
+        return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int pollIntervalMs() {
+        return getConfigInt("CDC_POLL_MS", 250);
+    }
+
+    // What one poll found: each table and kind once, or everything
+    struct ChangeBatch {
+        set<pair<string, TableChangeKind>> tables;
+        bool everything = false;
+    };
+
+    void deliver(const ChangeBatch& batch) {
+        if (!batch.everything && batch.tables.empty()) return;
+        lock_guard<mutex> lock(g_subscribersMutex);
+        for (const Subscription& s : g_subscribers) {
+            if (batch.everything) {
+                s.handler({ s.table, TableChangeKind::Other });
+                continue;
+            }
+            for (const auto& change : batch.tables) {
+                if (change.first == s.table) s.handler({ s.table, change.second });
+            }
+        }
+    }
+
+    // ==========================================
+    // READING THE LOG
+    // ==========================================
+
+    struct LogPosition {
+        string file;
+        uint64_t offset = 0;
+    };
+
+    struct Tailer {
+        unique_ptr<Connection> con;
+        LogPosition position;
+        string schema;
+        unordered_map<uint64_t, string> tableOfId;  // from Table_map events; "" = another schema
+    };
+
+    bool currentPosition(Connection* con, LogPosition& position) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res;
+        try {
+            res.reset(stmt->executeQuery("SHOW BINARY LOG STATUS"));  // 8.2 and later
+        }
+        catch (SQLException&) {
+            res.reset(stmt->executeQuery("SHOW MASTER STATUS"));
+        }
+        if (!res->next()) return false;  // binary logging is off
+        position.file = res->getString("File");
+        position.offset = res->getUInt64("Position");
+        return true;
+    }
+
+    // The number right after `tag` in `info`; 0 if the tag is missing
+    uint64_t numberAfter(const string& info, const string& tag) {
+        size_t at = info.find(tag);
+        if (at == string::npos) return 0;
+        uint64_t value = 0;
+        for (size_t i = at + tag.size(); i < info.size() && isdigit(static_cast<unsigned char>(info[i])); i++) {
+            value = value * 10 + static_cast<uint64_t>(info[i] - '0');
+        }
+        return value;
+    }
+
+    // "table_id: 92 (shop.payment)" or "table_id: 92 flags: STMT_END_F"
+    uint64_t tableIdOf(const string& info) {
+        return numberAfter(info, "table_id: ");
+    }
+
+    void readTableMap(Tailer& t, const string& info) {
+        size_t open = info.find('(');
+        size_t close = info.rfind(')');
+        size_t dot = info.find('.', open);
+        if (open == string::npos || close == string::npos || dot == string::npos || dot > close) return;
+        string schema = info.substr(open + 1, dot - open - 1);
+        t.tableOfId[tableIdOf(info)] = schema == t.schema ? info.substr(dot + 1, close - dot - 1) : "";
+    }
+
+    bool startsWith(const string& text, const char* prefix) {
+        return text.compare(0, char_traits<char>::length(prefix), prefix) == 0;
+    }
+
+    // Reads up to one batch from the current position; true if there may be more
+    bool readEvents(Tailer& t, ChangeBatch& batch) {
+        if (t.position.file.find('\'') != string::npos) throw SQLException("Unexpected binary log name");
+        unique_ptr<Statement> stmt(t.con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(
+            "SHOW BINLOG EVENTS IN '" + t.position.file + "' FROM " + to_string(t.position.offset)
+            + " LIMIT " + to_string(FEED_BATCH_EVENTS)));
+
+        int events = 0;
+        while (res->next()) {
+            events++;
+            const string type = res->getString("Event_type");
+            const string info = res->getString("Info");
+
+            if (type == "Rotate") {
+                // "binlog.000002;pos=4": the rest of the log continues in the next file
+                t.position.file = info.substr(0, info.find(';'));
+                t.position.offset = max<uint64_t>(numberAfter(info, "pos="), 4);
+                t.tableOfId.clear();
+                return true;
+            }
+            t.position.offset = res->getUInt64("End_log_pos");
+
+            if (type == "Table_map") {
+                readTableMap(t, info);
+                continue;
+            }
+            TableChangeKind kind;
+            if (startsWith(type, "Write_rows")) kind = TableChangeKind::Insert;
+            else if (startsWith(type, "Update_rows")) kind = TableChangeKind::Update;
+            else if (startsWith(type, "Delete_rows")) kind = TableChangeKind::Delete;
+            else if (type == "Query") {
+                // DDL, or DML under statement format; the tables it touched aren't named reliably
+                if (info != "BEGIN" && info != "COMMIT" && info.find(t.schema) != string::npos) batch.everything = true;
+                continue;
+            }
+            else if (type == "Stop") {
+                throw SQLException("Server stopped; resuming from its next log");
+            }
+            else continue;
+
+            auto table = t.tableOfId.find(tableIdOf(info));
+            if (table != t.tableOfId.end() && !table->second.empty()) batch.tables.emplace(table->second, kind);
+        }
+        return events == FEED_BATCH_EVENTS;
+    }
+
+    // New session at the current position; every cache reloads once because
+    // nothing between its last read and this position was seen
+    void resync(Tailer& t, ChangeBatch& batch) {
+        t.con.reset(openPooledConnection());
+        if (!t.con) throw SQLException("Database unavailable");
+        if (!currentPosition(t.con.get(), t.position)) throw SQLException("Binary logging is off");
+        t.tableOfId.clear();
+        batch.everything = true;
+    }
+
+    void tailerLoop(Tailer t) {
+        const int intervalMs = max(pollIntervalMs(), 10);
+        ChangeBatch ready;           // read on the previous pass, delivered on this one
+        long long readyReadMs = 0;
+        bool down = false;
+        long long retryAtMs = 0;
+
+        unique_lock<mutex> lock(g_feedMutex);
+        while (g_running) {
+            lock.unlock();
+            deliver(ready);
+            if (readyReadMs != 0) g_deliveredUpToMs = readyReadMs;
+            ready = ChangeBatch();
+            readyReadMs = 0;
+
+            const long long now = steadyMs();
+            if (!down || now >= retryAtMs) {
+                try {
+                    if (!t.con) resync(t, ready);
+                    while (readEvents(t, ready)) {}
+                    readyReadMs = now;
+                    if (down) cerr << "[ChangeFeed] Following the binary log again." << endl;
+                    down = false;
+                }
+                catch (SQLException& e) {
+                    if (!down) cerr << "[ChangeFeed] Caches fall back to version probes: " << e.what() << endl;
+                    down = true;
+                    retryAtMs = now + FEED_RETRY_S * 1000LL;
+                    t.con.reset();
+                    ready = ChangeBatch();
+                }
+            }
+
+            lock.lock();
+            g_stopWanted.wait_for(lock, chrono::milliseconds(intervalMs), []() { return !g_running; });
+        }
+    }
+}
+
+// ==========================================
+// PUBLIC API
+// ==========================================
+
+void subscribeToChanges(const std::string& table, std::function<void(const TableChange&)> handler) {
+    lock_guard<mutex> lock(g_subscribersMutex);
+    g_subscribers.push_back({ table, move(handler) });
+}
+
+bool startChangeFeed() {
+    if (pollIntervalMs() <= 0) return false;
+    {
+        lock_guard<mutex> lock(g_feedMutex);
+        if (g_running) return true;
+    }
+
+    Tailer t;
+    t.schema = getConfigValue("DB_NAME");
+    t.con.reset(openPooledConnection());
+    if (!t.con) return false;
+    try {
+        unique_ptr<Statement> stmt(t.con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery("SELECT @@log_bin AS LogBin, @@binlog_format AS Format"));
+        if (!res->next() || res->getInt("LogBin") == 0) {
+            cerr << "[ChangeFeed] Binary logging is off; caches probe their version stamps." << endl;
+            return false;
+        }
+        if (res->getString("Format") != "ROW") {
+            cerr << "[ChangeFeed] binlog_format is " << res->getString("Format")
+                << "; every logged statement will reload every cache." << endl;
+        }
+        if (!currentPosition(t.con.get(), t.position)) return false;
+    }
+    catch (SQLException& e) {
+        cerr << "[ChangeFeed] Binary log unreadable (REPLICATION CLIENT/SLAVE needed?): " << e.what() << endl;
+        return false;
+    }
+
+    // Anything already cached was read before this position
+    ChangeBatch everything;
+    everything.everything = true;
+    deliver(everything);
+
+    lock_guard<mutex> lock(g_feedMutex);
+    g_running = true;
+    g_tailer = thread(tailerLoop, move(t));
+    return true;
+}
+
+void stopChangeFeed() {
+    {
+        lock_guard<mutex> lock(g_feedMutex);
+        if (!g_running) return;
+        g_running = false;
+    }
+    g_stopWanted.notify_all();
+    g_tailer.join();
+    g_deliveredUpToMs = 0;
+}
+
+bool changeFeedCurrent() {
+    long long delivered = g_deliveredUpToMs.load();
+    return delivered != 0 && steadyMs() - delivered <= max(4LL * pollIntervalMs(), 1000LL);
+}
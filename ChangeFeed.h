@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+// ==========================================
+// CHANGE FEED (binary log tailer)
+// ==========================================
+// A background thread follows the server's binary log and tells in-process
+// caches when a table they hold changes. The change can come from another
+// terminal, a stored procedure or a hand edit. While the feed is current,
+// caches can trust what they hold instead of probing `table_versions` on
+// every use. Another writer's change reaches them within about two
+// CDC_POLL_MS.
+//
+// Connector/C++ has no replication-protocol client, so the feed reads the
+// log with SHOW BINLOG EVENTS from its last position. That gives the table
+// and kind of each row event but not the row images, so an event means
+// "this table changed" and the cache re-reads. Events are handed out one poll
+// after they are read. By then the writing transaction is visible to readers,
+// since the binlog is written just before the engine commit.
+//
+// Needs log_bin=ON and the REPLICATION CLIENT and REPLICATION SLAVE
+// privileges. Without them the feed stays off and caches probe their version
+// stamps as before. After an outage or a purged log, the feed restarts at the
+// current position and reports every table as changed.
+
+enum class TableChangeKind { Insert, Update, Delete, Other };  // Other: DDL, statement-format DML, resync
+
+struct TableChange {
+    std::string table;
+    TableChangeKind kind;
+};
+
+// Runs on the feed thread, so keep it short and non-blocking. A batch reports
+// each table and kind once. Subscriptions last for the life of the process.
+void subscribeToChanges(const std::string& table, std::function<void(const TableChange&)> handler);
+
+// Opens the feed's own session and starts tailing at the current log
+// position. Returns false (with the reason on cerr) if the log can't be read
+// or CDC_POLL_MS is 0.
+bool startChangeFeed();
+void stopChangeFeed();
+
+// True while every change committed more than one poll ago has been delivered
+bool changeFeedCurrent();
@@ -0,0 +1,222 @@
+#include "ColdArchive.h"
+#include "db.h"                  // getConfigInt()
+#include "ConsumptionForecast.h" // refreshConsumptionRollup()
+#include "PaymentAnalytics.h"   // bumpPaymentHistoryVersion()
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// SCHEMA
+// ==========================================
+
+namespace {
+    // Archived in this order: payments first, so a job is only moved once no
+    // live payment points at it
+    const char* const ARCHIVED_TABLES[3] = { "payment", "printjob", "inventoryconsumption" };
+
+    bool tableExists(Connection* con, const string& table) {
+        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+            "SELECT 1 FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?"
+        ));
+        pstmt->setString(1, table);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        return res->next();
+    }
+
+    // Generated columns (printjob.JobCost) are recomputed by the archive table, not copied
+    string insertableColumns(Connection* con, const string& table) {
+        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+            "SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND EXTRA NOT LIKE '%GENERATED%' "
+            "ORDER BY ORDINAL_POSITION"
+        ));
+        pstmt->setString(1, table);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        string columns;
+        while (res->next()) columns += (columns.empty() ? "`" : ", `") + res->getString(1) + "`";
+        return columns;
+    }
+
+    string monthDate(int ym) {
+        ostringstream oss;
+        oss << (ym / 12) << "-" << setw(2) << setfill('0') << (ym % 12 + 1) << "-01";
+        return oss.str();
+    }
+}
+
+void ensureArchiveTable(sql::Connection* con, const std::string& table) {
+    const string archive = table + "_archive";
+    if (tableExists(con, archive)) return;
+
+    unique_ptr<Statement> stmt(con->createStatement());
+    stmt->execute("CREATE TABLE `" + archive + "` LIKE `" + table + "`");
+
+    unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+        "SELECT 1 FROM information_schema.PARTITIONS "
+        "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND PARTITION_NAME IS NOT NULL LIMIT 1"
+    ));
+    pstmt->setString(1, archive);
+    unique_ptr<ResultSet> res(pstmt->executeQuery());
+    if (res->next()) stmt->execute("ALTER TABLE `" + archive + "` REMOVE PARTITIONING");
+
+    try {
+        stmt->execute("ALTER TABLE `" + archive + "` ROW_FORMAT=COMPRESSED KEY_BLOCK_SIZE=8");
+    }
+    catch (SQLException& e) {
+        // Needs innodb_file_per_table; the archive still works uncompressed
+        cerr << "[Archive] " << archive << " left uncompressed: " << e.what() << endl;
+    }
+}
+
+// ==========================================
+// MOVING ROWS
+// ==========================================
+
+long long archiveRows(sql::Connection* con, const std::string& table, const std::string& source, const std::string& where) {
+    ensureArchiveTable(con, table);
+    unique_ptr<Statement> stmt(con->createStatement());
+
+    // 1. Aggregates first, so reports never see the rows missing from both sides
+    if (table == "payment") {
+        stmt->executeUpdate(
+            "INSERT INTO payment_monthly_archive (Year, Month, CompleteCount, CompleteAmount) "
+            "SELECT YEAR(TimeStamp), MONTH(TimeStamp), COUNT(*), SUM(Amount) FROM `" + source + "` "
+            "WHERE (" + where + ") AND PaymentStatus = 'Complete' "
+            "GROUP BY YEAR(TimeStamp), MONTH(TimeStamp) "
+            "ON DUPLICATE KEY UPDATE CompleteCount = CompleteCount + VALUES(CompleteCount), "
+            "CompleteAmount = CompleteAmount + VALUES(CompleteAmount)"
+        );
+    }
+    else if (table == "inventoryconsumption") {
+        stmt->executeUpdate(
+            "INSERT INTO consumption_monthly_archive (InventoryID, Year, Month, QuantityUsed) "
+            "SELECT InventoryID, YEAR(TimeStamp), MONTH(TimeStamp), SUM(QuantityUsed) FROM `" + source + "` "
+            "WHERE (" + where + ") "
+            "GROUP BY InventoryID, YEAR(TimeStamp), MONTH(TimeStamp) "
+            "ON DUPLICATE KEY UPDATE QuantityUsed = consumption_monthly_archive.QuantityUsed + VALUES(QuantityUsed)"
+        );
+    }
+
+    // 2. Copy, then remove from the source. A key already in the archive fails
+    // the insert, and a count that differs fails the move: either way the
+    // caller rolls the month back rather than delete rows the archive lacks.
+    string columns = insertableColumns(con, table);
+    long long copied = stmt->executeUpdate("INSERT INTO `" + table + "_archive` (" + columns + ") "
+        "SELECT " + columns + " FROM `" + source + "` WHERE " + where);
+    long long moved = stmt->executeUpdate("DELETE FROM `" + source + "` WHERE " + where);
+    if (copied != moved) {
+        throw SQLException("Archive of " + source + " copied " + to_string(copied)
+            + " rows but would delete " + to_string(moved) + "; nothing moved");
+    }
+
+    // Rows now counted by the aggregates instead: analytics copies reload
+    if (table == "payment" && moved > 0) bumpPaymentHistoryVersion(con);
+    return moved;
+}
+
+long long archiveBefore(sql::Connection* con, int cutoffYear) {
+    refreshConsumptionRollup(con); // the daily rollup keeps its history after the log rows leave
+
+    const int cutoff = cutoffYear * 12;
+    long long moved = 0;
+
+    for (const char* table : ARCHIVED_TABLES) {
+        // Only months that have rows, found in one pass
+        vector<int> months;
+        {
+            unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+                string("SELECT DISTINCT YEAR(TimeStamp) * 12 + MONTH(TimeStamp) - 1 AS YM FROM `") + table + "` "
+                "WHERE TimeStamp < ? ORDER BY YM"
+            ));
+            pstmt->setString(1, monthDate(cutoff));
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            while (res->next()) months.push_back(res->getInt(1));
+        }
+
+        // One transaction per month keeps undo and lock footprints bounded
+        if (!months.empty()) ensureArchiveTable(con, table); // DDL, so before the transaction
+        for (int ym : months) {
+            string where = "TimeStamp >= '" + monthDate(ym) + "' AND TimeStamp < '" + monthDate(ym + 1) + "'";
+            if (string(table) == "printjob") {
+                where += " AND Status = 'Done' AND NOT EXISTS "
+                    "(SELECT 1 FROM payment p WHERE p.JobID = printjob.JobID)";
+            }
+            try {
+                con->setAutoCommit(false);
+                moved += archiveRows(con, table, table, where);
+                con->commit();
+                con->setAutoCommit(true);
+            }
+            catch (SQLException&) {
+                try {
+                    con->rollback();
+                    con->setAutoCommit(true);
+                }
+                catch (SQLException&) {}
+                throw;
+            }
+        }
+    }
+    return moved;
+}
+
+// ==========================================
+// MAINTENANCE COMMAND
+// ==========================================
+
+void runColdArchive(sql::Connection* con) {
+    const int years = getConfigInt("ARCHIVE_AFTER_YEARS", 2);
+    cout << "\n--- Archive Closed Years ---\n";
+    if (years <= 0) {
+        cout << "[Notice] ARCHIVE_AFTER_YEARS is 0; archiving is disabled.\n";
+        return;
+    }
+
+    try {
+        int cutoffYear;
+        {
+            unique_ptr<Statement> stmt(con->createStatement());
+            unique_ptr<ResultSet> res(stmt->executeQuery("SELECT YEAR(CURDATE())"));
+            res->next();
+            cutoffYear = res->getInt(1) - years;
+        }
+
+        cout << "Rows dated before " << cutoffYear << "-01-01:\n";
+        long long total = 0;
+        for (const char* table : ARCHIVED_TABLES) {
+            unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+                string("SELECT COUNT(*) FROM `") + table + "` WHERE TimeStamp < ?"
+            ));
+            pstmt->setString(1, to_string(cutoffYear) + "-01-01");
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            long long rows = res->next() ? res->getInt64(1) : 0;
+            total += rows;
+            cout << "  " << left << setw(22) << table << rows << "\n";
+        }
+        if (total == 0) {
+            cout << "Nothing to archive.\n";
+            return;
+        }
+
+        cout << "Move them to the compressed archive tables? (y/n): ";
+        string answer;
+        getline(cin, answer);
+        if (answer.empty() || tolower(answer[0]) != 'y') return;
+
+        long long moved = archiveBefore(con, cutoffYear);
+        cout << "[Success] Archived " << moved << " rows. Reports include them through the monthly aggregates.\n";
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Archive stopped: " << e.what() << endl;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <mysql_connection.h>
+
+// ==========================================
+// COLD-DATA ARCHIVE
+// ==========================================
+// Closed years of payment, printjob and inventoryconsumption rows move to
+// <table>_archive tables (InnoDB ROW_FORMAT=COMPRESSED), so the live tables and
+// their indexes stay small enough to live in the buffer pool.
+//
+// Before any row leaves a live table its totals are folded into per-month
+// archive aggregates (schema migration 6), in the same transaction as the move:
+//   payment_monthly_archive     (Year, Month, CompleteCount, CompleteAmount)
+//   consumption_monthly_archive (InventoryID, Year, Month, QuantityUsed)
+// The financial reports add these to the live figures, so a report reads the
+// same before and after archiving. Listing screens show live rows only.
+//
+// Rows older than ARCHIVE_AFTER_YEARS full years before the current one are
+// archived (2 in 2026 archives everything before 2024-01-01).
+
+// Creates <table>_archive (compressed, unpartitioned) if missing
+void ensureArchiveTable(sql::Connection* con, const std::string& table);
+
+// Folds rows of `source` matching `where` into the aggregates for `table`, copies
+// them to <table>_archive and deletes them from `source`. `source` is the live
+// table or a staging table holding its rows. Throws sql::SQLException, leaving
+// the caller to roll back, if a row is already archived or the copied and
+// deleted counts differ. No transaction handling.
+long long archiveRows(sql::Connection* con, const std::string& table, const std::string& source, const std::string& where);
+
+// Moves everything before the first day of `cutoffYear` month by month;
+// returns rows archived. Throws sql::SQLException.
+long long archiveBefore(sql::Connection* con, int cutoffYear);
+
+// System Maintenance command: shows what would move and archives on confirmation
+void runColdArchive(sql::Connection* con);
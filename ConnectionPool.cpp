@@ -0,0 +1,127 @@
+#include "ConnectionPool.h"
+#include "db.h"                  // getConfigValue(), getConfigInt()
+#include "ResilientConnection.h" // releaseStatementCache()
+#include <cppconn/driver.h>
+#include <cppconn/exception.h>
+#include <cppconn/statement.h>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+sql::Connection* openPooledConnection(DbEndpoint endpoint) {
+    sql::Driver* driver = get_driver_instance();
+    sql::Connection* con = nullptr;
+    try {
+        if (endpoint == DbEndpoint::Replica) {
+            // Same schema and, unless given, the same account as the primary
+            con = driver->connect(getConfigValue("DB_REPLICA_HOST"),
+                getConfigValue("DB_REPLICA_USER", getConfigValue("DB_USER")),
+                getConfigValue("DB_REPLICA_PASS", getConfigValue("DB_PASS")));
+            con->setSchema(getConfigValue("DB_NAME"));
+            // A write routed here by mistake fails instead of diverging from the primary
+            std::unique_ptr<sql::Statement> stmt(con->createStatement());
+            stmt->execute("SET SESSION TRANSACTION READ ONLY");
+        }
+        else {
+            con = driver->connect(getConfigValue("DB_HOST"), getConfigValue("DB_USER"), getConfigValue("DB_PASS"));
+            con->setSchema(getConfigValue("DB_NAME"));
+        }
+    }
+    catch (sql::SQLException& e) {
+        cerr << (endpoint == DbEndpoint::Replica ? "[Replica]" : "[Pool]") << " Connection failed: " << e.what() << endl;
+        delete con;
+        return nullptr;
+    }
+    return con;
+}
+
+// ==========================================
+// LEASE
+// ==========================================
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (con_) pool_->release(con_);
+        pool_ = other.pool_;
+        con_ = other.con_;
+        other.con_ = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (con_) pool_->release(con_);
+}
+
+// ==========================================
+// POOL
+// ==========================================
+
+ConnectionPool::ConnectionPool(int maxSize, DbEndpoint endpoint)
+    : maxSize_(maxSize > 0 ? maxSize : getConfigInt("DB_POOL_SIZE", 4)), endpoint_(endpoint) {
+    if (maxSize_ < 1) maxSize_ = 1;
+}
+
+ConnectionPool::~ConnectionPool() {
+    lock_guard<mutex> lock(mutex_);
+    for (sql::Connection* con : idle_) {
+        releaseStatementCache(con);
+        delete con;
+    }
+    idle_.clear();
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    unique_lock<mutex> lock(mutex_);
+    available_.wait(lock, [&]() { return !idle_.empty() || open_ < maxSize_; });
+
+    if (!idle_.empty()) {
+        sql::Connection* con = idle_.back();
+        idle_.pop_back();
+        return Lease(this, con);
+    }
+
+    // Reserve the slot, then connect without holding the lock
+    open_++;
+    lock.unlock();
+    sql::Connection* con = openPooledConnection(endpoint_);
+    if (con == nullptr) {
+        lock.lock();
+        open_--;
+        available_.notify_one();
+        return Lease();
+    }
+    return Lease(this, con);
+}
+
+int ConnectionPool::openCount() {
+    lock_guard<mutex> lock(mutex_);
+    return open_;
+}
+
+void ConnectionPool::release(sql::Connection* con) {
+    // A lease may come back mid-transaction after an exception; never hand that on
+    bool usable = true;
+    try {
+        if (!con->getAutoCommit()) {
+            con->rollback();
+            con->setAutoCommit(true);
+        }
+        usable = !con->isClosed();
+    }
+    catch (sql::SQLException&) {
+        usable = false;
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    if (usable) {
+        idle_.push_back(con);
+    }
+    else {
+        releaseStatementCache(con);
+        delete con;
+        open_--;
+    }
+    available_.notify_one();
+}
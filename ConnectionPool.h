@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <mysql_connection.h>
+
+// ==========================================
+// CONNECTION POOL
+// ==========================================
+// A bounded set of MySQL sessions shared by many threads. Connections are opened
+// lazily up to the pool size and handed out as RAII leases; a lease returns its
+// connection (and the connection's warm statement cache) to the pool when it
+// goes out of scope. Size comes from DB_POOL_SIZE in config.ini.
+//
+// A pool opens sessions on the primary (DB_HOST) or on the read replica
+// (DB_REPLICA_HOST, see ReplicaRouting.h). Replica sessions are read-only.
+
+enum class DbEndpoint { Primary, Replica };
+
+class ConnectionPool {
+public:
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(ConnectionPool* pool, sql::Connection* con) : pool_(pool), con_(con) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), con_(other.con_) { other.con_ = nullptr; }
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        sql::Connection* get() const { return con_; }
+        explicit operator bool() const { return con_ != nullptr; }
+
+    private:
+        ConnectionPool* pool_ = nullptr;
+        sql::Connection* con_ = nullptr;
+    };
+
+    // maxSize <= 0 uses DB_POOL_SIZE (default 4)
+    explicit ConnectionPool(int maxSize = 0, DbEndpoint endpoint = DbEndpoint::Primary);
+    ~ConnectionPool();
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Blocks until a connection is free. Returns an empty lease if a new
+    // connection was needed and the server could not be reached.
+    Lease acquire();
+
+    int maxSize() const { return maxSize_; }
+    int openCount();
+
+private:
+    void release(sql::Connection* con);
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<sql::Connection*> idle_;
+    int open_ = 0;
+    int maxSize_;
+    DbEndpoint endpoint_;
+};
+
+// Opens one session from config.ini without console output (pool and tools use this)
+sql::Connection* openPooledConnection(DbEndpoint endpoint = DbEndpoint::Primary);
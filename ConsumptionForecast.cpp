@@ -0,0 +1,280 @@
+#include "ConsumptionForecast.h"
+#include "db.h"                  // getConfigInt()
+#include "ResilientConnection.h" // runWrite(), withReadRetry()
+#include "QueryPlanCheck.h"
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// ROLLUP & WATERMARK
+// ==========================================
+
+namespace {
+    const char* const ROLLUP_NAME = "consumption_daily";
+
+    const char* const SQL_DEPLETION_FORECAST =
+        "SELECT i.InventoryID, i.ItemType, i.Quantity, "
+        "IFNULL(SUM(d.QuantityUsed), 0) AS UsedInWindow, "
+        "DATEDIFF(CURDATE(), f.FirstDay) + 1 AS SpanDays "
+        "FROM inventory i "
+        "LEFT JOIN (SELECT InventoryID, MIN(Day) AS FirstDay FROM consumption_daily GROUP BY InventoryID) f "
+        "  ON f.InventoryID = i.InventoryID "
+        "LEFT JOIN consumption_daily d ON d.InventoryID = i.InventoryID AND d.Day > CURDATE() - INTERVAL ? DAY "
+        "GROUP BY i.InventoryID, i.ItemType, i.Quantity, f.FirstDay "
+        "ORDER BY i.InventoryID";
+    const PlanRegistration planDepletionForecast("depletion_forecast", "ConsumptionForecast.cpp", SQL_DEPLETION_FORECAST, { "14" });
+
+    mutex g_logKeyMutex;
+    bool g_logKeyKnown = false;
+    string g_logKey; // auto-increment column of inventoryconsumption ("" = none)
+
+    // Finds the log's key column once per process (the tables come from schema migration 4)
+    void discoverLogKey(Connection* con) {
+        lock_guard<mutex> lock(g_logKeyMutex);
+        if (g_logKeyKnown) return;
+
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(
+            "SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'inventoryconsumption' "
+            "AND EXTRA LIKE '%auto_increment%'"
+        ));
+        g_logKey = res->next() ? res->getString(1) : "";
+        g_logKeyKnown = true;
+    }
+
+    // Folds log rows in (lo, hi] into the daily buckets
+    void foldRange(Connection* con, long long lo, long long hi) {
+        unique_ptr<PreparedStatement> fold(con->prepareStatement(
+            "INSERT INTO consumption_daily (InventoryID, Day, QuantityUsed) "
+            "SELECT InventoryID, DATE(TimeStamp), SUM(QuantityUsed) FROM inventoryconsumption "
+            "WHERE `" + g_logKey + "` > ? AND `" + g_logKey + "` <= ? "
+            "GROUP BY InventoryID, DATE(TimeStamp) "
+            "ON DUPLICATE KEY UPDATE QuantityUsed = consumption_daily.QuantityUsed + VALUES(QuantityUsed)"
+        ));
+        fold->setInt64(1, lo);
+        fold->setInt64(2, hi);
+        fold->executeUpdate();
+    }
+
+    long long maxLogID(Connection* con) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery("SELECT IFNULL(MAX(`" + g_logKey + "`), 0) FROM inventoryconsumption"));
+        return res->next() ? res->getInt64(1) : 0;
+    }
+
+    // Starts the next settling period at the log's current end
+    void startSettling(Connection* con, long long lastID) {
+        unique_ptr<PreparedStatement> mark(con->prepareStatement(
+            "INSERT INTO rollup_watermark (Name, LastID, SettlingID, SettlingSince) VALUES (?, ?, ?, NOW()) "
+            "ON DUPLICATE KEY UPDATE LastID = VALUES(LastID), SettlingID = VALUES(SettlingID), SettlingSince = NOW()"
+        ));
+        mark->setString(1, ROLLUP_NAME);
+        mark->setInt64(2, lastID);
+        mark->setInt64(3, max(maxLogID(con), lastID));
+        mark->executeUpdate();
+    }
+
+    void rollbackQuietly(Connection* con) {
+        try {
+            con->rollback();
+            con->setAutoCommit(true);
+        }
+        catch (SQLException&) {}
+    }
+}
+
+void rebuildConsumptionRollup(sql::Connection* con) {
+    discoverLogKey(con);
+    try {
+        runWrite(con, [&]() {
+            con->setAutoCommit(false);
+            // Watermark first, in the same lock order as a refresh
+            long long settled = -1;
+            if (!g_logKey.empty()) {
+                unique_ptr<PreparedStatement> read(con->prepareStatement(
+                    "SELECT LastID FROM rollup_watermark WHERE Name = ? FOR UPDATE"
+                ));
+                read->setString(1, ROLLUP_NAME);
+                unique_ptr<ResultSet> res(read->executeQuery());
+                if (res->next()) settled = res->getInt64(1);
+            }
+
+            unique_ptr<Statement> stmt(con->createStatement());
+            // Days before the oldest live log row were archived (ColdArchive.h); their
+            // buckets cannot be recomputed, so they are kept as they are
+            stmt->execute(
+                "DELETE FROM consumption_daily WHERE Day >= "
+                "(SELECT IFNULL(MIN(DATE(TimeStamp)), '9999-12-31') FROM inventoryconsumption)"
+            );
+
+            if (g_logKey.empty()) {
+                stmt->execute(
+                    "INSERT INTO consumption_daily (InventoryID, Day, QuantityUsed) "
+                    "SELECT InventoryID, DATE(TimeStamp), SUM(QuantityUsed) FROM inventoryconsumption "
+                    "GROUP BY InventoryID, DATE(TimeStamp)"
+                );
+            }
+            else if (settled >= 0) {
+                // Only the settled part of the log goes in; refreshes fold the rest
+                foldRange(con, 0, settled);
+            }
+            else {
+                startSettling(con, 0);
+            }
+            con->commit();
+            con->setAutoCommit(true);
+            });
+    }
+    catch (SQLException&) {
+        rollbackQuietly(con);
+        throw;
+    }
+}
+
+int refreshConsumptionRollup(sql::Connection* con) {
+    discoverLogKey(con);
+
+    // Without an auto-increment key there is no safe watermark; fall back to a rebuild
+    if (g_logKey.empty()) {
+        rebuildConsumptionRollup(con);
+        return 0;
+    }
+
+    bool seeded = false;
+    long long folded = 0;
+    try {
+        runWrite(con, [&]() {
+            seeded = false;
+            folded = 0;
+            con->setAutoCommit(false);
+            // The row lock serialises concurrent refreshes so no range is folded twice
+            unique_ptr<PreparedStatement> read(con->prepareStatement(
+                "SELECT LastID, SettlingID, "
+                "SettlingSince IS NULL OR SettlingSince <= NOW() - INTERVAL ? SECOND AS Settled "
+                "FROM rollup_watermark WHERE Name = ? FOR UPDATE"
+            ));
+            read->setInt(1, getConfigInt("ROLLUP_SETTLE_S", 30));
+            read->setString(2, ROLLUP_NAME);
+            unique_ptr<ResultSet> res(read->executeQuery());
+            if (res->next()) {
+                seeded = true;
+                if (res->getBoolean("Settled")) {
+                    // IDs are handed out before commit, so a writer may still hold one
+                    // below the log's end; every writer that held one when SettlingID
+                    // was read has finished by now
+                    long long lo = res->getInt64("LastID");
+                    long long hi = res->getInt64("SettlingID");
+                    if (hi > lo) {
+                        foldRange(con, lo, hi);
+                        folded = hi - lo;
+                    }
+                    startSettling(con, max(lo, hi));
+                }
+            }
+            con->commit();
+            con->setAutoCommit(true);
+            });
+    }
+    catch (SQLException&) {
+        rollbackQuietly(con);
+        throw;
+    }
+
+    if (!seeded) { // first run: seed from the whole log
+        rebuildConsumptionRollup(con);
+        return 0;
+    }
+    return static_cast<int>(folded);
+}
+
+// ==========================================
+// FORECAST
+// ==========================================
+
+vector<ItemForecast> computeDepletionForecast(sql::Connection* con, int windowDays) {
+    return withReadRetry(con, [&]() {
+        vector<ItemForecast> items;
+        PreparedStatement* pstmt = cachedStatement(con, SQL_DEPLETION_FORECAST);
+        pstmt->setInt(1, windowDays);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+
+        while (res->next()) {
+            ItemForecast item;
+            item.inventoryID = res->getInt("InventoryID");
+            item.itemType = res->getString("ItemType");
+            item.quantityLeft = res->getInt64("Quantity");
+
+            // Young items are averaged over the days since their first-ever use, at most the window
+            long long used = res->getInt64("UsedInWindow");
+            if (!res->isNull("SpanDays") && used > 0) {
+                int span = res->getInt("SpanDays");
+                if (span > windowDays) span = windowDays;
+                item.dailyRate = static_cast<double>(used) / (span > 0 ? span : 1);
+                item.daysLeft = item.quantityLeft > 0 ? item.quantityLeft / item.dailyRate : 0.0;
+            }
+            items.push_back(item);
+        }
+        return items;
+        });
+}
+
+void displayDepletionForecast(sql::Connection* con) {
+    const int windowDays = getConfigInt("FORECAST_WINDOW_DAYS", 14);
+    const int leadDays = getConfigInt("FORECAST_LEAD_TIME_DAYS", 7);
+
+    try {
+        int folded = refreshConsumptionRollup(con);
+        vector<ItemForecast> items = computeDepletionForecast(con, windowDays);
+
+        cout << "\n--- Inventory Depletion Forecast (last " << windowDays << " days, lead time "
+            << leadDays << " days) ---\n";
+        cout << "(" << folded << " new log rows folded into the daily rollup)\n";
+        cout << string(86, '-') << endl;
+        cout << "| " << left << setw(4) << "ID" << " | " << setw(16) << "Item Type" << " | " << setw(10) << "Left"
+            << " | " << setw(10) << "Use/day" << " | " << setw(10) << "Days left" << " | " << setw(10) << "Reorder at"
+            << " | " << setw(7) << "Status" << " |" << endl;
+        cout << string(86, '-') << endl;
+
+        for (const ItemForecast& item : items) {
+            bool alert = item.daysLeft >= 0 && item.daysLeft < leadDays;
+            cout << "| " << left << setw(4) << item.inventoryID << " | " << setw(16) << item.itemType.substr(0, 16)
+                << " | " << setw(10) << item.quantityLeft << " | " << setw(10) << fixed << setprecision(1) << item.dailyRate
+                << " | " << setw(10) << (item.daysLeft < 0 ? string("-") : to_string(static_cast<long long>(item.daysLeft)))
+                << " | " << setw(10) << static_cast<long long>(item.dailyRate * leadDays + 0.5)
+                << " | " << setw(7) << (alert ? "REORDER" : "OK") << " |" << endl;
+        }
+        cout << string(86, '-') << endl;
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] SQL Error (Forecast): " << e.what() << endl;
+    }
+}
+
+void reportStockAlerts(sql::Connection* con) {
+    const int windowDays = getConfigInt("FORECAST_WINDOW_DAYS", 14);
+    const int leadDays = getConfigInt("FORECAST_LEAD_TIME_DAYS", 7);
+
+    try {
+        refreshConsumptionRollup(con);
+        for (const ItemForecast& item : computeDepletionForecast(con, windowDays)) {
+            if (item.daysLeft < 0 || item.daysLeft >= leadDays) continue;
+            cout << "[Stock Alert] " << item.itemType << ": ~" << fixed << setprecision(1) << item.daysLeft
+                << " days left at " << item.dailyRate << "/day (lead time " << leadDays << " days). Reorder now.\n";
+        }
+    }
+    catch (SQLException& e) {
+        // The job itself is already saved; a forecast hiccup must not look like a failure
+        cerr << "[Forecast] Skipped: " << e.what() << endl;
+    }
+}
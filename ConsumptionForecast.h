@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+
+// ==========================================
+// INVENTORY DEPLETION FORECAST
+// ==========================================
+// `consumption_daily` holds one row per (InventoryID, Day) with the units used
+// that day. It is maintained incrementally: each refresh folds only the
+// inventoryconsumption rows above a stored watermark (the log's auto-increment
+// key), so refreshing after every print job costs a short PK range scan.
+// A writer takes its ID before it commits, so the watermark trails the log:
+// a range is folded once ROLLUP_SETTLE_S have passed since its end was read,
+// and the rollup runs that much to twice that behind the log.
+//
+// The forecast divides stock left by the average daily use over the last
+// FORECAST_WINDOW_DAYS and alerts when that falls below FORECAST_LEAD_TIME_DAYS.
+
+struct ItemForecast {
+    int inventoryID = 0;
+    std::string itemType;
+    long long quantityLeft = 0;
+    double dailyRate = 0.0;   // units/day over the window (0 = no recent use)
+    double daysLeft = -1.0;   // -1 when there is no recent use
+};
+
+// Folds settled log rows into consumption_daily; returns how many log IDs were
+// folded. Seeds the rollup with a full rebuild on first use.
+// Throws sql::SQLException.
+int refreshConsumptionRollup(sql::Connection* con);
+
+// Recomputes consumption_daily from the settled part of the live log (repair /
+// first run); days whose rows were archived keep their buckets
+void rebuildConsumptionRollup(sql::Connection* con);
+
+std::vector<ItemForecast> computeDepletionForecast(sql::Connection* con, int windowDays);
+
+// Menu report: rate, days to stock-out and reorder point per item
+void displayDepletionForecast(sql::Connection* con);
+
+// Quiet refresh + alert lines for items under the lead time (called after createPrintJob)
+void reportStockAlerts(sql::Connection* con);
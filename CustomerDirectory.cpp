@@ -0,0 +1,83 @@
+#include "CustomerDirectory.h"
+#include "ResilientConnection.h"
+#include "ChangeFeed.h"
+#include "QueryPlanCheck.h"
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+namespace {
+    const char* const SQL_DIRECTORY_VERSION = "SELECT Version FROM table_versions WHERE Name = 'customer_directory'";
+    const char* const SQL_CUSTOMER_LIST = "SELECT UserID, FullName, Email FROM user WHERE Role = 'Customer' ORDER BY UserID ASC";
+    const PlanRegistration planDirectoryVersion("directory_version", "CustomerDirectory.cpp", SQL_DIRECTORY_VERSION, {});
+    const PlanRegistration planCustomerList("customer_list", "CustomerDirectory.cpp", SQL_CUSTOMER_LIST, {});
+
+    mutex g_directoryMutex;
+    shared_ptr<const vector<CustomerEntry>> g_customers;
+    long long g_version = -1;   // stamp g_customers was read at; -1 = reload
+    atomic<bool> g_changed(false);  // set by the change feed
+    once_flag g_subscribed;
+
+    long long probeVersion(Connection* con) {
+        PreparedStatement* pstmt = cachedStatement(con, SQL_DIRECTORY_VERSION);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        return res->next() ? res->getInt64("Version") : 0;
+    }
+
+    shared_ptr<const vector<CustomerEntry>> loadCustomers(Connection* con) {
+        PreparedStatement* pstmt = cachedStatement(con, SQL_CUSTOMER_LIST);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        shared_ptr<vector<CustomerEntry>> customers = make_shared<vector<CustomerEntry>>();
+        while (res->next()) {
+            customers->push_back({ res->getInt("UserID"), res->getString("FullName"), res->getString("Email") });
+        }
+        return customers;
+    }
+}
+
+std::shared_ptr<const std::vector<CustomerEntry>> customerDirectory(sql::Connection* con) {
+    call_once(g_subscribed, []() {
+        subscribeToChanges("user", [](const TableChange&) { g_changed = true; });
+        });
+    lock_guard<mutex> lock(g_directoryMutex);
+    if (g_changed.exchange(false)) g_version = -1;
+    if (g_customers && g_version != -1 && changeFeedCurrent()) return g_customers;
+    try {
+        withReadRetry(con, [&]() {
+            // Stamp first: a bump landing mid-load just triggers one more reload
+            long long version = probeVersion(con);
+            if (g_customers && version == g_version) return 0;
+            g_customers = loadCustomers(con);
+            g_version = version;
+            return 0;
+            });
+    }
+    catch (SQLException&) {
+        if (!g_customers) throw;
+    }
+    return g_customers;
+}
+
+void bumpCustomerDirectoryVersion(sql::Connection* con) {
+    {
+        // Our own change: drop the snapshot even if the bump below fails
+        lock_guard<mutex> lock(g_directoryMutex);
+        g_version = -1;
+    }
+    try {
+        runWrite(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con,
+                "UPDATE table_versions SET Version = Version + 1 WHERE Name = 'customer_directory'");
+            return pstmt->executeUpdate();
+            });
+    }
+    catch (SQLException& e) {
+        cerr << "[Directory] Other terminals may show a stale customer list: " << e.what() << endl;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+
+// ==========================================
+// CUSTOMER DIRECTORY (versioned snapshot)
+// ==========================================
+// The customer list is held in memory with the version stamp it was read at.
+// Each use probes `table_versions` by primary key (one tiny row) and reloads
+// the list only when the stamp has moved, so the Print Job menu re-renders
+// from memory instead of counting and scanning `user` on every pass.
+//
+// Every write to `user` from this program calls bumpCustomerDirectoryVersion(),
+// so changes made from another terminal are seen on its next probe. While the
+// change feed (ChangeFeed.h) is current the probe is skipped, and any change
+// to `user`, hand edits included, drops the snapshot.
+// Schema migration 9 creates the table.
+
+struct CustomerEntry {
+    int userID;
+    std::string fullName;
+    std::string email;
+};
+
+// Customers ordered by UserID. While the server is unreachable the last
+// snapshot is returned; with no snapshot yet, throws sql::SQLException.
+std::shared_ptr<const std::vector<CustomerEntry>> customerDirectory(sql::Connection* con);
+
+// Marks the directory changed for every client; call after a committed write to `user`
+void bumpCustomerDirectoryVersion(sql::Connection* con);
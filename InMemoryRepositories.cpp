@@ -0,0 +1,126 @@
+#include "Repositories.h"
+#include <cmath>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+// ==========================================
+// IN-MEMORY BACKEND
+// ==========================================
+
+namespace {
+    // "YYYY-MM-..." -> months since year 0 (the key of the monthly index)
+    int monthKey(const string& timeStamp) {
+        return stoi(timeStamp.substr(0, 4)) * 12 + stoi(timeStamp.substr(5, 2)) - 1;
+    }
+
+    struct JobRow {
+        int userID;
+        int pageCount;
+        double costPerPage;
+        Money jobCost;
+        string timeStamp;
+    };
+
+    // Rows in hash maps keyed the way the rules look them up; the monthly
+    // totals are maintained on insert, as the archive aggregates are in MySQL
+    class InMemoryRepositories : public Repositories {
+    public:
+        explicit InMemoryRepositories(const string& clock) : clock_(clock) {}
+
+        const char* backendName() const override { return "in-memory"; }
+
+        int addUser(const string&, const string&, const string& role) override {
+            int userID = nextUserID_++;
+            roles_[userID] = role;
+            return userID;
+        }
+
+        bool exists(int userID) override {
+            return roles_.count(userID) > 0;
+        }
+
+        bool isCustomer(int userID) override {
+            auto found = roles_.find(userID);
+            return found != roles_.end() && found->second == "Customer";
+        }
+
+        int addJob(int userID, int pageCount, double costPerPage, const string& timeStamp, int) override {
+            int jobID = nextJobID_++;
+            // JobCost is a DECIMAL(12,2) column computed by the server; cents, rounded the same way
+            Money cost = Money::fromCents(llround(pageCount * costPerPage * 100.0));
+            jobs_[jobID] = { userID, pageCount, costPerPage, cost, timeStamp.empty() ? clock_ : timeStamp };
+            return jobID;
+        }
+
+        bool jobCost(int jobID, int userID, Money& cost) override {
+            auto found = jobs_.find(jobID);
+            if (found == jobs_.end() || found->second.userID != userID) return false;
+            cost = found->second.jobCost;
+            return true;
+        }
+
+        bool isPaid(int jobID) override {
+            return paidJobs_.count(jobID) > 0;
+        }
+
+        int addPayment(const PaymentRecord& payment) override {
+            PaymentRecord row = payment;
+            if (row.timeStamp.empty()) row.timeStamp = clock_;
+            payments_.push_back(row);
+            paidJobs_.insert(row.jobID);
+            if (row.status == "Complete") {
+                MonthTotals& month = completeByMonth_[monthKey(row.timeStamp)];
+                month.count++;
+                month.amount += row.amount;
+            }
+            return static_cast<int>(payments_.size());
+        }
+
+        void restock(int inventoryID, long long units) override {
+            stock_[inventoryID] += units;
+        }
+
+        long long quantity(int inventoryID) override {
+            auto found = stock_.find(inventoryID);
+            return found != stock_.end() ? found->second : 0;
+        }
+
+        bool take(const vector<MaterialNeed>& needs, int& shortItem) override {
+            for (const MaterialNeed& need : needs) {
+                if (need.units > 0 && quantity(need.inventoryID) < need.units) {
+                    shortItem = need.inventoryID;
+                    return false;
+                }
+            }
+            for (const MaterialNeed& need : needs) {
+                if (need.units == 0) continue;
+                stock_[need.inventoryID] -= need.units;
+                usage_.push_back(need);
+            }
+            return true;
+        }
+
+        MonthTotals completedPayments(int year, int month) override {
+            auto found = completeByMonth_.find(year * 12 + month - 1);
+            return found != completeByMonth_.end() ? found->second : MonthTotals();
+        }
+
+    private:
+        string clock_;
+        int nextUserID_ = 1;
+        int nextJobID_ = 1;
+        unordered_map<int, string> roles_;
+        unordered_map<int, JobRow> jobs_;
+        vector<PaymentRecord> payments_;            // TransactionID = position + 1
+        unordered_set<int> paidJobs_;
+        unordered_map<int, MonthTotals> completeByMonth_;
+        unordered_map<int, long long> stock_;
+        vector<MaterialNeed> usage_;                // the inventoryconsumption log
+    };
+}
+
+std::unique_ptr<Repositories> makeInMemoryRepositories(const std::string& clock) {
+    return std::unique_ptr<Repositories>(new InMemoryRepositories(clock));
+}
@@ -1,27 +1,60 @@
 #include "InventoryManagement.h"
 #include "utils.h" // Assumes readInt, clearScreen, etc.
+#include "OfflineJournal.h"
+#include "ResilientConnection.h"
+#include "ConsumptionForecast.h"
+#include "ReplicaRouting.h"
+#include "QueryPlanCheck.h"
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <memory>
+#include <vector>
 
 using namespace std;
 using namespace sql;
 
+namespace {
+    const char* const SQL_STOCK_LEVEL = "SELECT Quantity FROM inventory WHERE InventoryID = ?";
+    // Initial = current Quantity + sum of consumption logs; Left = current Quantity
+    const char* const SQL_INVENTORY_STATUS =
+        "SELECT i.InventoryID, i.ItemType, i.Quantity AS QuantityLeft, "
+        "IFNULL(SUM(ic.QuantityUsed), 0) AS TotalConsumed, "
+        "(i.Quantity + IFNULL(SUM(ic.QuantityUsed), 0)) AS InitialEstimate, "
+        "i.UnitCost, i.TimeStamp "
+        "FROM inventory i "
+        "LEFT JOIN inventoryconsumption ic ON i.InventoryID = ic.InventoryID "
+        "GROUP BY i.InventoryID ORDER BY i.InventoryID ASC";
+    const char* const SQL_ITEM_USAGE =
+        "SELECT i.ItemType, i.Quantity AS QuantityLeft, i.UnitCost, i.TimeStamp, "
+        "IFNULL(SUM(ic.QuantityUsed), 0) AS TotalConsumed "
+        "FROM inventory i "
+        "LEFT JOIN inventoryconsumption ic ON i.InventoryID = ic.InventoryID "
+        "WHERE i.InventoryID = ? GROUP BY i.InventoryID";
+
+    const PlanRegistration planStockLevel("stock_level", "InventoryManagement.cpp", SQL_STOCK_LEVEL, { "1" });
+    const PlanRegistration planInventoryStatus("inventory_status", "InventoryManagement.cpp", SQL_INVENTORY_STATUS, {});
+    const PlanRegistration planItemUsage("item_usage", "InventoryManagement.cpp", SQL_ITEM_USAGE, { "1" });
+}
+
 // ==========================================
 // HELPER FUNCTIONS
 // ==========================================
 
 bool checkInventoryIDExists(sql::Connection* con, int inventoryID) {
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT 1 FROM inventory WHERE InventoryID = ? LIMIT 1")
-        );
-        pstmt->setInt(1, inventoryID);
-        unique_ptr<ResultSet> res(pstmt->executeQuery());
-        return res->next();
+        return withReadRetry(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con, "SELECT 1 FROM inventory WHERE InventoryID = ? LIMIT 1");
+            pstmt->setInt(1, inventoryID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        });
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline(); // Accept for now, replay re-validates
+            return true;
+        }
         cerr << "DB Error (Inventory Check): " << e.what() << endl;
         return false;
     }
@@ -79,19 +112,23 @@ bool checkInventoryIDExists(sql::Connection* con, int inventoryID) {
 }*/
 //test new read function
 void readAllInventory(sql::Connection* con) {
+    struct StatusRow {
+        int inventoryID;
+        string itemType;
+        int initial, consumed, left;
+    };
     try {
-        unique_ptr<Statement> stmt(con->createStatement());
-        // SQL Logic: Initial = Current Quantity + Sum of Consumption Logs
-        // Left = Current Quantity in 'inventory' table
-        unique_ptr<ResultSet> res(stmt->executeQuery(
-            "SELECT i.InventoryID, i.ItemType, i.Quantity AS QuantityLeft, "
-            "IFNULL(SUM(ic.QuantityUsed), 0) AS TotalConsumed, "
-            "(i.Quantity + IFNULL(SUM(ic.QuantityUsed), 0)) AS InitialEstimate, "
-            "i.UnitCost, i.TimeStamp "
-            "FROM inventory i "
-            "LEFT JOIN inventoryconsumption ic ON i.InventoryID = ic.InventoryID "
-            "GROUP BY i.InventoryID ORDER BY i.InventoryID ASC"
-        ));
+        // Scans every consumption row, so it runs on the read replica when one is healthy
+        vector<StatusRow> rows = readOnReplica(con, [](sql::Connection* db) {
+            unique_ptr<Statement> stmt(db->createStatement());
+            unique_ptr<ResultSet> res(stmt->executeQuery(SQL_INVENTORY_STATUS));
+            vector<StatusRow> found;
+            while (res->next()) {
+                found.push_back({ res->getInt("InventoryID"), res->getString("ItemType"),
+                    res->getInt("InitialEstimate"), res->getInt("TotalConsumed"), res->getInt("QuantityLeft") });
+            }
+            return found;
+            });
 
         const int ID_W = 6, TYPE_W = 20, QTY_W = 12, CONS_W = 12, INIT_W = 12;
         const int TOTAL_WIDTH = 85;
@@ -105,12 +142,12 @@ void readAllInventory(sql::Connection* con) {
             << " | " << setw(QTY_W - 2) << "Left" << " |" << endl;
         cout << string(TOTAL_WIDTH, '-') << endl;
 
-        while (res->next()) {
-            cout << "| " << left << setw(ID_W - 2) << res->getInt("InventoryID")
-                << " | " << setw(TYPE_W - 2) << res->getString("ItemType")
-                << " | " << setw(INIT_W - 2) << res->getInt("InitialEstimate")
-                << " | " << setw(CONS_W - 2) << res->getInt("TotalConsumed")
-                << " | " << setw(QTY_W - 2) << res->getInt("QuantityLeft") << " |" << endl;
+        for (const StatusRow& row : rows) {
+            cout << "| " << left << setw(ID_W - 2) << row.inventoryID
+                << " | " << setw(TYPE_W - 2) << row.itemType
+                << " | " << setw(INIT_W - 2) << row.initial
+                << " | " << setw(CONS_W - 2) << row.consumed
+                << " | " << setw(QTY_W - 2) << row.left << " |" << endl;
         }
         cout << string(TOTAL_WIDTH, '-') << endl;
     }
@@ -157,11 +194,15 @@ void addInventory(sql::Connection* con) {
         pstmt->setString(1, itemType);
         pstmt->setInt(2, quantity);
         pstmt->setDouble(3, unitCost);
-        pstmt->executeUpdate();
+        runWrite(con, [&]() { return pstmt->executeUpdate(); });
 
         cout << "[Success] New Inventory Recorded.\n"; // Node AX2
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            cerr << "[Error] Connection lost - item NOT recorded. Please retry." << endl;
+            return;
+        }
         cerr << "[Error] SQL Error: " << e.what() << endl;
     }
 }
@@ -199,11 +240,15 @@ void recordInventoryTopUp(sql::Connection* con) {
         );
         pstmt->setInt(1, topUpQuantity);
         pstmt->setInt(2, inventoryID);
-        pstmt->executeUpdate();
+        runWrite(con, [&]() { return pstmt->executeUpdate(); });
 
         cout << "[Success] Item Restocked Successfully.\n"; // Node TX3
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            cerr << "[Error] Connection lost - top up NOT saved. Please retry." << endl;
+            return;
+        }
         cerr << "[Error] SQL Error: " << e.what() << endl;
     }
 }
@@ -213,6 +258,7 @@ void recordInventoryTopUp(sql::Connection* con) {
 // ==========================================
 void recordInventoryConsumption(sql::Connection* con) {
     cout << "\n--- Record Inventory Consumption ---\n";
+    syncJournalIfPending(con);
     readAllInventory(con);
     int inventoryID = readInt("Enter Inventory ID consumed: ");
     int quantityUsed;
@@ -235,17 +281,24 @@ void recordInventoryConsumption(sql::Connection* con) {
     // Fetch current Quantity
     int currentQuantity = 0;
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT Quantity FROM inventory WHERE InventoryID = ?")
-        );
-        pstmt->setInt(1, inventoryID);
-        unique_ptr<ResultSet> res(pstmt->executeQuery());
-        if (res->next()) {
-            currentQuantity = res->getInt("Quantity");
-        }
+        currentQuantity = withReadRetry(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con, SQL_STOCK_LEVEL);
+            pstmt->setInt(1, inventoryID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next() ? res->getInt("Quantity") : 0;
+            });
     }
     catch (SQLException& e) {
-        cerr << "DB Error fetching quantity: " << e.what() << endl;
+        if (!isConnectionLost(e)) {
+            cerr << "DB Error fetching quantity: " << e.what() << endl;
+            return;
+        }
+        markDatabaseOffline();
+    }
+
+    if (!isDatabaseOnline()) {
+        string key = journalConsumption(inventoryID, quantityUsed);
+        cout << "[Offline] Consumption saved to the local journal (" << key << ").\n";
         return;
     }
 
@@ -255,30 +308,47 @@ void recordInventoryConsumption(sql::Connection* con) {
         return;
     }
 
-    // Node C5: Update inventory
+    // Node C5: Update inventory (stock and log commit together)
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement(
-                "UPDATE inventory SET Quantity = Quantity - ? WHERE InventoryID = ?"
-            )
-        );
-        pstmt->setInt(1, quantityUsed);
-        pstmt->setInt(2, inventoryID);
-        pstmt->executeUpdate();
-
-        // Node C6: Record consumption (optional logging table)
-        unique_ptr<PreparedStatement> logPstmt(
-            con->prepareStatement(
-                "INSERT INTO inventoryconsumption (InventoryID, QuantityUsed) VALUES (?, ?)"
-            )
-        );
-        logPstmt->setInt(1, inventoryID);
-        logPstmt->setInt(2, quantityUsed);
-        logPstmt->executeUpdate();
+        runWrite(con, [&]() {
+            con->setAutoCommit(false);
+            unique_ptr<PreparedStatement> pstmt(
+                con->prepareStatement(
+                    "UPDATE inventory SET Quantity = Quantity - ? WHERE InventoryID = ?"
+                )
+            );
+            pstmt->setInt(1, quantityUsed);
+            pstmt->setInt(2, inventoryID);
+            pstmt->executeUpdate();
+
+            // Node C6: Record consumption (optional logging table)
+            unique_ptr<PreparedStatement> logPstmt(
+                con->prepareStatement(
+                    "INSERT INTO inventoryconsumption (InventoryID, QuantityUsed) VALUES (?, ?)"
+                )
+            );
+            logPstmt->setInt(1, inventoryID);
+            logPstmt->setInt(2, quantityUsed);
+            logPstmt->executeUpdate();
+            con->commit();
+            con->setAutoCommit(true);
+            });
 
         cout << "[Success] Consumption Recorded.\n"; // Node CX4
+        reportStockAlerts(con);
     }
     catch (SQLException& e) {
+        try {
+            con->rollback();
+            con->setAutoCommit(true);
+        }
+        catch (SQLException&) {}
+
+        if (isConnectionLost(e)) {
+            string key = journalConsumption(inventoryID, quantityUsed);
+            cout << "[Offline] Consumption saved to the local journal (" << key << ").\n";
+            return;
+        }
         cerr << "[Error] SQL Error during update/logging: " << e.what() << endl;
     }
 }
@@ -327,13 +397,7 @@ void searchInventory(sql::Connection* con) {
 
     try {
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement(
-                "SELECT i.ItemType, i.Quantity AS QuantityLeft, i.UnitCost, i.TimeStamp, "
-                "IFNULL(SUM(ic.QuantityUsed), 0) AS TotalConsumed "
-                "FROM inventory i "
-                "LEFT JOIN inventoryconsumption ic ON i.InventoryID = ic.InventoryID "
-                "WHERE i.InventoryID = ? GROUP BY i.InventoryID"
-            )
+            con->prepareStatement(SQL_ITEM_USAGE)
         );
         pstmt->setInt(1, inventoryID);
         unique_ptr<ResultSet> res(pstmt->executeQuery());
@@ -376,11 +440,12 @@ void runInventoryModule(sql::Connection* con) {
         cout << "2. Record Inventory Top Up\n";
         cout << "3. Record Inventory Consumption\n";
         cout << "4. Search Inventory Info\n";
-        cout << "5. Exit\n";
+        cout << "5. Depletion Forecast\n";
+        cout << "6. Exit\n";
         cout << "=====================================\n";
 
         // Node B: Get choice
-        choice = readInt("Enter your choice (1-5): ");
+        choice = readInt("Enter your choice (1-6): ");
 
         // Node C, D1, D2, D3, D4, D5 logic
         switch (choice) {
@@ -388,9 +453,10 @@ void runInventoryModule(sql::Connection* con) {
         case 2: recordInventoryTopUp(con); break;
         case 3: recordInventoryConsumption(con); break;
         case 4: searchInventory(con); break;
-        case 5: cout << "Exiting Inventory Module...\n"; break; // Node EXIT
+        case 5: displayDepletionForecast(con); break;
+        case 6: cout << "Exiting Inventory Module...\n"; break; // Node EXIT
         default: cout << "[Error] Invalid option\n"; break; // Node X0
         }
 
-    } while (choice != 5); // Node END
+    } while (choice != 6); // Node END
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "InventoryReservations.h"
+#include "db.h"                  // getConfigInt()
+#include "ResilientConnection.h" // runWrite()
+#include <iostream>
+#include <memory>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+InventoryReservations::InventoryReservations(ConnectionPool* pool)
+    : pool_(pool), ready_(false), refreshWanted_(false) {
+}
+
+InventoryReservations::~InventoryReservations() {
+    stop();
+}
+
+void InventoryReservations::resetSlots(const vector<BomLine>& bom, const vector<long long>& stock) {
+    slots_.reset(new Slot[bom.size()]);
+    slotCount_ = bom.size();
+    for (size_t i = 0; i < slotCount_; i++) {
+        slots_[i].line = bom[i];
+        slots_[i].available = i < stock.size() ? stock[i] : 0;
+        slots_[i].pendingDelta = 0;
+        slots_[i].lastKnownDb = slots_[i].available;
+        slots_[i].shortReported = false;
+    }
+}
+
+bool InventoryReservations::load() {
+    if (pool_ == nullptr) return false;
+    ConnectionPool::Lease lease = pool_->acquire();
+    if (!lease) return false;
+    Connection* con = lease.get();
+
+    try {
+        BomRange range = bomForJobType(con);
+        vector<BomLine> bom(range.begin(), range.end());
+        vector<long long> stock;
+        for (const BomLine& line : bom) {
+            stock.push_back(withReadRetry(con, [&]() {
+                PreparedStatement* pstmt = cachedStatement(con, "SELECT Quantity FROM inventory WHERE InventoryID = ?");
+                pstmt->setInt(1, line.inventoryID);
+                unique_ptr<ResultSet> res(pstmt->executeQuery());
+                return res->next() ? res->getInt64(1) : 0LL;
+                }));
+        }
+        resetSlots(bom, stock);
+    }
+    catch (SQLException& e) {
+        cerr << "[Reservations] Could not read stock: " << e.what() << endl;
+        return false;
+    }
+    ready_ = true;
+    return true;
+}
+
+void InventoryReservations::seed(const std::vector<BomLine>& bom, const std::vector<long long>& stock) {
+    resetSlots(bom, stock);
+    ready_ = true;
+}
+
+// ==========================================
+// RESERVATION (CAS)
+// ==========================================
+
+bool InventoryReservations::tryTake(atomic<long long>& counter, long long amount) {
+    long long current = counter.load(memory_order_relaxed);
+    do {
+        if (current < amount) return false;
+    } while (!counter.compare_exchange_weak(current, current - amount,
+        memory_order_acq_rel, memory_order_relaxed));
+    return true;
+}
+
+bool InventoryReservations::reserve(int pageCount) {
+    for (size_t i = 0; i < slotCount_; i++) {
+        if (tryTake(slots_[i].available, unitsForPages(slots_[i].line, pageCount))) continue;
+        // Give back what was already taken: all or nothing
+        while (i-- > 0) slots_[i].available.fetch_add(unitsForPages(slots_[i].line, pageCount));
+        return false;
+    }
+    return true;
+}
+
+void InventoryReservations::release(int pageCount) {
+    for (size_t i = 0; i < slotCount_; i++) slots_[i].available.fetch_add(unitsForPages(slots_[i].line, pageCount));
+}
+
+void InventoryReservations::commit(int pageCount) {
+    for (size_t i = 0; i < slotCount_; i++) slots_[i].pendingDelta.fetch_add(unitsForPages(slots_[i].line, pageCount));
+}
+
+void InventoryReservations::returnStock(int pageCount) {
+    release(pageCount);
+    for (size_t i = 0; i < slotCount_; i++) slots_[i].pendingDelta.fetch_sub(unitsForPages(slots_[i].line, pageCount));
+}
+
+long long InventoryReservations::available(int inventoryID) const {
+    for (size_t i = 0; i < slotCount_; i++) {
+        if (slots_[i].line.inventoryID == inventoryID) return slots_[i].available.load();
+    }
+    return 0;
+}
+
+// ==========================================
+// BATCHED WRITE-BACK
+// ==========================================
+
+bool InventoryReservations::flush() {
+    if (pool_ == nullptr) return true;
+
+    vector<MaterialNeed> delta;
+    bool anyDelta = false;
+    for (size_t i = 0; i < slotCount_; i++) {
+        delta.push_back({ slots_[i].line.inventoryID, slots_[i].pendingDelta.exchange(0) });
+        if (delta.back().units != 0) anyDelta = true;
+    }
+
+    // Idle passes only touch the database when a stock refresh is due
+    const auto now = chrono::steady_clock::now();
+    bool refreshDue = refreshWanted_.exchange(false)
+        || now - lastRefresh_ >= chrono::seconds(getConfigInt("RESERVATION_REFRESH_SECONDS", 5));
+    if (!anyDelta && !refreshDue) return true;
+
+    ConnectionPool::Lease lease = pool_->acquire();
+    try {
+        if (!lease) throw SQLException("Database unavailable");
+        Connection* con = lease.get();
+        vector<long long> dbQuantity(slotCount_, 0);
+        vector<MaterialNeed> applied;
+
+        runWrite(con, [&]() {
+            applied = delta;
+            con->setAutoCommit(false);
+            // Guarded per item: a console terminal may have taken the same stock since the
+            // counters were last refreshed. What the table cannot cover stays pending.
+            for (size_t i = 0; i < slotCount_; i++) {
+                if (applied[i].units == 0) continue;
+                unique_ptr<PreparedStatement> take(con->prepareStatement(
+                    "UPDATE inventory SET Quantity = Quantity - ? WHERE InventoryID = ? AND (? < 0 OR Quantity >= ?)"
+                ));
+                take->setInt64(1, applied[i].units);
+                take->setInt(2, applied[i].inventoryID);
+                take->setInt64(3, applied[i].units);
+                take->setInt64(4, applied[i].units);
+                if (take->executeUpdate() == 0) applied[i].units = 0;
+            }
+            // One aggregated usage row per item per batch (negative = returned stock)
+            logMaterialUsage(con, applied);
+
+            for (size_t i = 0; i < slotCount_; i++) {
+                unique_ptr<PreparedStatement> read(
+                    con->prepareStatement("SELECT Quantity FROM inventory WHERE InventoryID = ?")
+                );
+                read->setInt(1, slots_[i].line.inventoryID);
+                unique_ptr<ResultSet> res(read->executeQuery());
+                dbQuantity[i] = res->next() ? res->getInt64(1) : 0;
+            }
+            con->commit();
+            con->setAutoCommit(true);
+            });
+
+        // Anything the table moved by beyond our own write came from elsewhere (top-ups,
+        // console terminals). A shortfall drives the counter to zero or below, so no
+        // further job is reserved until stock arrives and the held usage is written.
+        for (size_t i = 0; i < slotCount_; i++) {
+            long long external = dbQuantity[i] - (slots_[i].lastKnownDb - applied[i].units);
+            if (external != 0) slots_[i].available.fetch_add(external);
+            slots_[i].lastKnownDb = dbQuantity[i];
+
+            long long held = delta[i].units - applied[i].units;
+            if (held != 0) slots_[i].pendingDelta.fetch_add(held);
+            if (held != 0 && !slots_[i].shortReported) {
+                cerr << "[Reservations] InventoryID " << delta[i].inventoryID << " is short by "
+                    << held - dbQuantity[i] << " units (taken by another terminal); usage held until restocked." << endl;
+            }
+            slots_[i].shortReported = held != 0;
+        }
+        lastRefresh_ = now;
+        return true;
+    }
+    catch (SQLException& e) {
+        if (lease) {
+            try {
+                lease.get()->rollback();
+                lease.get()->setAutoCommit(true);
+            }
+            catch (SQLException&) {}
+        }
+        for (size_t i = 0; i < slotCount_; i++) slots_[i].pendingDelta.fetch_add(delta[i].units);
+        cerr << "[Reservations] Stock flush deferred: " << e.what() << endl;
+        return false;
+    }
+}
+
+void InventoryReservations::start() {
+    lock_guard<mutex> lock(flushMutex_);
+    if (running_ || pool_ == nullptr) return;
+    running_ = true;
+    flusher_ = thread(&InventoryReservations::flusherLoop, this);
+}
+
+void InventoryReservations::stop() {
+    {
+        lock_guard<mutex> lock(flushMutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    stopWanted_.notify_all();
+    flusher_.join();
+    flush();
+}
+
+void InventoryReservations::flusherLoop() {
+    const int intervalMs = getConfigInt("RESERVATION_FLUSH_MS", 200);
+    unique_lock<mutex> lock(flushMutex_);
+    while (running_) {
+        stopWanted_.wait_for(lock, chrono::milliseconds(intervalMs), [&]() { return !running_; });
+        if (!running_) break;
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "ConnectionPool.h"
+#include "BillOfMaterials.h"
+
+// ==========================================
+// INVENTORY RESERVATIONS (lock-free)
+// ==========================================
+// Job creation in server mode reserves every item on the Standard bill of
+// materials from in-memory counters (one per InventoryID) with a
+// compare-and-swap loop, so concurrent terminals can never take the same sheets.
+// After the job row commits, the usage is added to a pending delta that a
+// flusher thread writes to `inventory` (and `inventoryconsumption`) in one
+// transaction per batch (RESERVATION_FLUSH_MS). Each flush also re-reads the
+// stock, so top-ups made elsewhere flow back into the counters. Console
+// terminals take stock from the table directly. If one has taken what the
+// counters had promised, the flush does not drive Quantity negative: it holds
+// that item's usage, reports the shortfall and blocks new reservations until
+// a top-up covers it.
+//
+// Lifecycle per job: reserve() -> job transaction -> commit(), or release() if
+// the transaction failed. A job cancelled after commit() uses returnStock().
+
+class InventoryReservations {
+public:
+    // pool == nullptr keeps everything in memory (used by the stress test)
+    explicit InventoryReservations(ConnectionPool* pool);
+    ~InventoryReservations();
+    InventoryReservations(const InventoryReservations&) = delete;
+    InventoryReservations& operator=(const InventoryReservations&) = delete;
+
+    // Seeds the counters from job_bom and the inventory table; false if they could not be read
+    bool load();
+    // In-memory setup: one counter per BOM line, stock[i] for bom[i]
+    void seed(const std::vector<BomLine>& bom, const std::vector<long long>& stock);
+    bool isReady() const { return ready_; }
+
+    // All-or-nothing reservation of everything a job of pageCount needs
+    bool reserve(int pageCount);
+    void release(int pageCount);
+    void commit(int pageCount);
+    void returnStock(int pageCount);
+
+    long long available(int inventoryID) const;
+
+    // Re-reads the stock on the next flusher pass (the change feed saw `inventory` change)
+    void requestRefresh() { refreshWanted_ = true; }
+
+    void start();
+    void stop();
+    // Writes the pending deltas (flusher thread, or after stop()); false if the
+    // database refused them, in which case they are kept for the next pass
+    bool flush();
+
+private:
+    // Counters are fixed once loaded; atomics cannot move, so they live in one array
+    struct Slot {
+        BomLine line;
+        std::atomic<long long> available;
+        std::atomic<long long> pendingDelta; // units to subtract from the table on the next flush
+        long long lastKnownDb;               // table value after the previous flush (flusher only)
+        bool shortReported;                  // a held shortfall was already reported (flusher only)
+    };
+
+    static bool tryTake(std::atomic<long long>& counter, long long amount);
+    void resetSlots(const std::vector<BomLine>& bom, const std::vector<long long>& stock);
+    void flusherLoop();
+
+    ConnectionPool* pool_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t slotCount_ = 0;
+    std::chrono::steady_clock::time_point lastRefresh_;
+    std::atomic<bool> ready_;
+    std::atomic<bool> refreshWanted_;
+
+    std::mutex flushMutex_;
+    std::condition_variable stopWanted_;
+    bool running_ = false;
+    std::thread flusher_;
+};
+
@@ -0,0 +1,153 @@
+#include "ListPager.h"
+#include "db.h"
+#include <iostream>
+#include <algorithm>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// PAGER
+// ==========================================
+
+ListPager::ListPager(sql::Connection* con, const std::string& sql, int pageSize, RowFormatter format,
+    StreamSource source)
+    : stream_(new ResultStream(con, sql, source)),
+    format_(std::move(format)),
+    pageSize_(max(1, pageSize)),
+    window_(max(1, getConfigInt("PAGER_WINDOW_PAGES", 5))) {
+    worker_ = thread(&ListPager::fetchLoop, this);
+}
+
+ListPager::~ListPager() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+        if (fetching_) stream_->interrupt(); // a next() waiting on the server returns
+    }
+    wanted_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void ListPager::fetchLoop() {
+    unique_lock<mutex> lock(mutex_);
+    while (true) {
+        wanted_.wait(lock, [&]() { return stop_ || nextPage_ <= wantedUpTo_; });
+        if (stop_) return;
+        fetching_ = true;
+        lock.unlock();
+
+        // Decoding happens outside the lock, so the viewer can page back meanwhile
+        vector<string> lines;
+        string failure;
+        bool ended = false;
+        try {
+            while (static_cast<int>(lines.size()) < pageSize_) {
+                if (!stream_->next()) {
+                    ended = true;
+                    break;
+                }
+                lines.push_back(format_(stream_->row()));
+            }
+        }
+        catch (SQLException& e) {
+            failure = e.what();
+            ended = true;
+        }
+
+        lock.lock();
+        fetching_ = false;
+        if (stop_) return;
+        if (!lines.empty()) pages_[nextPage_++] = std::move(lines);
+        if (!failure.empty()) error_ = failure;
+        finished_ = ended;
+        // Pages that fell out of the window behind the viewer
+        while (!pages_.empty() && pages_.begin()->first < wantedUpTo_ - window_) pages_.erase(pages_.begin());
+        decoded_.notify_all();
+        if (finished_) return;
+    }
+}
+
+bool ListPager::page(int index, std::vector<std::string>& lines) {
+    unique_lock<mutex> lock(mutex_);
+    // Asking for a page also asks for the one after it
+    if (index + 1 > wantedUpTo_) {
+        wantedUpTo_ = index + 1;
+        wanted_.notify_one();
+    }
+    decoded_.wait(lock, [&]() { return index < nextPage_ || finished_; });
+    auto found = pages_.find(index);
+    if (found == pages_.end()) return false;
+    lines = found->second;
+    return true;
+}
+
+bool ListPager::isLastPage(int index) {
+    lock_guard<mutex> lock(mutex_);
+    return finished_ && nextPage_ == index + 1;
+}
+
+int ListPager::firstPage() {
+    lock_guard<mutex> lock(mutex_);
+    return pages_.empty() ? nextPage_ : pages_.begin()->first;
+}
+
+std::string ListPager::error() {
+    lock_guard<mutex> lock(mutex_);
+    return error_;
+}
+
+// ==========================================
+// INTERACTIVE BROWSING
+// ==========================================
+
+void browsePages(ListPager& pager, long long totalRows, int pageSize,
+    const std::function<void()>& printHeader, const std::string& footer) {
+    vector<string> lines;
+    int current = 0;
+    if (!pager.page(0, lines)) {
+        printHeader();
+        cout << footer << endl;
+        if (!pager.error().empty()) cerr << "Error: " << pager.error() << endl;
+        return;
+    }
+
+    while (true) {
+        printHeader();
+        for (const string& line : lines) cout << line << "\n";
+        cout << footer << endl;
+
+        long long shown = static_cast<long long>(current) * pageSize + lines.size();
+        bool last = pager.isLastPage(current) || (totalRows >= 0 && shown >= totalRows);
+        if (last && current == 0) break;
+
+        cout << ">>> [" << shown << "/" << totalRows << "] "
+            << (last ? "End of list. 'b' back, [Enter] to finish: " : "[Enter] next, 'b' back, 'c' clear, 's' stop: ");
+        string input;
+        getline(cin, input); // no 'ws', so Enter alone answers
+        char key = input.empty() ? '\0' : static_cast<char>(tolower(input[0]));
+
+        if (key == 's') break;
+        if (key == 'b') {
+            if (current > 0 && current - 1 >= pager.firstPage() && pager.page(current - 1, lines)) {
+                current--;
+            }
+            else {
+                cout << "[Notice] " << (current == 0 ? "Already on the first page." : "Earlier pages are no longer held.") << "\n";
+            }
+            continue;
+        }
+        if (last) break;
+        if (key == 'c') {
+#ifdef _WIN32
+            system("cls");
+#else
+            system("clear");
+#endif
+        }
+        if (!pager.page(current + 1, lines)) break;
+        current++;
+    }
+    if (!pager.error().empty()) cerr << "Error: " << pager.error() << endl;
+}
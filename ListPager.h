@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <mysql_connection.h>
+#include <cppconn/resultset.h>
+#include "ResultStreaming.h"
+
+// ==========================================
+// PREFETCHING LIST PAGER
+// ==========================================
+// Paged listings used to fetch the next page only after the operator pressed
+// Enter. ListPager streams the listing query (ResultStreaming.h, on a session of
+// its own) and decodes it on a background thread. It stays one page ahead of
+// the page on screen, so moving forward normally finds the page already
+// formatted. The last PAGER_WINDOW_PAGES pages are kept, so moving back within
+// that window is instant too. Older pages are dropped: the stream is
+// forward-only, so memory stays bounded on any table size.
+//
+// The formatter runs on the worker thread and may only read the row it is given.
+// While a pager is open, the caller's connection must not be used (it sends
+// the KILL that stops an abandoned stream).
+
+class ListPager {
+public:
+    using RowFormatter = std::function<std::string(sql::ResultSet&)>;
+
+    // Runs `sql` (no parameters) and starts decoding the first page.
+    // Throws sql::SQLException if the query fails.
+    ListPager(sql::Connection* con, const std::string& sql, int pageSize, RowFormatter format,
+        StreamSource source = StreamSource::Primary);
+    ~ListPager();
+    ListPager(const ListPager&) = delete;
+    ListPager& operator=(const ListPager&) = delete;
+
+    // Lines of page `index` (0-based), waiting only if the worker has not got
+    // there yet. False past the end, for a page dropped from the window, or
+    // after a read error (see error()).
+    bool page(int index, std::vector<std::string>& lines);
+
+    // True once `index` is known to be the final page
+    bool isLastPage(int index);
+
+    // First page still held in the window
+    int firstPage();
+
+    std::string error();
+
+private:
+    void fetchLoop();
+
+    std::unique_ptr<ResultStream> stream_;
+    RowFormatter format_;
+    int pageSize_;
+    int window_;
+
+    std::mutex mutex_;
+    std::condition_variable wanted_;   // worker waits for a page to be asked for
+    std::condition_variable decoded_;  // viewer waits for a page to arrive
+    std::map<int, std::vector<std::string>> pages_;
+    int nextPage_ = 0;     // index the worker decodes next
+    int wantedUpTo_ = 1;   // worker keeps decoding while nextPage_ <= this
+    bool fetching_ = false;
+    bool finished_ = false;
+    bool stop_ = false;
+    std::string error_;
+    std::thread worker_;
+};
+
+// Shows a listing a page at a time. Enter moves forward, 'b' goes back, 'c'
+// clears the screen and 's' stops. `printHeader` runs above each page and
+// `footer` is printed below it.
+void browsePages(ListPager& pager, long long totalRows, int pageSize,
+    const std::function<void()>& printHeader, const std::string& footer);
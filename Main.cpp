@@ -1,11 +1,42 @@
 #include "db.h"
 #include "menus.h"
 #include "utils.h"
+#include "OfflineJournal.h"
+#include "ResilientConnection.h"
+#include "SchemaMigrations.h"
+#include "QueryPlanCheck.h"
+#include "ServerMode.h"
+#include "PaymentAnalytics.h"
+#include "ChangeFeed.h"
+#include <cstring>
 
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Multi-terminal mode: one server process, thin clients at each counter
+    if (argc > 1 && std::strcmp(argv[1], "--server") == 0)
+        return runServer();
+    if (argc > 1 && std::strcmp(argv[1], "--client") == 0)
+        return runClient();
+    // CI / pre-release guard: compares statement plans with the recorded baseline
+    if (argc > 1 && std::strcmp(argv[1], "--plan-check") == 0)
+        return runPlanCheckCommand(argc, argv);
+
     sql::Connection* con = connectDB();
 
+    // Login needs the server once; after that, writes survive link drops via the journal
+    while (con == nullptr) {
+        int retry = readInt("\n1. Retry connection\n2. Exit\n");
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (retry == 2)
+            return 1;
+        con = connectDB();
+    }
+    if (!prepareSchema(con))
+        std::cerr << "[Schema] Continuing on the existing schema; some features may fail." << std::endl;
+    syncJournalIfPending(con);
+    startChangeFeed();
+    loadPaymentAnalytics(con);
+
     while (true) {
         MainMenu(con);
         int choice = readInt("\n1. Login again\n2. Exit\n");
@@ -15,6 +46,8 @@ int main() {
             break;
     }
 
+    stopChangeFeed();
+    releaseStatementCache(con);
     delete con;
     return 0;
 }
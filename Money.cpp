@@ -0,0 +1,106 @@
+#include "Money.h"
+#include <iostream>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <cppconn/resultset.h>
+
+using namespace std;
+
+namespace {
+    // Largest magnitude accepted: 17 integer digits keeps cents well inside int64
+    const size_t MAX_INTEGER_DIGITS = 17;
+
+    // [-][$]digits[.digits]. With `round`, decimals past the second round half
+    // away from zero; without, any that are not zero are an error.
+    bool parseDecimal(const string& text, bool round, int64_t& cents) {
+        size_t i = 0;
+        while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+        bool negative = false;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) negative = text[i++] == '-';
+        if (i < text.size() && text[i] == '$') i++;
+
+        int64_t whole = 0;
+        size_t digits = 0;
+        for (; i < text.size() && isdigit(static_cast<unsigned char>(text[i])); i++, digits++) {
+            if (digits == MAX_INTEGER_DIGITS) return false;
+            whole = whole * 10 + (text[i] - '0');
+        }
+
+        int64_t fraction = 0;
+        size_t places = 0;
+        bool roundUp = false;
+        if (i < text.size() && text[i] == '.') {
+            for (i++; i < text.size() && isdigit(static_cast<unsigned char>(text[i])); i++, places++) {
+                if (places < 2) fraction = fraction * 10 + (text[i] - '0');
+                else if (!round && text[i] != '0') return false;
+                else if (round && places == 2) roundUp = text[i] >= '5';
+            }
+        }
+        if (digits == 0 && places == 0) return false;
+        while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) i++;
+        if (i != text.size()) return false;
+
+        if (places == 1) fraction *= 10;
+        cents = whole * 100 + fraction + (roundUp ? 1 : 0);
+        if (negative) cents = -cents;
+        return true;
+    }
+
+    template <typename Column>
+    Money readColumn(sql::ResultSet& res, const Column& column) {
+        if (res.isNull(column)) return Money();
+        int64_t cents = 0;
+        // A DOUBLE expression can arrive in exponent form; only then is the double used
+        if (!parseDecimal(res.getString(column), true, cents)) cents = llround(res.getDouble(column) * 100.0);
+        return Money::fromCents(cents);
+    }
+}
+
+bool Money::parse(const std::string& text, Money& amount) {
+    int64_t cents = 0;
+    if (!parseDecimal(text, false, cents)) return false;
+    amount = Money(cents);
+    return true;
+}
+
+std::string Money::toString() const {
+    // Magnitude as unsigned, so the most negative value still prints
+    uint64_t magnitude = cents_ < 0 ? 0 - static_cast<uint64_t>(cents_) : static_cast<uint64_t>(cents_);
+    string text = to_string(magnitude / 100) + "." + static_cast<char>('0' + magnitude % 100 / 10)
+        + static_cast<char>('0' + magnitude % 10);
+    return cents_ < 0 ? "-" + text : text;
+}
+
+std::ostream& operator<<(std::ostream& out, Money amount) {
+    return out << amount.toString();
+}
+
+Money getMoney(sql::ResultSet& res, const std::string& column) {
+    return readColumn(res, column);
+}
+
+Money getMoney(sql::ResultSet& res, int column) {
+    return readColumn(res, column);
+}
+
+Money readMoney(const char* prompt) {
+    string token;
+    Money amount;
+    while (true) {
+        cout << prompt;
+        if (cin >> token && Money::parse(token, amount)) return amount;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Invalid amount (e.g., 12.50).\n";
+    }
+}
+
+Money readPositiveMoney(const char* prompt) {
+    while (true) {
+        Money amount = readMoney(prompt);
+        if (amount > Money()) return amount;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Amount must be greater than zero.\n";
+    }
+}
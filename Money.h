@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace sql { class ResultSet; }
+
+// ==========================================
+// MONEY (exact currency amounts)
+// ==========================================
+// An amount is a whole number of cents in an int64. That makes sums and
+// differences exact and keeps totals equal to the DECIMAL(..., 2) columns to
+// the cent. Amounts are read from the connector's string form of a DECIMAL
+// (getMoney, never getDouble), are bound back as strings (toString), and
+// typed amounts are parsed from text (readMoney). So no amount ever passes
+// through binary floating point.
+// toDouble() is only for ratios such as margins and growth.
+
+class Money {
+public:
+    Money() {}
+
+    static Money fromCents(int64_t cents) { return Money(cents); }
+
+    // "12", "12.5", "-0.07", "$1234.50", "3.100000". False on anything else,
+    // including a fraction of a cent.
+    static bool parse(const std::string& text, Money& amount);
+
+    int64_t cents() const { return cents_; }
+    double toDouble() const { return cents_ / 100.0; }
+
+    // "1234.50", "-0.07": the form MySQL accepts for a DECIMAL parameter
+    std::string toString() const;
+
+    Money& operator+=(Money other) { cents_ += other.cents_; return *this; }
+    Money& operator-=(Money other) { cents_ -= other.cents_; return *this; }
+    friend Money operator+(Money a, Money b) { return a += b; }
+    friend Money operator-(Money a, Money b) { return a -= b; }
+    friend Money operator-(Money a) { return Money(-a.cents_); }
+
+    friend bool operator==(Money a, Money b) { return a.cents_ == b.cents_; }
+    friend bool operator!=(Money a, Money b) { return a.cents_ != b.cents_; }
+    friend bool operator<(Money a, Money b) { return a.cents_ < b.cents_; }
+    friend bool operator<=(Money a, Money b) { return a.cents_ <= b.cents_; }
+    friend bool operator>(Money a, Money b) { return a.cents_ > b.cents_; }
+    friend bool operator>=(Money a, Money b) { return a.cents_ >= b.cents_; }
+
+private:
+    explicit Money(int64_t cents) : cents_(cents) {}
+    int64_t cents_ = 0;
+};
+
+// Writes toString(); setw and left/right apply as to any string
+std::ostream& operator<<(std::ostream& out, Money amount);
+
+// A DECIMAL column (or SUM of one) as Money. NULL reads as zero, and extra
+// decimal places round half away from zero. Throws sql::SQLException.
+Money getMoney(sql::ResultSet& res, const std::string& column);
+Money getMoney(sql::ResultSet& res, int column);
+
+// Prompts until a valid amount is typed. Like readInt, it leaves the rest of
+// the line for the caller.
+Money readMoney(const char* prompt);
+
+// readMoney that also re-prompts for zero and negative amounts
+Money readPositiveMoney(const char* prompt);
@@ -0,0 +1,184 @@
+#include "Repositories.h"
+#include "ResilientConnection.h"
+#include "CustomerDirectory.h"
+#include "printjob.h"
+#include "QueryPlanCheck.h"
+#include <map>
+#include <iomanip>
+#include <sstream>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// MYSQL BACKEND
+// ==========================================
+
+namespace {
+    const char* const SQL_MONTH_SUMMARY =
+        "SELECT COUNT(*) AS total_count, IFNULL(SUM(Amount), 0) AS total_sum "
+        "FROM payment WHERE PaymentStatus = 'Complete' "
+        "AND TimeStamp >= ? AND TimeStamp < ?";
+    const char* const SQL_MONTH_ARCHIVED =
+        "SELECT CompleteCount, CompleteAmount FROM payment_monthly_archive WHERE Year = ? AND Month = ?";
+    const PlanRegistration planMonthSummary("month_summary", "MySqlRepositories.cpp", SQL_MONTH_SUMMARY, { "2025-06-01", "2025-07-01" });
+    const PlanRegistration planMonthArchived("month_archived", "MySqlRepositories.cpp", SQL_MONTH_ARCHIVED, { "2025", "6" });
+
+    string monthStart(int year, int month) {
+        while (month > 12) { month -= 12; year++; }
+        ostringstream oss;
+        oss << year << "-" << setw(2) << setfill('0') << month << "-01";
+        return oss.str();
+    }
+
+    int lastInsertID(Connection* con) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery("SELECT LAST_INSERT_ID()"));
+        return res->next() ? res->getInt(1) : -1;
+    }
+
+    // The statements the modules already run; nothing here commits
+    class MySqlRepositories : public Repositories {
+    public:
+        explicit MySqlRepositories(Connection* con) : con_(con) {}
+
+        const char* backendName() const override { return "mysql"; }
+
+        int addUser(const string& fullName, const string& email, const string& role) override {
+            PreparedStatement* pstmt = cachedStatement(con_,
+                "INSERT INTO `user` (FullName, Email, Password, Role) VALUES (?, ?, 'N/A', ?)");
+            pstmt->setString(1, fullName);
+            pstmt->setString(2, email);
+            pstmt->setString(3, role);
+            pstmt->executeUpdate();
+            int userID = lastInsertID(con_);
+            bumpCustomerDirectoryVersion(con_);
+            return userID;
+        }
+
+        bool exists(int userID) override {
+            PreparedStatement* pstmt = cachedStatement(con_, "SELECT 1 FROM user WHERE UserID = ? LIMIT 1");
+            pstmt->setInt(1, userID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        }
+
+        bool isCustomer(int userID) override {
+            PreparedStatement* pstmt = cachedStatement(con_, "SELECT 1 FROM user WHERE UserID = ? AND Role = 'Customer' LIMIT 1");
+            pstmt->setInt(1, userID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        }
+
+        int addJob(int userID, int pageCount, double costPerPage, const string& timeStamp, int queuePriority) override {
+            return insertPrintJobRecord(con_, userID, pageCount, costPerPage, timeStamp, StockUpdate::Deferred, queuePriority);
+        }
+
+        bool jobCost(int jobID, int userID, Money& cost) override {
+            // Locked until the caller's transaction ends, so a second payment for the job waits here
+            PreparedStatement* pstmt = cachedStatement(con_,
+                "SELECT JobCost FROM printjob WHERE JobID = ? AND UserID = ? LIMIT 1 FOR UPDATE");
+            pstmt->setInt(1, jobID);
+            pstmt->setInt(2, userID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            if (!res->next()) return false;
+            cost = getMoney(*res, "JobCost");
+            return true;
+        }
+
+        bool isPaid(int jobID) override {
+            // A locking read sees the latest commit, not the transaction's older snapshot
+            PreparedStatement* pstmt = cachedStatement(con_, "SELECT 1 FROM payment WHERE JobID = ? LIMIT 1 LOCK IN SHARE MODE");
+            pstmt->setInt(1, jobID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        }
+
+        int addPayment(const PaymentRecord& payment) override {
+            PreparedStatement* pstmt = cachedStatement(con_, payment.timeStamp.empty()
+                ? "INSERT INTO payment (UserID, JobID, Amount, Method, PaymentStatus) VALUES (?, ?, ?, ?, ?)"
+                : "INSERT INTO payment (UserID, JobID, Amount, Method, PaymentStatus, TimeStamp) VALUES (?, ?, ?, ?, ?, ?)");
+            pstmt->setInt(1, payment.userID);
+            pstmt->setInt(2, payment.jobID);
+            pstmt->setString(3, payment.amount.toString());
+            pstmt->setString(4, payment.method);
+            pstmt->setString(5, payment.status);
+            if (!payment.timeStamp.empty()) pstmt->setString(6, payment.timeStamp);
+            pstmt->executeUpdate();
+            return lastInsertID(con_);
+        }
+
+        void restock(int inventoryID, long long units) override {
+            PreparedStatement* pstmt = cachedStatement(con_, "UPDATE inventory SET Quantity = Quantity + ? WHERE InventoryID = ?");
+            pstmt->setInt64(1, units);
+            pstmt->setInt(2, inventoryID);
+            pstmt->executeUpdate();
+        }
+
+        long long quantity(int inventoryID) override {
+            PreparedStatement* pstmt = cachedStatement(con_, "SELECT Quantity FROM inventory WHERE InventoryID = ?");
+            pstmt->setInt(1, inventoryID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next() ? res->getInt64("Quantity") : 0;
+        }
+
+        bool take(const vector<MaterialNeed>& needs, int& shortItem) override {
+            string ids;
+            for (const MaterialNeed& need : needs) {
+                if (need.units > 0) ids += (ids.empty() ? "" : ",") + to_string(need.inventoryID);
+            }
+            if (ids.empty()) return true;
+
+            // Locked until the caller's transaction ends, so the check still holds at the update
+            map<int, long long> left;
+            {
+                unique_ptr<Statement> stmt(con_->createStatement());
+                unique_ptr<ResultSet> res(stmt->executeQuery(
+                    "SELECT InventoryID, Quantity FROM inventory WHERE InventoryID IN (" + ids + ") FOR UPDATE"));
+                while (res->next()) left[res->getInt("InventoryID")] = res->getInt64("Quantity");
+            }
+            for (const MaterialNeed& need : needs) {
+                if (need.units > 0 && left[need.inventoryID] < need.units) {
+                    shortItem = need.inventoryID;
+                    return false;
+                }
+            }
+            applyMaterialUsage(con_, needs, true);
+            logMaterialUsage(con_, needs);
+            return true;
+        }
+
+        MonthTotals completedPayments(int year, int month) override {
+            MonthTotals totals;
+            PreparedStatement* live = cachedStatement(con_, SQL_MONTH_SUMMARY);
+            live->setString(1, monthStart(year, month));
+            live->setString(2, monthStart(year, month + 1));
+            unique_ptr<ResultSet> liveRes(live->executeQuery());
+            if (liveRes->next()) {
+                totals.count = liveRes->getInt64("total_count");
+                totals.amount = getMoney(*liveRes, "total_sum");
+            }
+
+            PreparedStatement* archived = cachedStatement(con_, SQL_MONTH_ARCHIVED);
+            archived->setInt(1, year);
+            archived->setInt(2, month);
+            unique_ptr<ResultSet> archivedRes(archived->executeQuery());
+            if (archivedRes->next()) {
+                totals.archivedCount = archivedRes->getInt64("CompleteCount");
+                totals.count += totals.archivedCount;
+                totals.amount += getMoney(*archivedRes, "CompleteAmount");
+            }
+            return totals;
+        }
+
+    private:
+        Connection* con_;
+    };
+}
+
+std::unique_ptr<Repositories> makeMySqlRepositories(sql::Connection* con) {
+    return std::unique_ptr<Repositories>(new MySqlRepositories(con));
+}
@@ -0,0 +1,360 @@
+#include "OfflineJournal.h"
+#include "db.h"       // getConfigValue(), getConfigInt()
+#include "printjob.h" // insertPrintJobRecord()
+#include "PaymentModule.h" // insertPaymentRecord()
+#include "BillOfMaterials.h" // ConsumptionBatch
+#include "ResilientConnection.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <ctime>
+#include <random>
+#include <memory>
+#include <cstdio>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/statement.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// STATE & HELPERS
+// ==========================================
+
+namespace {
+    atomic<bool> g_online(true);
+    mutex g_journalMutex;
+    int g_pending = -1; // -1 = not counted yet
+
+    string journalPath() {
+        return getConfigValue("JOURNAL_FILE", "offline_journal.log");
+    }
+
+    // Local wall-clock time in MySQL DATETIME format
+    string nowTimestamp() {
+        time_t t = time(nullptr);
+        tm local{};
+#ifdef _WIN32
+        localtime_s(&local, &t);
+#else
+        localtime_r(&t, &local);
+#endif
+        ostringstream oss;
+        oss << put_time(&local, "%Y-%m-%d %H:%M:%S");
+        return oss.str();
+    }
+
+    // <terminal>-<epoch ms>-<sequence>, unique per terminal and process run
+    string newIdempotencyKey() {
+        static const string terminal = []() {
+            string configured = getConfigValue("TERMINAL_ID");
+            if (!configured.empty()) return configured;
+            random_device rd;
+            ostringstream oss;
+            oss << hex << setw(8) << setfill('0') << rd();
+            return oss.str();
+        }();
+        static atomic<unsigned> sequence(0);
+        long long ms = chrono::duration_cast<chrono::milliseconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+        return terminal + "-" + to_string(ms) + "-" + to_string(sequence++);
+    }
+
+    // Fields are '|'-separated; escape the separator, newlines and the escape char
+    string escapeField(const string& in) {
+        string out;
+        for (char c : in) {
+            if (c == '%') out += "%25";
+            else if (c == '|') out += "%7C";
+            else if (c == '\n') out += "%0A";
+            else if (c == '\r') out += "%0D";
+            else out += c;
+        }
+        return out;
+    }
+
+    string unescapeField(const string& in) {
+        string out;
+        for (size_t i = 0; i < in.size(); i++) {
+            if (in[i] == '%' && i + 2 < in.size()) {
+                out += char(stoi(in.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            }
+            else {
+                out += in[i];
+            }
+        }
+        return out;
+    }
+
+    vector<string> splitEntry(const string& line) {
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, '|')) fields.push_back(unescapeField(field));
+        return fields;
+    }
+
+    vector<string> readEntries() {
+        vector<string> lines;
+        ifstream in(journalPath());
+        string line;
+        while (getline(in, line)) {
+            if (!line.empty()) lines.push_back(line);
+        }
+        return lines;
+    }
+
+    // Swaps in a journal holding `lines` through a temp file, so a crash leaves the
+    // old journal or the new one, never a partial one
+    bool rewriteJournal(const vector<string>& lines) {
+        const string path = journalPath();
+        const string temp = path + ".tmp";
+        {
+            ofstream out(temp, ios::trunc);
+            for (const string& line : lines) out << line << "\n";
+            out.flush();
+            if (!out) return false;
+        }
+#ifdef _WIN32
+        return MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    }
+
+    // Entry layout: key|op|timestamp|field...
+    string appendEntry(const string& op, const vector<string>& fields) {
+        string key = newIdempotencyKey();
+        ostringstream line;
+        line << key << "|" << op << "|" << nowTimestamp();
+        for (const auto& f : fields) line << "|" << escapeField(f);
+
+        lock_guard<mutex> lock(g_journalMutex);
+        ofstream out(journalPath(), ios::app);
+        out << line.str() << "\n";
+        out.flush();
+        if (g_pending >= 0) g_pending++;
+        return key;
+    }
+
+    // ==========================================
+    // REPLAY OF A SINGLE ENTRY
+    // ==========================================
+
+    // Each apply returns false, after saying why on cerr, when the entry is rejected
+
+    bool applyPayment(Connection* con, const vector<string>& f) {
+        // f: key, op, ts, uid, jid, amount, method
+        // Validation was deferred while offline; insertPaymentRecord redoes it now
+        string reason;
+        Money amount;
+        if (!Money::parse(f[5], amount)) {
+            cerr << "[Journal] Payment " << f[0] << " rejected: amount " << f[5] << " is not a whole number of cents\n";
+            return false;
+        }
+        if (insertPaymentRecord(con, stoi(f[3]), stoi(f[4]), amount, f[6], f[2], reason).empty()) {
+            cerr << "[Journal] Payment " << f[0] << " rejected: " << reason << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool applyConsumption(Connection* con, const vector<string>& f) {
+        // f: key, op, ts, inventoryID, quantityUsed
+        int inventoryID = stoi(f[3]);
+        int quantityUsed = stoi(f[4]);
+
+        unique_ptr<PreparedStatement> upd(
+            con->prepareStatement("UPDATE inventory SET Quantity = Quantity - ? WHERE InventoryID = ?")
+        );
+        upd->setInt(1, quantityUsed);
+        upd->setInt(2, inventoryID);
+        if (upd->executeUpdate() == 0) {
+            cerr << "[Journal] Consumption " << f[0] << " rejected: InventoryID " << inventoryID << " not found.\n";
+            return false;
+        }
+
+        unique_ptr<PreparedStatement> log(
+            con->prepareStatement("INSERT INTO inventoryconsumption (InventoryID, QuantityUsed, TimeStamp) VALUES (?, ?, ?)")
+        );
+        log->setInt(1, inventoryID);
+        log->setInt(2, quantityUsed);
+        log->setString(3, f[2]);
+        log->executeUpdate();
+        return true;
+    }
+
+    // Print jobs only insert their row here; their stock usage is summed into the
+    // batch and written once per commit
+    bool applyEntry(Connection* con, const vector<string>& f, ConsumptionBatch& usage) {
+        const string& op = f[1];
+        if (op == "PRINTJOB" && f.size() >= 6) {
+            // f: key, op, ts, uid, pages, costPerPage[, queuePriority]
+            int userID = stoi(f[3]);
+            int pageCount = stoi(f[4]);
+            int queuePriority = f.size() >= 7 ? stoi(f[6]) : NOT_QUEUED;
+            if (!isCustomerUser(con, userID)) {
+                cerr << "[Journal] Print job " << f[0] << " rejected: UserID " << userID << " is not a customer.\n";
+                return false;
+            }
+            if (insertPrintJobRecord(con, userID, pageCount, stod(f[5]), f[2], StockUpdate::Deferred, queuePriority) == -1) {
+                cerr << "[Journal] Print job " << f[0] << " rejected: no JobID was generated.\n";
+                return false;
+            }
+            usage.add(materialsForPages(bomForJobType(con), pageCount), f[2]);
+            return true;
+        }
+        if (op == "PAYMENT" && f.size() >= 7) return applyPayment(con, f);
+        if (op == "CONSUMPTION" && f.size() >= 5) return applyConsumption(con, f);
+        cerr << "[Journal] Skipping malformed entry " << f[0] << ".\n";
+        return false;
+    }
+}
+
+// ==========================================
+// PUBLIC API
+// ==========================================
+
+bool isConnectionLost(const sql::SQLException& e) {
+    return classifyDbError(e) == DbErrorClass::ConnectionLost;
+}
+
+bool isDatabaseOnline() { return g_online; }
+
+void markDatabaseOffline() {
+    if (g_online.exchange(false)) {
+        cout << "[Offline] Database unreachable. Writes will be journaled locally.\n";
+    }
+}
+
+void markDatabaseOnline() { g_online = true; }
+
+string journalPrintJob(int userID, int pageCount, double costPerPage, int queuePriority) {
+    vector<string> fields = { to_string(userID), to_string(pageCount), to_string(costPerPage) };
+    if (queuePriority >= 0) fields.push_back(to_string(queuePriority));
+    return appendEntry("PRINTJOB", fields);
+}
+
+string journalPayment(int userID, int jobID, Money amount, const string& method) {
+    return appendEntry("PAYMENT", { to_string(userID), to_string(jobID), amount.toString(), method });
+}
+
+string journalConsumption(int inventoryID, int quantityUsed) {
+    return appendEntry("CONSUMPTION", { to_string(inventoryID), to_string(quantityUsed) });
+}
+
+int pendingJournalEntries() {
+    lock_guard<mutex> lock(g_journalMutex);
+    if (g_pending < 0) g_pending = static_cast<int>(readEntries().size());
+    return g_pending;
+}
+
+int replayJournal(sql::Connection* con) {
+    lock_guard<mutex> lock(g_journalMutex);
+    vector<string> entries = readEntries();
+    g_pending = static_cast<int>(entries.size());
+    if (entries.empty()) return 0;
+
+    // Make sure the link is back before touching anything (single quick attempt)
+    if (!reconnectWithBackoff(con, 1)) return -1;
+
+    int batchSize = getConfigInt("JOURNAL_BATCH_SIZE", 50);
+    if (batchSize < 1) batchSize = 1;
+    size_t done = 0;
+    int applied = 0;
+
+    try {
+        unique_ptr<PreparedStatement> claim(
+            con->prepareStatement("INSERT IGNORE INTO journal_applied (IdemKey) VALUES (?)")
+        );
+        unique_ptr<Statement> savepoint(con->createStatement());
+
+        con->setAutoCommit(false);
+        ConsumptionBatch usage;
+        while (done < entries.size()) {
+            size_t end = done + batchSize;
+            if (end > entries.size()) end = entries.size();
+            int appliedInBatch = 0; // counted once the batch commits
+
+            for (size_t i = done; i < end; i++) {
+                vector<string> f = splitEntry(entries[i]);
+                if (f.size() < 3) continue;
+
+                // A rejected entry is undone back to here, key claim included, and
+                // dropped; the rest of the batch still commits
+                savepoint->execute("SAVEPOINT journal_entry");
+
+                // Claim the key first; 0 rows means an earlier replay already applied it
+                claim->setString(1, f[0]);
+                if (claim->executeUpdate() == 0) continue;
+
+                try {
+                    if (applyEntry(con, f, usage)) appliedInBatch++;
+                    else savepoint->execute("ROLLBACK TO SAVEPOINT journal_entry");
+                }
+                catch (SQLException& e) {
+                    if (isConnectionLost(e)) throw;
+                    savepoint->execute("ROLLBACK TO SAVEPOINT journal_entry");
+                    cerr << "[Journal] Entry " << f[0] << " rejected: " << e.what() << endl;
+                }
+                catch (exception&) {
+                    savepoint->execute("ROLLBACK TO SAVEPOINT journal_entry");
+                    cerr << "[Journal] Skipping malformed entry " << f[0] << ".\n";
+                }
+            }
+            if (!usage.empty()) usage.flush(con);
+            con->commit();
+            applied += appliedInBatch;
+            done = end;
+        }
+        con->setAutoCommit(true);
+        markDatabaseOnline();
+    }
+    catch (SQLException& e) {
+        try {
+            con->rollback();
+            con->setAutoCommit(true);
+        }
+        catch (SQLException&) {}
+
+        if (isConnectionLost(e)) markDatabaseOffline();
+        else cerr << "[Journal] Replay stopped: " << e.what() << endl;
+    }
+
+    // Keep only the entries whose batch did not commit. If the swap fails the applied
+    // ones stay too; their claimed keys make the next replay skip them.
+    if (done > 0) {
+        if (rewriteJournal(vector<string>(entries.begin() + done, entries.end()))) {
+            g_pending = static_cast<int>(entries.size() - done);
+        }
+        else {
+            cerr << "[Journal] Could not rewrite " << journalPath() << "; applied entries will be skipped on the next replay.\n";
+        }
+    }
+
+    if (done == 0 && !isDatabaseOnline()) return -1;
+    return applied;
+}
+
+void syncJournalIfPending(sql::Connection* con) {
+    // A failed check may have flipped us offline without journaling anything
+    if (!isDatabaseOnline() && !reconnectWithBackoff(con, 1)) return;
+    if (pendingJournalEntries() == 0) return;
+    int applied = replayJournal(con);
+    if (applied > 0) {
+        cout << "[Journal] Synced " << applied << " offline entr" << (applied == 1 ? "y" : "ies")
+            << " to the database.\n";
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <mysql_connection.h>
+#include "Money.h"
+#include <cppconn/exception.h>
+
+// ==========================================
+// OFFLINE WRITE-BEHIND JOURNAL
+// ==========================================
+// When the MySQL link drops, print-job, payment and consumption writes are
+// appended to a local journal file (JOURNAL_FILE in config.ini). Each entry
+// carries an idempotency key; replay inserts the key into `journal_applied`
+// in the same transaction as the write, so an entry is never applied twice.
+
+// True for connector errors that mean the server link is gone (see classifyDbError)
+bool isConnectionLost(const sql::SQLException& e);
+
+// Shared online/offline state for the whole process
+bool isDatabaseOnline();
+void markDatabaseOffline();
+void markDatabaseOnline();
+
+// Append entries to the journal; each returns the entry's idempotency key.
+// A print job's queuePriority is as for insertPrintJobRecord (-1 = not queued).
+std::string journalPrintJob(int userID, int pageCount, double costPerPage, int queuePriority = -1);
+std::string journalPayment(int userID, int jobID, Money amount, const std::string& method);
+std::string journalConsumption(int inventoryID, int quantityUsed);
+
+// Number of entries waiting to be replayed
+int pendingJournalEntries();
+
+// Replay pending entries in batched transactions (JOURNAL_BATCH_SIZE per commit).
+// Reconnects first if needed. Returns the number of entries applied, or -1 if
+// the server is still unreachable.
+int replayJournal(sql::Connection* con);
+
+// Replays only when something is pending; quiet when the journal is empty
+void syncJournalIfPending(sql::Connection* con);
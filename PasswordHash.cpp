@@ -0,0 +1,407 @@
+#include "PasswordHash.h"
+#include "db.h" // getConfigInt()
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// SHA-256 / HMAC / PBKDF2
+// ==========================================
+
+namespace {
+
+    const uint32_t K256[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+    inline uint32_t rotl(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+    struct Sha256 {
+        uint32_t state[8];
+        uint8_t block[64];
+        size_t blockLen;
+        uint64_t totalLen;
+
+        Sha256() { reset(); }
+
+        void reset() {
+            static const uint32_t init[8] = {
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            };
+            memcpy(state, init, sizeof(state));
+            blockLen = 0;
+            totalLen = 0;
+        }
+
+        void compress(const uint8_t* chunk) {
+            uint32_t w[64];
+            for (int i = 0; i < 16; i++) {
+                w[i] = (uint32_t(chunk[i * 4]) << 24) | (uint32_t(chunk[i * 4 + 1]) << 16) |
+                    (uint32_t(chunk[i * 4 + 2]) << 8) | uint32_t(chunk[i * 4 + 3]);
+            }
+            for (int i = 16; i < 64; i++) {
+                uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (int i = 0; i < 64; i++) {
+                uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+                uint32_t ch = (e & f) ^ (~e & g);
+                uint32_t t1 = h + S1 + ch + K256[i] + w[i];
+                uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+                uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                uint32_t t2 = S0 + maj;
+                h = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+
+        void update(const uint8_t* data, size_t len) {
+            totalLen += len;
+            while (len > 0) {
+                size_t take = 64 - blockLen;
+                if (take > len) take = len;
+                memcpy(block + blockLen, data, take);
+                blockLen += take;
+                data += take;
+                len -= take;
+                if (blockLen == 64) {
+                    compress(block);
+                    blockLen = 0;
+                }
+            }
+        }
+
+        void finish(uint8_t out[32]) {
+            uint64_t bitLen = totalLen * 8;
+            uint8_t pad = 0x80;
+            update(&pad, 1);
+            uint8_t zero = 0;
+            while (blockLen != 56) update(&zero, 1);
+            uint8_t lenBytes[8];
+            for (int i = 0; i < 8; i++) lenBytes[i] = uint8_t(bitLen >> (56 - 8 * i));
+            update(lenBytes, 8);
+            for (int i = 0; i < 8; i++) {
+                out[i * 4] = uint8_t(state[i] >> 24);
+                out[i * 4 + 1] = uint8_t(state[i] >> 16);
+                out[i * 4 + 2] = uint8_t(state[i] >> 8);
+                out[i * 4 + 3] = uint8_t(state[i]);
+            }
+        }
+    };
+
+    // HMAC-SHA256 with the key pads precomputed once (PBKDF2 reuses them per block)
+    struct HmacSha256 {
+        Sha256 inner, outer;
+
+        explicit HmacSha256(const uint8_t* key, size_t keyLen) {
+            uint8_t k[64] = { 0 };
+            if (keyLen > 64) {
+                Sha256 h;
+                h.update(key, keyLen);
+                h.finish(k);
+            }
+            else {
+                memcpy(k, key, keyLen);
+            }
+            uint8_t ipad[64], opad[64];
+            for (int i = 0; i < 64; i++) {
+                ipad[i] = k[i] ^ 0x36;
+                opad[i] = k[i] ^ 0x5c;
+            }
+            inner.update(ipad, 64);
+            outer.update(opad, 64);
+        }
+
+        void mac(const uint8_t* msg1, size_t len1, const uint8_t* msg2, size_t len2, uint8_t out[32]) const {
+            Sha256 in = inner;
+            in.update(msg1, len1);
+            if (len2) in.update(msg2, len2);
+            uint8_t innerHash[32];
+            in.finish(innerHash);
+            Sha256 o = outer;
+            o.update(innerHash, 32);
+            o.finish(out);
+        }
+    };
+
+    // PBKDF2-HMAC-SHA256 with a single iteration (all scrypt needs)
+    void pbkdf2Sha256(const uint8_t* pwd, size_t pwdLen, const uint8_t* salt, size_t saltLen,
+        uint8_t* out, size_t outLen) {
+        HmacSha256 hmac(pwd, pwdLen);
+        uint32_t blockIndex = 1;
+        while (outLen > 0) {
+            uint8_t counter[4] = {
+                uint8_t(blockIndex >> 24), uint8_t(blockIndex >> 16), uint8_t(blockIndex >> 8), uint8_t(blockIndex)
+            };
+            vector<uint8_t> msg(salt, salt + saltLen);
+            msg.insert(msg.end(), counter, counter + 4);
+            uint8_t u[32];
+            hmac.mac(msg.data(), msg.size(), nullptr, 0, u);
+            size_t take = outLen < 32 ? outLen : 32;
+            memcpy(out, u, take);
+            out += take;
+            outLen -= take;
+            blockIndex++;
+        }
+    }
+
+    // ==========================================
+    // SCRYPT CORE (Salsa20/8, BlockMix, ROMix)
+    // ==========================================
+
+    void salsa20_8(uint32_t b[16]) {
+        uint32_t x[16];
+        memcpy(x, b, sizeof(x));
+        for (int i = 0; i < 8; i += 2) {
+            x[4] ^= rotl(x[0] + x[12], 7);   x[8] ^= rotl(x[4] + x[0], 9);
+            x[12] ^= rotl(x[8] + x[4], 13);  x[0] ^= rotl(x[12] + x[8], 18);
+            x[9] ^= rotl(x[5] + x[1], 7);    x[13] ^= rotl(x[9] + x[5], 9);
+            x[1] ^= rotl(x[13] + x[9], 13);  x[5] ^= rotl(x[1] + x[13], 18);
+            x[14] ^= rotl(x[10] + x[6], 7);  x[2] ^= rotl(x[14] + x[10], 9);
+            x[6] ^= rotl(x[2] + x[14], 13);  x[10] ^= rotl(x[6] + x[2], 18);
+            x[3] ^= rotl(x[15] + x[11], 7);  x[7] ^= rotl(x[3] + x[15], 9);
+            x[11] ^= rotl(x[7] + x[3], 13);  x[15] ^= rotl(x[11] + x[7], 18);
+            x[1] ^= rotl(x[0] + x[3], 7);    x[2] ^= rotl(x[1] + x[0], 9);
+            x[3] ^= rotl(x[2] + x[1], 13);   x[0] ^= rotl(x[3] + x[2], 18);
+            x[6] ^= rotl(x[5] + x[4], 7);    x[7] ^= rotl(x[6] + x[5], 9);
+            x[4] ^= rotl(x[7] + x[6], 13);   x[5] ^= rotl(x[4] + x[7], 18);
+            x[11] ^= rotl(x[10] + x[9], 7);  x[8] ^= rotl(x[11] + x[10], 9);
+            x[9] ^= rotl(x[8] + x[11], 13);  x[10] ^= rotl(x[9] + x[8], 18);
+            x[12] ^= rotl(x[15] + x[14], 7); x[13] ^= rotl(x[12] + x[15], 9);
+            x[14] ^= rotl(x[13] + x[12], 13); x[15] ^= rotl(x[14] + x[13], 18);
+        }
+        for (int i = 0; i < 16; i++) b[i] += x[i];
+    }
+
+    // in/out are 2r blocks of 16 words; out must not alias in
+    void blockMix(const uint32_t* in, uint32_t* out, int r) {
+        uint32_t x[16];
+        memcpy(x, in + (2 * r - 1) * 16, sizeof(x));
+        for (int i = 0; i < 2 * r; i++) {
+            for (int k = 0; k < 16; k++) x[k] ^= in[i * 16 + k];
+            salsa20_8(x);
+            // Even blocks go to the first half, odd blocks to the second half
+            uint32_t* dst = out + ((i / 2) + (i % 2) * r) * 16;
+            memcpy(dst, x, sizeof(x));
+        }
+    }
+
+    void roMix(uint8_t* block, int r, uint64_t N) {
+        const size_t words = size_t(32) * r;
+        vector<uint32_t> x(words), y(words);
+        vector<uint32_t> v(words * N);
+
+        for (size_t k = 0; k < words; k++) {
+            const uint8_t* p = block + k * 4;
+            x[k] = uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+        }
+        for (uint64_t i = 0; i < N; i++) {
+            memcpy(&v[i * words], x.data(), words * 4);
+            blockMix(x.data(), y.data(), r);
+            x.swap(y);
+        }
+        for (uint64_t i = 0; i < N; i++) {
+            uint64_t j = x[(2 * r - 1) * 16] & (N - 1);
+            const uint32_t* vj = &v[j * words];
+            for (size_t k = 0; k < words; k++) x[k] ^= vj[k];
+            blockMix(x.data(), y.data(), r);
+            x.swap(y);
+        }
+        for (size_t k = 0; k < words; k++) {
+            uint8_t* p = block + k * 4;
+            p[0] = uint8_t(x[k]); p[1] = uint8_t(x[k] >> 8); p[2] = uint8_t(x[k] >> 16); p[3] = uint8_t(x[k] >> 24);
+        }
+    }
+
+    // ==========================================
+    // ENCODING HELPERS
+    // ==========================================
+
+    const char* B64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    string base64Encode(const string& in) {
+        string out;
+        size_t i = 0;
+        while (i + 2 < in.size()) {
+            uint32_t n = (uint8_t(in[i]) << 16) | (uint8_t(in[i + 1]) << 8) | uint8_t(in[i + 2]);
+            out += B64[(n >> 18) & 63]; out += B64[(n >> 12) & 63];
+            out += B64[(n >> 6) & 63];  out += B64[n & 63];
+            i += 3;
+        }
+        if (i + 1 == in.size()) {
+            uint32_t n = uint8_t(in[i]) << 16;
+            out += B64[(n >> 18) & 63]; out += B64[(n >> 12) & 63];
+        }
+        else if (i + 2 == in.size()) {
+            uint32_t n = (uint8_t(in[i]) << 16) | (uint8_t(in[i + 1]) << 8);
+            out += B64[(n >> 18) & 63]; out += B64[(n >> 12) & 63]; out += B64[(n >> 6) & 63];
+        }
+        return out; // Unpadded, like the PHC string format
+    }
+
+    bool base64Decode(const string& in, string& out) {
+        out.clear();
+        uint32_t acc = 0;
+        int bits = 0;
+        for (char c : in) {
+            const char* pos = strchr(B64, c);
+            if (c == '\0' || pos == nullptr) return false;
+            acc = (acc << 6) | uint32_t(pos - B64);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                out += char((acc >> bits) & 0xFF);
+            }
+        }
+        return true;
+    }
+
+    bool constantTimeEquals(const string& a, const string& b) {
+        if (a.size() != b.size()) return false;
+        unsigned char diff = 0;
+        for (size_t i = 0; i < a.size(); i++) diff |= uint8_t(a[i]) ^ uint8_t(b[i]);
+        return diff == 0;
+    }
+
+    const string PREFIX = "$scrypt$";
+    const size_t SALT_BYTES = 16;
+    const size_t HASH_BYTES = 32;
+
+    // Limits for configured and stored parameters alike, so neither a config.ini
+    // typo nor a tampered user.Password row can turn a login into a huge allocation
+    const int MIN_LOG_N = 10;
+    const int MAX_LOG_N = 20;
+    const int MAX_R = 32;
+    const int MAX_P = 16;
+    const uint64_t MAX_SCRYPT_BYTES = uint64_t(1) << 30;  // 128 * r * N, and 128 * r * p
+
+    bool withinLimits(const ScryptParams& params) {
+        if (params.logN < MIN_LOG_N || params.logN > MAX_LOG_N) return false;
+        if (params.r < 1 || params.r > MAX_R || params.p < 1 || params.p > MAX_P) return false;
+        const uint64_t blockBytes = uint64_t(128) * params.r;
+        return blockBytes << params.logN <= MAX_SCRYPT_BYTES && blockBytes * params.p <= MAX_SCRYPT_BYTES;
+    }
+
+    // Split "$scrypt$ln=14,r=8,p=1$salt$hash" into its parts
+    bool parseHash(const string& stored, ScryptParams& params, string& salt, string& hash) {
+        if (stored.compare(0, PREFIX.size(), PREFIX) != 0) return false;
+        size_t paramEnd = stored.find('$', PREFIX.size());
+        if (paramEnd == string::npos) return false;
+        size_t saltEnd = stored.find('$', paramEnd + 1);
+        if (saltEnd == string::npos) return false;
+
+        // Parameter list is "ln=<int>,r=<int>,p=<int>"
+        params.logN = params.r = params.p = 0;
+        stringstream paramStream(stored.substr(PREFIX.size(), paramEnd - PREFIX.size()));
+        string field;
+        while (getline(paramStream, field, ',')) {
+            size_t eq = field.find('=');
+            if (eq == string::npos) return false;
+            string key = field.substr(0, eq);
+            int value = atoi(field.c_str() + eq + 1);
+            if (key == "ln") params.logN = value;
+            else if (key == "r") params.r = value;
+            else if (key == "p") params.p = value;
+        }
+        if (!withinLimits(params)) return false;
+
+        return base64Decode(stored.substr(paramEnd + 1, saltEnd - paramEnd - 1), salt) &&
+            base64Decode(stored.substr(saltEnd + 1), hash) && !hash.empty();
+    }
+}
+
+// ==========================================
+// PUBLIC API
+// ==========================================
+
+ScryptParams loadScryptParams() {
+    ScryptParams params;
+    params.logN = getConfigInt("SCRYPT_LOG_N", 14);
+    params.r = getConfigInt("SCRYPT_R", 8);
+    params.p = getConfigInt("SCRYPT_P", 1);
+
+    // Guard against typos in config.ini turning login into a multi-GB allocation
+    params.logN = min(max(params.logN, MIN_LOG_N), MAX_LOG_N);
+    params.r = min(max(params.r, 1), MAX_R);
+    params.p = min(max(params.p, 1), MAX_P);
+    while (!withinLimits(params) && params.logN > MIN_LOG_N) params.logN--;
+    return params;
+}
+
+string scryptDerive(const string& password, const string& salt, const ScryptParams& params, size_t keyLength) {
+    const uint64_t N = uint64_t(1) << params.logN;
+    const size_t blockBytes = size_t(128) * params.r;
+
+    vector<uint8_t> b(blockBytes * params.p);
+    pbkdf2Sha256(reinterpret_cast<const uint8_t*>(password.data()), password.size(),
+        reinterpret_cast<const uint8_t*>(salt.data()), salt.size(), b.data(), b.size());
+
+    for (int i = 0; i < params.p; i++) {
+        roMix(b.data() + i * blockBytes, params.r, N);
+    }
+
+    string out(keyLength, '\0');
+    pbkdf2Sha256(reinterpret_cast<const uint8_t*>(password.data()), password.size(),
+        b.data(), b.size(), reinterpret_cast<uint8_t*>(&out[0]), keyLength);
+    return out;
+}
+
+string hashPassword(const string& password) {
+    return hashPassword(password, loadScryptParams());
+}
+
+string hashPassword(const string& password, const ScryptParams& params) {
+    random_device rd;
+    string salt(SALT_BYTES, '\0');
+    for (size_t i = 0; i < SALT_BYTES; i++) salt[i] = char(rd() & 0xFF);
+
+    string hash = scryptDerive(password, salt, params, HASH_BYTES);
+
+    ostringstream oss;
+    oss << PREFIX << "ln=" << params.logN << ",r=" << params.r << ",p=" << params.p
+        << "$" << base64Encode(salt) << "$" << base64Encode(hash);
+    return oss.str();
+}
+
+bool isPasswordHash(const string& stored) {
+    return stored.compare(0, PREFIX.size(), PREFIX) == 0;
+}
+
+bool verifyPassword(const string& password, const string& stored) {
+    if (!isPasswordHash(stored)) {
+        // Legacy row written before hashing was introduced
+        return constantTimeEquals(password, stored);
+    }
+
+    ScryptParams params;
+    string salt, expected;
+    if (!parseHash(stored, params, salt, expected)) return false;
+
+    return constantTimeEquals(scryptDerive(password, salt, params, expected.size()), expected);
+}
+
+bool needsRehash(const string& stored, const ScryptParams& params) {
+    ScryptParams current;
+    string salt, hash;
+    if (!parseHash(stored, current, salt, hash)) return true;
+    return current.logN != params.logN || current.r != params.r || current.p != params.p;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+// ==========================================
+// PASSWORD HASHING (scrypt, RFC 7914)
+// ==========================================
+// Stored format: $scrypt$ln=<log2 N>,r=<r>,p=<p>$<salt base64>$<hash base64>
+// Cost parameters come from config.ini (SCRYPT_LOG_N, SCRYPT_R, SCRYPT_P).
+
+struct ScryptParams {
+    int logN; // CPU/memory cost, N = 2^logN
+    int r;    // Block size (memory per hash = 128 * r * N bytes)
+    int p;    // Parallelisation factor
+};
+
+// Parameters configured in config.ini (defaults: ln=14, r=8, p=1 -> 16 MiB per hash)
+ScryptParams loadScryptParams();
+
+// Hash a password with a fresh random salt
+std::string hashPassword(const std::string& password);
+std::string hashPassword(const std::string& password, const ScryptParams& params);
+
+// True when the stored value is an scrypt hash (false for legacy plain-text rows)
+bool isPasswordHash(const std::string& stored);
+
+// Verify against a stored hash; legacy plain-text values are compared directly
+bool verifyPassword(const std::string& password, const std::string& stored);
+
+// True when the stored value is plain text or was hashed with other parameters
+bool needsRehash(const std::string& stored, const ScryptParams& params);
+
+// Raw scrypt derivation (exposed for the benchmark and test vectors)
+std::string scryptDerive(const std::string& password, const std::string& salt,
+    const ScryptParams& params, size_t keyLength);
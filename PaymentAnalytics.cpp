@@ -0,0 +1,279 @@
+#include "PaymentAnalytics.h"
+#include "ResultStreaming.h"
+#include "AggregationKernels.h"
+#include "ResilientConnection.h"
+#include "ChangeFeed.h"
+#include "QueryPlanCheck.h"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// COLUMNS
+// ==========================================
+
+namespace {
+    const int PAYMENT_GAP_WAIT_S = 60;      // longest a payment transaction is expected to stay open
+    const size_t PAYMENT_GAP_LIMIT = 1000;  // newest skipped IDs that are re-asked for
+
+    // Day and cents are computed by the server, so the client parses no dates or decimals
+    const char* const PAYMENT_COLUMNS =
+        "SELECT TransactionID, UserID, Method, PaymentStatus, "
+        "TO_DAYS(TimeStamp) - 719528 AS Day, CAST(ROUND(Amount * 100) AS SIGNED) AS Cents FROM payment ";
+    const string SQL_PAYMENT_LOAD = string(PAYMENT_COLUMNS) + "ORDER BY TransactionID";
+    const string SQL_PAYMENT_CATCH_UP = string(PAYMENT_COLUMNS) + "WHERE TransactionID > ?";
+    // catchUp() appends the recent gaps as an IN list; this is its shape with two of them
+    const string SQL_PAYMENT_CATCH_UP_SHAPE = SQL_PAYMENT_CATCH_UP + " OR TransactionID IN (?, ?) ORDER BY TransactionID";
+    const char* const SQL_PAYMENT_ARCHIVED =
+        "SELECT Year * 12 + Month - 1 AS YM, CompleteCount, "
+        "CAST(ROUND(CompleteAmount * 100) AS SIGNED) AS Cents FROM payment_monthly_archive";
+    const char* const SQL_PAYMENT_VERSION = "SELECT Version FROM table_versions WHERE Name = 'payment_history'";
+
+    const PlanRegistration planPaymentLoad("payment_history_load", "PaymentAnalytics.cpp", SQL_PAYMENT_LOAD.c_str(), {});
+    const PlanRegistration planPaymentCatchUp("payment_history_catch_up", "PaymentAnalytics.cpp",
+        SQL_PAYMENT_CATCH_UP_SHAPE.c_str(), { "1000", "990", "995" });
+    const PlanRegistration planPaymentArchived("payment_archived_months", "PaymentAnalytics.cpp", SQL_PAYMENT_ARCHIVED, {});
+    const PlanRegistration planPaymentVersion("payment_history_version", "PaymentAnalytics.cpp", SQL_PAYMENT_VERSION, {});
+
+    // Value <-> small integer code, codes handed out in first-seen order
+    template <typename Value, typename Code>
+    class Dictionary {
+    public:
+        Code code(const Value& value) {
+            auto it = codes_.find(value);
+            if (it != codes_.end()) return it->second;
+            Code next = static_cast<Code>(values_.size());
+            codes_.emplace(value, next);
+            values_.push_back(value);
+            return next;
+        }
+
+        // False if the value never occurs
+        bool find(const Value& value, Code& code) const {
+            auto it = codes_.find(value);
+            if (it == codes_.end()) return false;
+            code = it->second;
+            return true;
+        }
+
+        const Value& value(Code code) const { return values_[code]; }
+
+    private:
+        unordered_map<Value, Code> codes_;
+        vector<Value> values_;
+    };
+
+    struct ArchivedMonth {
+        long long payments = 0;
+        int64_t cents = 0;
+    };
+
+    struct PaymentColumns {
+        vector<int32_t> transactionID;
+        vector<int32_t> day;
+        vector<int64_t> cents;
+        vector<uint8_t> status;
+        vector<uint16_t> method;
+        vector<uint32_t> user;
+        Dictionary<string, uint8_t> statuses;
+        Dictionary<string, uint16_t> methods;
+        Dictionary<int, uint32_t> users;
+
+        map<int, ArchivedMonth> archived;  // by year * 12 + month - 1
+
+        int watermark = 0;                                        // highest TransactionID loaded
+        deque<pair<int, chrono::steady_clock::time_point>> gaps;  // skipped IDs below it, oldest first
+        long long version = -1;                                   // 'payment_history' stamp; -1 = reload
+    };
+
+    mutex g_storeMutex;
+    unique_ptr<PaymentColumns> g_store;
+
+    // Set by the change feed, taken by refresh()
+    const unsigned PAYMENTS_ADDED = 1;
+    const unsigned PAYMENTS_EDITED = 2;
+    atomic<unsigned> g_changes(0);
+    once_flag g_subscribed;
+
+    void subscribeOnce() {
+        call_once(g_subscribed, []() {
+            subscribeToChanges("payment", [](const TableChange& change) {
+                g_changes.fetch_or(change.kind == TableChangeKind::Insert ? PAYMENTS_ADDED : PAYMENTS_EDITED);
+                });
+            subscribeToChanges("payment_monthly_archive", [](const TableChange&) {
+                g_changes.fetch_or(PAYMENTS_EDITED);
+                });
+            });
+    }
+
+    void append(PaymentColumns& cols, ResultSet& row) {
+        int id = row.getInt("TransactionID");
+        cols.transactionID.push_back(id);
+        cols.day.push_back(row.getInt("Day"));
+        cols.cents.push_back(row.getInt64("Cents"));
+        cols.status.push_back(cols.statuses.code(row.getString("PaymentStatus")));
+        cols.method.push_back(cols.methods.code(row.getString("Method")));
+        cols.user.push_back(cols.users.code(row.getInt("UserID")));
+
+        if (id > cols.watermark) {
+            // Each ID skipped on the way up may belong to a transaction not yet committed
+            auto now = chrono::steady_clock::now();
+            int from = max(cols.watermark + 1, id - static_cast<int>(PAYMENT_GAP_LIMIT));
+            for (int skipped = from; skipped < id; skipped++) cols.gaps.emplace_back(skipped, now);
+            while (cols.gaps.size() > PAYMENT_GAP_LIMIT) cols.gaps.pop_front();
+            cols.watermark = id;
+            return;
+        }
+        for (auto it = cols.gaps.begin(); it != cols.gaps.end(); ++it) {
+            if (it->first == id) {
+                cols.gaps.erase(it);
+                break;
+            }
+        }
+    }
+
+    long long probeVersion(Connection* con) {
+        PreparedStatement* pstmt = cachedStatement(con, SQL_PAYMENT_VERSION);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        return res->next() ? res->getInt64("Version") : 0;
+    }
+
+    // Stamp first: an edit landing mid-load just triggers one more reload
+    unique_ptr<PaymentColumns> loadAll(Connection* con) {
+        unique_ptr<PaymentColumns> cols(new PaymentColumns());
+        cols->version = probeVersion(con);
+        {
+            unique_ptr<Statement> stmt(con->createStatement());
+            unique_ptr<ResultSet> res(stmt->executeQuery(SQL_PAYMENT_ARCHIVED));
+            while (res->next()) {
+                ArchivedMonth& month = cols->archived[res->getInt("YM")];
+                month.payments = res->getInt64("CompleteCount");
+                month.cents = res->getInt64("Cents");
+            }
+        }
+        ResultStream stream(con, SQL_PAYMENT_LOAD);
+        while (stream.next()) append(*cols, stream.row());
+        return cols;
+    }
+
+    // Rows committed since the last look: above the watermark, or filling a recent gap
+    void catchUp(Connection* con, PaymentColumns& cols) {
+        auto expired = chrono::steady_clock::now() - chrono::seconds(PAYMENT_GAP_WAIT_S);
+        while (!cols.gaps.empty() && cols.gaps.front().second < expired) cols.gaps.pop_front();
+
+        string sql = inlineParams(SQL_PAYMENT_CATCH_UP, { to_string(cols.watermark) });
+        if (!cols.gaps.empty()) {
+            sql += " OR TransactionID IN (";
+            for (size_t i = 0; i < cols.gaps.size(); i++) sql += (i ? "," : "") + to_string(cols.gaps[i].first);
+            sql += ")";
+        }
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(sql + " ORDER BY TransactionID"));
+        while (res->next()) append(cols, *res);
+    }
+
+    // Brings g_store up to date; caller holds g_storeMutex
+    void refresh(Connection* con) {
+        subscribeOnce();
+        unsigned changes = g_changes.exchange(0);
+        if (g_store && (changes & PAYMENTS_EDITED)) g_store->version = -1;
+        try {
+            withReadRetry(con, [&]() {
+                if (g_store && g_store->version != -1 && changeFeedCurrent()) {
+                    // Every commit is reported, so only an insert needs a look
+                    if (changes & PAYMENTS_ADDED) catchUp(con, *g_store);
+                }
+                else if (g_store && probeVersion(con) == g_store->version) catchUp(con, *g_store);
+                else g_store = loadAll(con);
+                return 0;
+                });
+        }
+        catch (SQLException&) {
+            g_changes.fetch_or(changes);
+            throw;
+        }
+    }
+}
+
+// ==========================================
+// QUERIES
+// ==========================================
+
+long long loadPaymentAnalytics(sql::Connection* con) {
+    lock_guard<mutex> lock(g_storeMutex);
+    try {
+        refresh(con);
+        return static_cast<long long>(g_store->day.size());
+    }
+    catch (SQLException& e) {
+        cerr << "[Analytics] Payments not loaded; the first report will retry: " << e.what() << endl;
+        return -1;
+    }
+}
+
+std::vector<MonthlySales> completedSalesByMonth(sql::Connection* con, int year, int month, int months) {
+    vector<MonthlySales> result(max(months, 0));
+    if (months <= 0) return result;
+
+    lock_guard<mutex> lock(g_storeMutex);
+    try {
+        refresh(con);
+    }
+    catch (SQLException&) {
+        if (!g_store) throw;
+    }
+    const PaymentColumns& cols = *g_store;
+
+    const int firstMonth = year * 12 + month - 1;
+    vector<BucketStats> live(months);
+    uint8_t complete;
+    if (cols.statuses.find("Complete", complete) && complete < 32) {
+        live = bucketAggregate(monthBuckets(year, month, months), cols.day.data(), cols.status.data(),
+            cols.cents.data(), cols.day.size(), 1u << complete);
+    }
+
+    for (int m = 0; m < months; m++) {
+        int64_t total = live[m].sum;
+        result[m].payments = live[m].count;
+        auto archived = cols.archived.find(firstMonth + m);
+        if (archived != cols.archived.end()) {
+            total += archived->second.cents;
+            result[m].payments += archived->second.payments;
+        }
+        result[m].amount = Money::fromCents(total);
+    }
+    return result;
+}
+
+void bumpPaymentHistoryVersion(sql::Connection* con) {
+    {
+        // Our own change: reload here even if the bump below fails
+        lock_guard<mutex> lock(g_storeMutex);
+        if (g_store) g_store->version = -1;
+    }
+    try {
+        runWrite(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con,
+                "UPDATE table_versions SET Version = Version + 1 WHERE Name = 'payment_history'");
+            return pstmt->executeUpdate();
+            });
+    }
+    catch (SQLException& e) {
+        cerr << "[Analytics] Other terminals may report stale sales figures: " << e.what() << endl;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <mysql_connection.h>
+#include "Money.h"
+
+// ==========================================
+// PAYMENT ANALYTICS (in-memory column store)
+// ==========================================
+// The sales reports (summary, trend, growth) are answered from a copy of the
+// payment table held in memory column by column:
+//   day     int32   days since 1970-01-01
+//   cents   int64   Amount * 100
+//   status  uint8   code in a dictionary of PaymentStatus values
+//   method  uint16  code in a dictionary of Method values
+//   user    uint32  dense index in a dictionary of UserIDs
+// A report is one pass over the day, status and cents arrays, bucketed by
+// the kernels in AggregationKernels.h. The per-month archive
+// aggregates (ColdArchive.h) are loaded next to the columns, so the figures
+// match the SQL reports.
+//
+// The store is loaded once at startup, streamed (ResultStreaming.h) so the load
+// never holds the table twice. Before each report it catches up:
+//   new rows     TransactionID above the highest one loaded. IDs skipped by
+//                transactions that had not committed yet are re-asked for
+//                PAYMENT_GAP_WAIT_S seconds.
+//   edits        updatePayment, deletePayment, the archive and the benchmarks
+//                bump the 'payment_history' stamp in table_versions
+//                (migration 11). A changed stamp means a full reload.
+// While the change feed (ChangeFeed.h) is current, neither query runs until
+// it reports a change. An insert into payment catches up, and any other change
+// to payment or payment_monthly_archive reloads, hand edits included.
+// While the server is unreachable, reports use the last loaded copy.
+
+struct MonthlySales {
+    long long payments = 0;   // Complete payments, live and archived
+    Money amount;
+};
+
+// Startup load; returns the rows loaded, or -1 (reported on cerr) if the
+// server could not be read. The first report retries.
+long long loadPaymentAnalytics(sql::Connection* con);
+
+// Complete payments for `months` consecutive months starting at year/month.
+// Throws sql::SQLException only when nothing has been loaded yet.
+std::vector<MonthlySales> completedSalesByMonth(sql::Connection* con, int year, int month, int months);
+
+// Marks payment history rewritten for every client; call after a committed
+// update, delete or archive of payment rows
+void bumpPaymentHistoryVersion(sql::Connection* con);
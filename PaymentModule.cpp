@@ -1,16 +1,56 @@
 #include "PaymentModule.h"
 #include "printjob.h"
 #include "utils.h" // Assumes readInt(), clearScreen() etc. are here
+#include "OfflineJournal.h"
+#include "ResilientConnection.h"
+#include "StoredProcedures.h"
+#include "ShopRepository.h"
+#include "RowCounts.h"
+#include "ListPager.h"
+#include "Repositories.h"
+#include "Money.h"
+#include "PaymentAnalytics.h"
+#include "QueryPlanCheck.h"
 #include <iostream>
 #include <vector>
 #include <string>
 #include <iomanip>
 #include <limits>
+#include <sstream>
 #include <memory> // For unique_ptr
 
 using namespace std;
 using namespace sql;
 
+namespace {
+    const char* const SQL_PAYMENT_EXISTS = "SELECT 1 FROM payment WHERE JobID = ? LIMIT 1";
+    const char* const SQL_PAYMENT_JOB_COST = "SELECT JobCost FROM printjob WHERE JobID = ? AND UserID = ? LIMIT 1";
+    const char* const SQL_PAYMENTS_FOR_USER =
+        "SELECT TransactionID, Amount, Method, PaymentStatus, TimeStamp FROM payment WHERE UserID = ? ORDER BY TimeStamp DESC";
+    const char* const SQL_UNPAID_JOBS =
+        "SELECT JobID, PageCount, JobCost, TimeStamp "
+        "FROM printjob "
+        "WHERE UserID = ? "
+        "AND JobID NOT IN (SELECT JobID FROM payment WHERE PaymentStatus = 'Complete') "
+        "ORDER BY JobID DESC";
+    const char* const SQL_PAYMENT_LIST =
+        "SELECT p.TransactionID, p.JobID, p.Amount, p.Method, p.TimeStamp, p.PaymentStatus, "
+        "u.UserID, u.FullName "
+        "FROM payment p JOIN user u ON p.UserID = u.UserID "
+        "ORDER BY p.TimeStamp DESC";
+    const char* const SQL_PAYMENT_DETAILS = "SELECT Amount, Method, JobID FROM payment WHERE TransactionID = ?";
+    const char* const SQL_PAYMENT_UPDATE = "UPDATE payment SET Amount = ?, Method = ?, PaymentStatus = ? WHERE TransactionID = ?";
+
+    const PlanRegistration planPaymentExists("payment_exists", "PaymentModule.cpp", SQL_PAYMENT_EXISTS, { "17" });
+    const PlanRegistration planPaymentJobCost("payment_job_cost", "PaymentModule.cpp", SQL_PAYMENT_JOB_COST, { "17", "17" });
+    const PlanRegistration planPaymentsForUser("payments_for_user", "PaymentModule.cpp", SQL_PAYMENTS_FOR_USER, { "17" });
+    const PlanRegistration planUnpaidJobs("unpaid_jobs", "PaymentModule.cpp", SQL_UNPAID_JOBS, { "17" });
+    const PlanRegistration planPaymentList("payment_list", "PaymentModule.cpp", SQL_PAYMENT_LIST, {});
+    const PlanRegistration planPaymentDetails("payment_details", "PaymentModule.cpp", SQL_PAYMENT_DETAILS, { "17" });
+    const PlanRegistration planPaymentUpdate("payment_update", "PaymentModule.cpp", SQL_PAYMENT_UPDATE,
+        { "10.00", "Cash", "Complete", "17" });
+}
+
 // ==========================================
 // HELPER FUNCTIONS
 // ==========================================
@@ -18,14 +58,18 @@ using namespace sql;
 // Check if a payment record already exists for a specific JobID
 bool checkPaymentExistsForJob(sql::Connection* con, int jobID) {
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT 1 FROM payment WHERE JobID = ? LIMIT 1")
-        );
-        pstmt->setInt(1, jobID);
-        unique_ptr<ResultSet> res(pstmt->executeQuery());
-        return res->next();
+        return withReadRetry(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con, SQL_PAYMENT_EXISTS);
+            pstmt->setInt(1, jobID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        });
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline(); // Duplicate check is redone at journal replay
+            return false;
+        }
         cerr << "DB Error (Check Payment): " << e.what() << endl;
         return false;
     }
@@ -33,37 +77,42 @@ bool checkPaymentExistsForJob(sql::Connection* con, int jobID) {
 
 
 
-// Check if Job exists AND belongs to User. Returns JobCost if found, -1.0 if not.
-double getJobCostIfValid(sql::Connection* con, int jobID, int userID) {
+// Check if Job exists AND belongs to User. Sets `cost` and returns true if found.
+bool getJobCostIfValid(sql::Connection* con, int jobID, int userID, Money& cost) {
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT JobCost FROM printjob WHERE JobID = ? AND UserID = ? LIMIT 1")
-        );
-        pstmt->setInt(1, jobID);
-        pstmt->setInt(2, userID);
-        unique_ptr<ResultSet> res(pstmt->executeQuery());
-
-        if (res->next()) {
-            return res->getDouble("JobCost");
-        }
+        return withReadRetry(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con, SQL_PAYMENT_JOB_COST);
+            pstmt->setInt(1, jobID);
+            pstmt->setInt(2, userID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+
+            if (!res->next()) return false;
+            cost = getMoney(*res, "JobCost");
+            return true;
+            });
     }
     catch (SQLException& e) {
-        cerr << "DB Error (Get Job Cost): " << e.what() << endl;
+        if (isConnectionLost(e)) markDatabaseOffline();
+        else cerr << "DB Error (Get Job Cost): " << e.what() << endl;
     }
-    return -1.0; // Indicates Invalid Job or User mismatch
+    return false; // Invalid Job or User mismatch
 }
 
 // Helper to check if User exists (Generic)
 bool checkUserIDExists(sql::Connection* con, int uid) {
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT 1 FROM user WHERE UserID = ? LIMIT 1")
-        );
-        pstmt->setInt(1, uid);
-        unique_ptr<ResultSet> res(pstmt->executeQuery());
-        return res->next();
+        return withReadRetry(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con, "SELECT 1 FROM user WHERE UserID = ? LIMIT 1");
+            pstmt->setInt(1, uid);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next();
+        });
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline(); // Accept for now, replay re-validates
+            return true;
+        }
         return false;
     }
 
@@ -96,6 +145,11 @@ bool searchUsersByName1(sql::Connection* con, string nameInput) {
         return true;
     }
     catch (sql::SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline();
+            cout << "[Offline] Customer search unavailable. Enter the User ID directly.\n";
+            return true;
+        }
         cerr << "Error searching users: " << e.what() << endl;
         return false;
     }
@@ -106,7 +160,7 @@ bool listPaymentsForUser(sql::Connection* con, int userID) {
     try {
         // Query the PAYMENT table
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT TransactionID, Amount, Method, PaymentStatus, TimeStamp FROM payment WHERE UserID = ? ORDER BY TimeStamp DESC")
+            con->prepareStatement(SQL_PAYMENTS_FOR_USER)
         );
         pstmt->setInt(1, userID);
         unique_ptr<ResultSet> res(pstmt->executeQuery());
@@ -126,7 +180,7 @@ bool listPaymentsForUser(sql::Connection* con, int userID) {
 
         while (res->next()) {
             cout << left << setw(10) << res->getInt("TransactionID")
-                << "$" << setw(11) << fixed << setprecision(2) << res->getDouble("Amount")
+                << "$" << setw(11) << getMoney(*res, "Amount")
                 << setw(10) << res->getString("Method")
                 << setw(15) << res->getString("PaymentStatus")
                 << setw(25) << res->getString("TimeStamp") << endl;
@@ -165,13 +219,7 @@ bool listUnpaidJobs(sql::Connection* con, int userID) {
     try {
         // Query: Find jobs for this user that are NOT in the payment table (or not 'Complete')
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement(
-                "SELECT JobID, PageCount, JobCost, TimeStamp "
-                "FROM printjob "
-                "WHERE UserID = ? "
-                "AND JobID NOT IN (SELECT JobID FROM payment WHERE PaymentStatus = 'Complete') "
-                "ORDER BY JobID DESC"
-            )
+            con->prepareStatement(SQL_UNPAID_JOBS)
         );
         pstmt->setInt(1, userID);
         unique_ptr<ResultSet> res(pstmt->executeQuery());
@@ -189,23 +237,86 @@ bool listUnpaidJobs(sql::Connection* con, int userID) {
         while (res->next()) {
             cout << left << setw(10) << res->getInt("JobID")
                 << setw(10) << res->getInt("PageCount")
-                << fixed << setprecision(2) << setw(12) << res->getDouble("JobCost")
+                << setw(12) << getMoney(*res, "JobCost")
                 << setw(25) << res->getString("TimeStamp") << endl;
         }
         cout << "--------------------------------------------------------\n";
         return true;
     }
     catch (sql::SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline();
+            cout << "[Offline] Unpaid job list unavailable.\n";
+            return false;
+        }
         cerr << "Error listing unpaid jobs: " << e.what() << endl;
         return false;
     }
 }
 
 
+// The payment rules on any backend: the amount must be positive, the job must belong
+// to the user and be unpaid, and the amount against JobCost decides the status
+string takePayment(PrintJobRepo& jobs, PaymentRepo& payments, int userID, int jobID, Money amount,
+    const string& method, const string& timeStamp, int& transactionID, string& reason) {
+    if (amount <= Money()) {
+        reason = "Amount must be positive.";
+        return "";
+    }
+    Money jobCost;
+    if (!jobs.jobCost(jobID, userID, jobCost)) {
+        reason = "Job " + to_string(jobID) + " not found for User " + to_string(userID) + ".";
+        return "";
+    }
+    if (payments.isPaid(jobID)) {
+        reason = "Job " + to_string(jobID) + " already has a payment.";
+        return "";
+    }
+
+    PaymentRecord payment;
+    payment.userID = userID;
+    payment.jobID = jobID;
+    payment.amount = amount;
+    payment.method = method;
+    payment.status = (amount >= jobCost) ? "Complete" : "Insufficient";
+    payment.timeStamp = timeStamp;
+    transactionID = payments.addPayment(payment);
+    return payment.status;
+}
+
+// Core insert shared by the journal replay and server mode (no console I/O)
+string insertPaymentRecord(sql::Connection* con, int userID, int jobID, Money amount,
+    const string& method, const string& timeStamp, string& reason) {
+    unique_ptr<Repositories> repos = makeMySqlRepositories(con);
+    int transactionID = 0;
+    // The job row stays locked from the duplicate check to the insert only inside a
+    // transaction; the journal replay brings its own, server mode gets one here
+    if (!con->getAutoCommit()) {
+        return takePayment(*repos, *repos, userID, jobID, amount, method, timeStamp, transactionID, reason);
+    }
+    try {
+        con->setAutoCommit(false);
+        string status = takePayment(*repos, *repos, userID, jobID, amount, method, timeStamp, transactionID, reason);
+        if (status.empty()) con->rollback();
+        else con->commit();
+        con->setAutoCommit(true);
+        return status;
+    }
+    catch (SQLException&) {
+        try {
+            con->rollback();
+            con->setAutoCommit(true);
+        }
+        catch (SQLException&) {}
+        throw;
+    }
+}
+
 // PaymentModule.cpp
 
 void createPayment(sql::Connection* con) {
     cout << "\n--- Create New Payment ---\n";
+    syncJournalIfPending(con);
 
     int uid = readInt("Enter User ID (UID): ");
     if (!checkUserIDExists(con, uid)) {
@@ -218,71 +329,101 @@ void createPayment(sql::Connection* con) {
     
 
     int jid = readInt("Enter Job ID (JID): ");
-    if (checkPaymentExistsForJob(con, jid)) {
+
+    // Duplicate check and job cost are independent; the repository may send them together
+    PaymentCheck check;
+    try {
+        check = makeShopRepository(con)->checkPayment(uid, jid);
+    }
+    catch (SQLException& e) {
+        if (!isConnectionLost(e)) {
+            cerr << "DB Error (Check Payment): " << e.what() << endl;
+            return;
+        }
+        markDatabaseOffline(); // Duplicate check is redone at journal replay
+    }
+    catch (exception& e) {
+        cerr << "DB Error (Check Payment): " << e.what() << endl;
+        return;
+    }
+    if (check.alreadyPaid) {
         cout << "[Error] A payment record already exists for Job ID " << jid << ".\n";
         return;
     }
 
-    double jobCost = getJobCostIfValid(con, jid, uid);
-    if (jobCost < 0) {
+    if (!isDatabaseOnline()) {
+        // Offline: take the payment now, status is decided against JobCost at replay
+        Money amount = readPositiveMoney("[Offline] Job cost unavailable. Enter Payment Amount: ");
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        string method;
+        cout << "Enter Payment Method (e.g., Cash, Card): ";
+        getline(cin, method);
+        string key = journalPayment(uid, jid, amount, method);
+        cout << "[Offline] Payment saved to the local journal (" << key << ").\n";
+        return;
+    }
+    if (!check.jobFound) {
         cout << "[Error] Invalid Job ID or Job does not belong to User " << uid << ".\n";
         return;
     }
 
-    cout << "Total Job Cost: $" << fixed << setprecision(2) << jobCost << endl;
-    double amount = 0;
-    cout << "Enter Payment Amount: ";
-    cin >> amount;
+    Money jobCost = check.jobCost;
+    cout << "Total Job Cost: $" << jobCost << endl;
+    Money amount = readPositiveMoney("Enter Payment Amount: ");
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
     string method;
     cout << "Enter Payment Method (e.g., Cash, Card): ";
     getline(cin, method);
-    double balance = amount - jobCost;
-    std::cout << ">>> Payment Accepted. Change Due: $" << fixed << setprecision(2) << balance << endl;
-    // Business Logic: Determine status based on cost
-    string status = (amount >= jobCost) ? "Complete" : "Insufficient";
+    Money balance = amount - jobCost;
+    std::cout << ">>> Payment Accepted. Change Due: $" << balance << endl;
 
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("INSERT INTO payment (UserID, JobID, Amount, Method, PaymentStatus) VALUES (?, ?, ?, ?, ?)")
-        );
-        pstmt->setInt(1, uid);
-        pstmt->setInt(2, jid);
-        pstmt->setDouble(3, amount);
-        pstmt->setString(4, method);
-        pstmt->setString(5, status);
-
-        pstmt->executeUpdate();
-        cout << "[Success] Payment recorded. Status: " << status << "\n";
+        // Re-validated and inserted atomically, so another terminal cannot pay the job in between;
+        // the procedure decides the status against JobCost
+        int transactionID = 0;
+        string error;
+        string status = runWrite(con, [&]() {
+            return callCreatePayment(con, uid, jid, amount, method, transactionID, error);
+            });
+        if (status.empty()) {
+            cout << "[Error] " << error << "\n";
+            return;
+        }
+        cout << "[Success] Payment recorded (TransactionID " << transactionID << "). Status: " << status << "\n";
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            string key = journalPayment(uid, jid, amount, method);
+            cout << "[Offline] Payment saved to the local journal (" << key << ").\n";
+            return;
+        }
         cerr << "SQL Error (Insert Payment): " << e.what() << endl;
     }
 }
 
 void readAllPayments(sql::Connection* con) {
     try {
-        // 1. Get 64-bit Total Count for the header
-        std::unique_ptr<sql::Statement> countStmt(con->createStatement());
-        std::unique_ptr<sql::ResultSet> countRes(countStmt->executeQuery("SELECT COUNT(*) FROM payment"));
-        long long totalPayments = 0;
-        if (countRes->next()) totalPayments = countRes->getInt64(1);
-
-        // 2. Stream all results (Most recent first)
-        std::unique_ptr<sql::Statement> stmt(con->createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(
-            "SELECT p.TransactionID, p.JobID, p.Amount, p.Method, p.TimeStamp, p.PaymentStatus, "
-            "u.UserID, u.FullName "
-            "FROM payment p JOIN user u ON p.UserID = u.UserID "
-            "ORDER BY p.TimeStamp DESC"
-        ));
+        // 1. Get 64-bit Total Count for the header (maintained counter, no table scan)
+        long long totalPayments = rowCount(con, "payment");
 
         const int TRANS_ID_W = 8, USER_ID_W = 8, NAME_W = 22, JOB_ID_W = 8, AMOUNT_W = 12, STATUS_W = 14, DATE_W = 12;
         const int TOTAL_WIDTH = TRANS_ID_W + USER_ID_W + NAME_W + JOB_ID_W + AMOUNT_W + STATUS_W + DATE_W + 8;
-
-        int rowCount = 0;
-        int pageSize = 20;
+        const int pageSize = 20;
+
+        // 2. Stream all results (Most recent first); the next page is decoded while this one is read
+        ListPager pager(con, SQL_PAYMENT_LIST,
+            pageSize, [&](sql::ResultSet& res) {
+                std::ostringstream line;
+                line << "| " << left << setw(TRANS_ID_W - 2) << res.getInt("TransactionID")
+                    << "| " << setw(USER_ID_W - 2) << res.getInt("UserID")
+                    << "| " << setw(NAME_W - 2) << res.getString("FullName").substr(0, 18)
+                    << "| " << setw(JOB_ID_W - 2) << res.getInt("JobID")
+                    << "| $" << setw(AMOUNT_W - 3) << getMoney(res, "Amount")
+                    << "| " << setw(STATUS_W - 2) << res.getString("PaymentStatus")
+                    << "| " << res.getString("TimeStamp").substr(0, 10) << " |";
+                return line.str();
+            }, StreamSource::ReplicaFirst);
 
         auto printHeader = [&]() {
             std::cout << "\n--- All Payments (" << totalPayments << " records) ---\n";
@@ -294,39 +435,7 @@ void readAllPayments(sql::Connection* con) {
             std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
             };
 
-        printHeader();
-
-        while (res->next()) {
-            std::cout << "| " << left << setw(TRANS_ID_W - 2) << res->getInt("TransactionID")
-                << "| " << setw(USER_ID_W - 2) << res->getInt("UserID")
-                << "| " << setw(NAME_W - 2) << res->getString("FullName").substr(0, 18)
-                << "| " << setw(JOB_ID_W - 2) << res->getInt("JobID")
-                << "| $" << setw(AMOUNT_W - 3) << fixed << setprecision(2) << res->getDouble("Amount")
-                << "| " << setw(STATUS_W - 2) << res->getString("PaymentStatus")
-                << "| " << res->getString("TimeStamp").substr(0, 10) << " |" << endl;
-
-            rowCount++;
-
-            // Pagination Trigger
-            if (rowCount % pageSize == 0 && rowCount < totalPayments) {
-                std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
-                std::cout << ">>> [" << rowCount << "/" << totalPayments << "] [Enter] more, 'c' clear, 's' stop: ";
-
-                std::string input;
-                std::getline(std::cin, input); // No 'ws' here so Enter alone works
-
-                if (!input.empty() && std::tolower(input[0]) == 's') break;
-                if (!input.empty() && std::tolower(input[0]) == 'c') {
-#ifdef _WIN32
-                    system("cls");
-#else
-                    system("clear");
-#endif
-                }
-                printHeader();
-            }
-        }
-        std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
+        browsePages(pager, totalPayments, pageSize, printHeader, "+" + std::string(TOTAL_WIDTH - 2, '-') + "+");
 
     }
     catch (sql::SQLException& e) {
@@ -348,7 +457,7 @@ void updatePayment(sql::Connection* con) {
     try {
         // 1. Fetch current data
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT Amount, Method, JobID FROM payment WHERE TransactionID = ?")
+            con->prepareStatement(SQL_PAYMENT_DETAILS)
         );
         pstmt->setInt(1, transID);
         unique_ptr<ResultSet> res(pstmt->executeQuery());
@@ -358,12 +467,12 @@ void updatePayment(sql::Connection* con) {
             return;
         }
 
-        double currentAmount = res->getDouble("Amount");
+        Money currentAmount = getMoney(*res, "Amount");
         string currentMethod = res->getString("Method");
         int jobID = res->getInt("JobID");
 
         // 2. Get New Values
-        double newAmount;
+        Money newAmount;
         string newMethod;
         char choice;
         bool changed = false;
@@ -371,8 +480,7 @@ void updatePayment(sql::Connection* con) {
         cout << "Current Amount: " << currentAmount << ". Update? (y/n): ";
         cin >> choice;
         if (choice == 'y' || choice == 'Y') {
-            cout << "Enter New Amount: ";
-            cin >> newAmount;
+            newAmount = readPositiveMoney("Enter New Amount: ");
             changed = true;
         }
         else {
@@ -408,7 +516,7 @@ void updatePayment(sql::Connection* con) {
         unique_ptr<ResultSet> jobRes(jobStmt->executeQuery());
 
         if (jobRes->next()) {
-            double jobCost = jobRes->getDouble("JobCost");
+            Money jobCost = getMoney(*jobRes, "JobCost");
             if (newAmount >= jobCost) {
                 newPaymentStatus = "Complete";
             }
@@ -416,20 +524,23 @@ void updatePayment(sql::Connection* con) {
 
         // 4. Update Database
         unique_ptr<PreparedStatement> updateStmt(
-            con->prepareStatement(
-                "UPDATE payment SET Amount = ?, Method = ?, PaymentStatus = ? WHERE TransactionID = ?"
-            )
+            con->prepareStatement(SQL_PAYMENT_UPDATE)
         );
-        updateStmt->setDouble(1, newAmount);
+        updateStmt->setString(1, newAmount.toString());
         updateStmt->setString(2, newMethod);
         updateStmt->setString(3, newPaymentStatus);
         updateStmt->setInt(4, transID);
 
-        updateStmt->executeUpdate();
+        runWrite(con, [&]() { return updateStmt->executeUpdate(); });
+        bumpPaymentHistoryVersion(con);
         cout << "[Success] Payment updated. New PaymentStatus: " << newPaymentStatus << "\n";
 
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            cerr << "[Error] Connection lost - payment NOT updated. Please retry." << endl;
+            return;
+        }
         cerr << "[Error] SQL Error: " << e.what() << endl;
     }
 }
@@ -445,8 +556,9 @@ void deletePayment(sql::Connection* con) {
         );
         pstmt->setInt(1, transID);
 
-        int rows = pstmt->executeUpdate();
+        int rows = runWrite(con, [&]() { return pstmt->executeUpdate(); });
         if (rows > 0) {
+            bumpPaymentHistoryVersion(con);
             cout << "[Success] TransactionID Deleted.\n";
         }
         else {
@@ -454,6 +566,10 @@ void deletePayment(sql::Connection* con) {
         }
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            cerr << "[Error] Connection lost - payment NOT deleted. Please retry." << endl;
+            return;
+        }
         cerr << "[Error] SQL Error: " << e.what() << endl;
     }
 }
@@ -475,7 +591,7 @@ void searchPayment(sql::Connection* con) {
             cout << "Transaction ID : " << res->getInt("TransactionID") << "\n";
             cout << "User ID        : " << res->getInt("UserID") << "\n";
             cout << "Job ID         : " << res->getInt("JobID") << "\n";
-            cout << "Amount         : " << fixed << setprecision(2) << res->getDouble("Amount") << "\n";
+            cout << "Amount         : " << getMoney(*res, "Amount") << "\n";
             cout << "Method         : " << res->getString("Method") << "\n";
             cout << "Timestamp      : " << res->getString("TimeStamp") << "\n";
             cout << "PaymentStatus         : " << res->getString("PaymentStatus") << "\n";
@@ -7,6 +7,7 @@
 #include <cppconn/statement.h>
 #include <cppconn/prepared_statement.h>
 #include <string>
+#include "Repositories.h"
 
 // ==========================================
 // FUNCTION DECLARATIONS
@@ -21,9 +22,23 @@ void updatePayment(sql::Connection* con);
 void deletePayment(sql::Connection* con);
 void searchPayment(sql::Connection* con);
 
+// Payment rules on any backend (Repositories.h): the amount must be positive and the
+// job must belong to the user and be unpaid; status is Complete when amount covers JobCost, else Insufficient.
+// Returns the status written, or "" with `reason` set. Empty timeStamp means now.
+std::string takePayment(PrintJobRepo& jobs, PaymentRepo& payments, int userID, int jobID, Money amount,
+    const std::string& method, const std::string& timeStamp, int& transactionID, std::string& reason);
+
+// takePayment on the MySQL backend: validates and inserts one payment. No output;
+// empty timeStamp means NOW(). Joins the caller's transaction, or runs in one of
+// its own when autocommit is on. The job row is locked from the duplicate check
+// to the insert, as sp_create_payment does. Returns the PaymentStatus written, or
+// "" with `reason` set when rejected. Throws sql::SQLException.
+std::string insertPaymentRecord(sql::Connection* con, int userID, int jobID, Money amount,
+    const std::string& method, const std::string& timeStamp, std::string& reason);
+
 // Helper / Validation Functions
 bool checkPaymentExistsForJob(sql::Connection* con, int jobID);
-double getJobCostIfValid(sql::Connection* con, int jobID);
+bool getJobCostIfValid(sql::Connection* con, int jobID, int userID, Money& cost);
 int readCustomers(sql::Connection* con);
 // Display / Utility Function
 void readAllPayments(sql::Connection* con);
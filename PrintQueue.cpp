@@ -0,0 +1,325 @@
+#include "PrintQueue.h"
+#include "db.h"                  // getConfigInt()
+#include "ResilientConnection.h" // runWrite(), withReadRetry()
+#include "QueryPlanCheck.h"
+#include <iostream>
+#include <sstream>
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+namespace {
+    const char* const SQL_QUEUE_LOAD =
+        "SELECT JobID, PageCount, Priority FROM printjob "
+        "WHERE Status = 'Queued' ORDER BY Priority DESC, JobID ASC";
+    const PlanRegistration planQueueLoad("queue_load", "PrintQueue.cpp", SQL_QUEUE_LOAD, {});
+
+    string joinIDs(const vector<int>& ids) {
+        ostringstream oss;
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (i > 0) oss << ",";
+            oss << ids[i];
+        }
+        return oss.str();
+    }
+}
+
+// ==========================================
+// QUEUE
+// ==========================================
+
+PrintQueue::PrintQueue(ConnectionPool& pool, int printerCount, double pagesPerMinute, double timeScale)
+    : pool_(pool),
+    printerCount_(printerCount > 0 ? printerCount : 1),
+    pagesPerMinute_(pagesPerMinute > 0 ? pagesPerMinute : 30.0),
+    timeScale_(timeScale > 0 ? timeScale : 1.0) {
+}
+
+PrintQueue::~PrintQueue() {
+    stop(false);
+}
+
+int PrintQueue::loadPending() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        following_ = true;
+    }
+    {
+        ConnectionPool::Lease lease = pool_.acquire();
+        if (!lease) return 0;
+        Connection* con = lease.get();
+        try {
+            // A crash mid-print leaves rows in Printing; they go back in line
+            runWrite(con, [&]() {
+                unique_ptr<Statement> stmt(con->createStatement());
+                return stmt->executeUpdate("UPDATE printjob SET Status = 'Queued', StartedAt = NULL WHERE Status = 'Printing'");
+                });
+        }
+        catch (SQLException& e) {
+            cerr << "[Queue] Could not requeue interrupted jobs: " << e.what() << endl;
+        }
+    }
+    return pickUpQueued(true);
+}
+
+int PrintQueue::pickUpQueued(bool reportErrors) {
+    ConnectionPool::Lease lease = pool_.acquire();
+    if (!lease) return 0;
+    Connection* con = lease.get();
+
+    struct Row { int jobID; int pageCount; int priority; };
+    vector<Row> rows;
+    try {
+        rows = withReadRetry(con, [&]() {
+            vector<Row> loaded;
+            unique_ptr<Statement> stmt(con->createStatement());
+            unique_ptr<ResultSet> res(stmt->executeQuery(SQL_QUEUE_LOAD));
+            while (res->next()) {
+                loaded.push_back({ res->getInt("JobID"), res->getInt("PageCount"), res->getInt("Priority") });
+            }
+            return loaded;
+            });
+    }
+    catch (SQLException& e) {
+        if (reportErrors) cerr << "[Queue] Could not load pending jobs: " << e.what() << endl;
+        return 0;
+    }
+
+    vector<Row> fresh;
+    {
+        lock_guard<mutex> lock(mutex_);
+        set<int> stillQueued;
+        for (const Row& row : rows) stillQueued.insert(row.jobID);
+        // A withdrawn job whose row is gone will not come back
+        for (auto it = withdrawn_.begin(); it != withdrawn_.end();) {
+            if (stillQueued.count(*it)) {
+                ++it;
+                continue;
+            }
+            owned_.erase(*it);
+            it = withdrawn_.erase(it);
+        }
+        for (const Row& row : rows) {
+            if (!owned_.count(row.jobID)) fresh.push_back(row);
+        }
+    }
+    lease = ConnectionPool::Lease();
+
+    for (const Row& row : fresh) submit(row.jobID, row.pageCount, row.priority);
+    return static_cast<int>(fresh.size());
+}
+
+void PrintQueue::submit(int jobID, int pageCount, int priority) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (jobID > 0) {
+            // Withdrawn but still in line: clearing the mark puts it back
+            if (cancelled_.erase(jobID)) {
+                waitingIDs_.insert(jobID);
+                return;
+            }
+            if (!owned_.insert(jobID).second && !withdrawn_.erase(jobID)) return; // in line or printing
+        }
+        QueuedJob job;
+        job.jobID = jobID;
+        job.pageCount = pageCount;
+        job.priority = priority;
+        job.sequence = nextSequence_++;
+        job.enqueuedAt = chrono::steady_clock::now();
+        pending_.push(job);
+        if (jobID > 0) waitingIDs_.insert(jobID);
+    }
+    workAvailable_.notify_one();
+}
+
+bool PrintQueue::cancel(int jobID) {
+    lock_guard<mutex> lock(mutex_);
+    if (waitingIDs_.erase(jobID) == 0) return false;
+    cancelled_.insert(jobID);
+    return true;
+}
+
+void PrintQueue::onComplete(CompletionCallback callback) {
+    lock_guard<mutex> lock(mutex_);
+    callbacks_.push_back(callback);
+}
+
+void PrintQueue::start() {
+    lock_guard<mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    draining_ = false;
+    startedAt_ = chrono::steady_clock::now();
+    for (int i = 0; i < printerCount_; i++) {
+        printers_.emplace_back(&PrintQueue::printerLoop, this, i + 1);
+    }
+    flusher_ = thread(&PrintQueue::flusherLoop, this);
+}
+
+void PrintQueue::stop(bool drain) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (!running_) return;
+        if (drain) draining_ = true;
+        else running_ = false;
+    }
+    workAvailable_.notify_all();
+    for (auto& printer : printers_) printer.join();
+    printers_.clear();
+
+    {
+        lock_guard<mutex> lock(mutex_);
+        running_ = false;
+        draining_ = false;
+    }
+    flushWanted_.notify_all();
+    if (flusher_.joinable()) flusher_.join();
+    flushStatus(); // whatever finished after the flusher's last pass
+}
+
+bool PrintQueue::isIdle() {
+    lock_guard<mutex> lock(mutex_);
+    return pending_.empty() && printing_ == 0;
+}
+
+QueueMetrics PrintQueue::metrics() {
+    lock_guard<mutex> lock(mutex_);
+    QueueMetrics m;
+    m.depth = pending_.size() - cancelled_.size();
+    m.printing = printing_;
+    m.completed = completed_;
+    m.pagesPrinted = pagesPrinted_;
+    // Reported in simulated time so results read as real printer minutes
+    long long picked = completed_ + printing_;
+    m.avgWaitMs = picked > 0 ? (totalWaitMs_ / picked) * timeScale_ : 0.0;
+    m.maxWaitMs = maxWaitMs_ * timeScale_;
+    if (running_ || completed_ > 0) {
+        m.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startedAt_).count() * timeScale_;
+    }
+    return m;
+}
+
+// ==========================================
+// WORKERS
+// ==========================================
+
+void PrintQueue::printerLoop(int printerID) {
+    const size_t flushBatch = static_cast<size_t>(getConfigInt("QUEUE_FLUSH_BATCH", 50));
+
+    for (;;) {
+        QueuedJob job;
+        {
+            unique_lock<mutex> lock(mutex_);
+            workAvailable_.wait(lock, [&]() { return !running_ || draining_ || !pending_.empty(); });
+            if (!running_) return;
+            if (pending_.empty()) return; // draining and nothing left
+
+            job = pending_.top();
+            pending_.pop();
+            if (job.jobID > 0) {
+                if (cancelled_.erase(job.jobID)) {
+                    withdrawn_.insert(job.jobID);
+                    continue;
+                }
+                waitingIDs_.erase(job.jobID);
+            }
+            double waitMs = chrono::duration<double, milli>(chrono::steady_clock::now() - job.enqueuedAt).count();
+            totalWaitMs_ += waitMs;
+            if (waitMs > maxWaitMs_) maxWaitMs_ = waitMs;
+            printing_++;
+            if (job.jobID > 0) started_.push_back(job.jobID);
+        }
+
+        // Simulated print time: pages at the printer's rated speed
+        double printMs = (job.pageCount / pagesPerMinute_) * 60000.0 / timeScale_;
+        this_thread::sleep_for(chrono::microseconds(static_cast<long long>(printMs * 1000.0)));
+
+        vector<CompletionCallback> callbacks;
+        {
+            lock_guard<mutex> lock(mutex_);
+            printing_--;
+            completed_++;
+            pagesPrinted_ += job.pageCount;
+            if (job.jobID > 0) finished_.push_back(job.jobID);
+            if (finished_.size() >= flushBatch) flushWanted_.notify_one();
+            callbacks = callbacks_;
+        }
+        for (auto& callback : callbacks) callback(job, printerID);
+    }
+}
+
+void PrintQueue::flusherLoop() {
+    const int intervalMs = getConfigInt("QUEUE_FLUSH_MS", 500);
+    const size_t flushBatch = static_cast<size_t>(getConfigInt("QUEUE_FLUSH_BATCH", 50));
+    const int pollMs = getConfigInt("QUEUE_POLL_MS", 2000);
+    auto nextPoll = chrono::steady_clock::now() + chrono::milliseconds(pollMs);
+
+    unique_lock<mutex> lock(mutex_);
+    while (running_) {
+        flushWanted_.wait_for(lock, chrono::milliseconds(intervalMs),
+            [&]() { return !running_ || finished_.size() >= flushBatch; });
+        const auto now = chrono::steady_clock::now();
+        const bool pollDue = following_ && pollMs > 0 && now >= nextPoll;
+        lock.unlock();
+        flushStatus();
+        if (pollDue) {
+            pickUpQueued(false); // a failed poll is simply retried on the next one
+            nextPoll = now + chrono::milliseconds(pollMs);
+        }
+        lock.lock();
+    }
+}
+
+void PrintQueue::flushStatus() {
+    vector<int> started, finished;
+    {
+        lock_guard<mutex> lock(mutex_);
+        started.swap(started_);
+        finished.swap(finished_);
+    }
+    if (started.empty() && finished.empty()) return;
+
+    // One transaction per batch: a Printing and a Done UPDATE over ID lists
+    ConnectionPool::Lease lease = pool_.acquire();
+    try {
+        if (!lease) throw SQLException("Database unavailable");
+        Connection* con = lease.get();
+        runWrite(con, [&]() {
+            unique_ptr<Statement> stmt(con->createStatement());
+            con->setAutoCommit(false);
+            if (!started.empty()) {
+                stmt->executeUpdate("UPDATE printjob SET Status = 'Printing', StartedAt = NOW() "
+                    "WHERE Status = 'Queued' AND JobID IN (" + joinIDs(started) + ")");
+            }
+            if (!finished.empty()) {
+                stmt->executeUpdate("UPDATE printjob SET Status = 'Done', CompletedAt = NOW(), "
+                    "StartedAt = IFNULL(StartedAt, NOW()) WHERE JobID IN (" + joinIDs(finished) + ")");
+            }
+            con->commit();
+            con->setAutoCommit(true);
+            });
+
+        // Done in the table: a later poll will not see these rows as Queued
+        lock_guard<mutex> lock(mutex_);
+        for (int jobID : finished) owned_.erase(jobID);
+    }
+    catch (SQLException& e) {
+        if (lease) {
+            try {
+                lease.get()->rollback();
+                lease.get()->setAutoCommit(true);
+            }
+            catch (SQLException&) {}
+        }
+        cerr << "[Queue] Status flush deferred: " << e.what() << endl;
+
+        // Keep the transitions for the next pass
+        lock_guard<mutex> lock(mutex_);
+        started_.insert(started_.begin(), started.begin(), started.end());
+        finished_.insert(finished_.begin(), finished.begin(), finished.end());
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mysql_connection.h>
+#include "ConnectionPool.h"
+
+// ==========================================
+// PRINT JOB QUEUE & PRINTER SCHEDULER
+// ==========================================
+// Lifecycle of a printjob row: Queued -> Printing -> Done (printjob.Status,
+// added by schema migration 2).
+// The queue lives in memory (highest Priority first, then oldest) and is seeded
+// from the table, so a restart picks up where the last run stopped. Once
+// seeded, it also picks up Queued rows other sessions write (a journal replay
+// on a console terminal, say) every QUEUE_POLL_MS. N simulated printers pull
+// from it; start/finish transitions are buffered and written back in batches by
+// a flusher thread (QUEUE_FLUSH_MS / QUEUE_FLUSH_BATCH).
+
+struct QueuedJob {
+    int jobID = 0;       // <= 0 for synthetic load-test jobs (never written back)
+    int pageCount = 0;
+    int priority = 0;    // higher prints first
+    long long sequence = 0;
+    std::chrono::steady_clock::time_point enqueuedAt;
+};
+
+struct QueueMetrics {
+    size_t depth = 0;         // waiting, not yet on a printer
+    int printing = 0;
+    long long completed = 0;
+    long long pagesPrinted = 0;
+    double avgWaitMs = 0.0;   // queued -> picked up by a printer
+    double maxWaitMs = 0.0;
+    double elapsedSeconds = 0.0;
+};
+
+class PrintQueue {
+public:
+    typedef std::function<void(const QueuedJob&, int printerID)> CompletionCallback;
+
+    // timeScale > 1 speeds up simulated printing (60 = one minute per second)
+    PrintQueue(ConnectionPool& pool, int printerCount, double pagesPerMinute, double timeScale = 1.0);
+    ~PrintQueue();
+    PrintQueue(const PrintQueue&) = delete;
+    PrintQueue& operator=(const PrintQueue&) = delete;
+
+    // Seeds the queue with Queued/Printing rows and keeps following the table;
+    // returns how many were loaded
+    int loadPending();
+
+    // A job already in line or printing is not added twice
+    void submit(int jobID, int pageCount, int priority = 0);
+    // Withdraws a job that no printer has picked up yet; false once it is printing
+    bool cancel(int jobID);
+    void onComplete(CompletionCallback callback);
+
+    void start();
+    // Stops the printers (after draining the queue if asked) and flushes pending status writes
+    void stop(bool drain);
+    bool isIdle();
+
+    QueueMetrics metrics();
+    int printerCount() const { return printerCount_; }
+
+private:
+    struct Order {
+        bool operator()(const QueuedJob& a, const QueuedJob& b) const {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    void printerLoop(int printerID);
+    void flusherLoop();
+    void flushStatus();
+    int pickUpQueued(bool reportErrors); // submits Queued rows not in owned_
+
+    ConnectionPool& pool_;
+    int printerCount_;
+    double pagesPerMinute_;
+    double timeScale_;
+
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable flushWanted_;
+    std::priority_queue<QueuedJob, std::vector<QueuedJob>, Order> pending_;
+    std::set<int> waitingIDs_;  // real jobs still in pending_
+    std::set<int> cancelled_;   // withdrawn, skipped when they reach the top
+    std::set<int> withdrawn_;   // cancelled and dropped from pending_; their rows are being deleted
+    std::set<int> owned_;       // real jobs submitted and not yet flushed as Done
+    bool following_ = false;    // poll the table for Queued rows (set by loadPending)
+    std::vector<int> started_;
+    std::vector<int> finished_;
+    std::vector<CompletionCallback> callbacks_;
+    long long nextSequence_ = 0;
+    bool running_ = false;
+    bool draining_ = false;
+
+    // Metrics (guarded by mutex_)
+    int printing_ = 0;
+    long long completed_ = 0;
+    long long pagesPrinted_ = 0;
+    double totalWaitMs_ = 0.0;
+    double maxWaitMs_ = 0.0;
+    std::chrono::steady_clock::time_point startedAt_;
+
+    std::vector<std::thread> printers_;
+    std::thread flusher_;
+};
@@ -0,0 +1,396 @@
+#include "QueryPlanCheck.h"
+#include "CustomerDirectory.h"
+#include "SchemaMigrations.h"
+#include "ResilientConnection.h"
+#include "ResultStreaming.h" // inlineParams()
+#include "db.h"
+#include "utils.h"
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <map>
+#include <set>
+#include <memory>
+#include <random>
+#include <cctype>
+#include <cstring>
+#include <cppconn/statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// STATEMENT REGISTRY
+// ==========================================
+
+namespace {
+    vector<PlannedQuery>& registry() {
+        static vector<PlannedQuery> queries;
+        return queries;
+    }
+}
+
+PlanRegistration::PlanRegistration(const char* name, const char* source, const char* sql, std::vector<std::string> params) {
+    registry().push_back({ name, source, sql, move(params) });
+}
+
+// Registrations run during static initialisation, so the list is complete by main()
+const std::vector<PlannedQuery>& plannedQueries() {
+    static const vector<PlannedQuery> queries = []() {
+        vector<PlannedQuery> sorted = registry();
+        sort(sorted.begin(), sorted.end(),
+            [](const PlannedQuery& a, const PlannedQuery& b) { return strcmp(a.name, b.name) < 0; });
+        return sorted;
+    }();
+    return queries;
+}
+
+// ==========================================
+// EXPLAIN
+// ==========================================
+
+namespace {
+    // Best to worst, as MySQL documents them
+    const char* const ACCESS_TYPES[] = {
+        "system", "const", "eq_ref", "ref", "fulltext", "ref_or_null", "index_merge",
+        "unique_subquery", "index_subquery", "range", "index", "ALL"
+    };
+
+    // -1 = unknown (not compared)
+    int accessRank(const string& accessType) {
+        for (size_t i = 0; i < sizeof(ACCESS_TYPES) / sizeof(ACCESS_TYPES[0]); ++i) {
+            if (accessType == ACCESS_TYPES[i]) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Growth below this many rows is noise whatever the percentage
+    const long long ROWS_SLACK = 10;
+
+    // Value of "field" in json[from, end) as text, "" if absent
+    string jsonField(const string& json, const string& field, size_t from, size_t end) {
+        const string needle = "\"" + field + "\"";
+        size_t pos = json.find(needle, from);
+        if (pos == string::npos || pos >= end) return "";
+        pos = json.find(':', pos + needle.size());
+        if (pos == string::npos || pos >= end) return "";
+        ++pos;
+        while (pos < end && isspace(static_cast<unsigned char>(json[pos]))) ++pos;
+        if (pos < end && json[pos] == '"') {
+            size_t close = json.find('"', pos + 1);
+            return close == string::npos ? "" : json.substr(pos + 1, close - pos - 1);
+        }
+        size_t stop = pos;
+        while (stop < end && (isdigit(static_cast<unsigned char>(json[stop])) || json[stop] == '.')) ++stop;
+        return json.substr(pos, stop - pos);
+    }
+
+    // Each "table" object starts with its table_name; its fields run to the next one
+    vector<TablePlan> parsePlan(const string& json) {
+        vector<TablePlan> tables;
+        const string marker = "\"table_name\"";
+        size_t pos = json.find(marker);
+        while (pos != string::npos) {
+            size_t next = json.find(marker, pos + marker.size());
+            size_t end = next == string::npos ? json.size() : next;
+
+            TablePlan plan;
+            plan.table = jsonField(json, "table_name", pos, end);
+            plan.accessType = jsonField(json, "access_type", pos, end);
+            plan.key = jsonField(json, "key", pos, end);
+            string rows = jsonField(json, "rows_examined_per_scan", pos, end);
+            plan.rows = rows.empty() ? 0 : stoll(rows);
+            tables.push_back(plan);
+
+            pos = next;
+        }
+        return tables;
+    }
+
+    // Baseline key: query, table alias and its occurrence (a table can appear twice)
+    typedef map<string, TablePlan> PlanMap;
+
+    PlanMap keyed(const string& queryName, const vector<TablePlan>& tables) {
+        PlanMap byKey;
+        map<string, int> seen;
+        for (const TablePlan& t : tables) {
+            byKey[queryName + "\t" + t.table + "#" + to_string(seen[t.table]++)] = t;
+        }
+        return byKey;
+    }
+
+    bool loadBaseline(const string& path, PlanMap& baseline) {
+        ifstream in(path);
+        if (!in) return false;
+        string line;
+        while (getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            vector<string> fields;
+            stringstream ss(line);
+            string field;
+            while (getline(ss, field, '\t')) fields.push_back(field);
+            if (fields.size() != 5) continue;
+
+            TablePlan plan;
+            size_t hash = fields[1].rfind('#');
+            plan.table = fields[1].substr(0, hash);
+            plan.accessType = fields[2];
+            plan.key = fields[3] == "-" ? "" : fields[3];
+            plan.rows = stoll(fields[4]);
+            baseline[fields[0] + "\t" + fields[1]] = plan;
+        }
+        return true;
+    }
+
+    string describe(const TablePlan& plan) {
+        return plan.accessType + "(" + (plan.key.empty() ? "-" : plan.key) + ") " + to_string(plan.rows);
+    }
+
+    string baselinePath() {
+        return getConfigValue("PLAN_BASELINE_FILE", "query_plans.baseline");
+    }
+}
+
+std::vector<TablePlan> explainQuery(sql::Connection* con, const PlannedQuery& query) {
+    unique_ptr<Statement> stmt(con->createStatement());
+    // EXPLAIN cannot take placeholders, so the samples are inlined as quoted literals
+    unique_ptr<ResultSet> res(stmt->executeQuery("EXPLAIN FORMAT=JSON " + inlineParams(query.sql, query.params)));
+    return res->next() ? parsePlan(res->getString(1)) : vector<TablePlan>();
+}
+
+// ==========================================
+// SEED DATA
+// ==========================================
+
+long long seedPlanCheckData(sql::Connection* con) {
+    const int CUSTOMERS = 2000;
+    const int JOBS = 40000;
+    const int BATCH = 1000;
+
+    unique_ptr<Statement> stmt(con->createStatement());
+    {
+        unique_ptr<ResultSet> res(stmt->executeQuery("SELECT EXISTS (SELECT 1 FROM printjob) OR EXISTS (SELECT 1 FROM payment)"));
+        if (res->next() && res->getBoolean(1)) return 0;
+    }
+
+    mt19937 rng(20250601); // fixed, so every seeded install has the same distribution
+    long long inserted = 0;
+    con->setAutoCommit(false);
+    try {
+        vector<int> customers;
+        for (int first = 1; first <= CUSTOMERS; first += BATCH) {
+            ostringstream sql;
+            sql << "INSERT INTO user (FullName, Email, Password, Role) VALUES ";
+            for (int i = first; i < first + BATCH && i <= CUSTOMERS; ++i) {
+                sql << (i == first ? "" : ", ")
+                    << "('Seed Customer " << i << "', 'seed" << i << "@example.com', '-', 'Customer')";
+            }
+            inserted += stmt->executeUpdate(sql.str());
+        }
+        {
+            unique_ptr<ResultSet> res(stmt->executeQuery("SELECT UserID FROM user WHERE FullName LIKE 'Seed Customer %'"));
+            while (res->next()) customers.push_back(res->getInt(1));
+        }
+
+        // Skewed like a real shop: a few regulars place most of the jobs
+        geometric_distribution<int> regular(0.002);
+        uniform_int_distribution<int> pages(1, 200);
+        uniform_int_distribution<int> second(0, 365 * 86400 - 1);
+        uniform_int_distribution<int> priority(0, 9);
+        for (int first = 0; first < JOBS; first += BATCH) {
+            ostringstream sql;
+            sql << "INSERT INTO printjob (UserID, PageCount, CostPerPage, TimeStamp, Status, Priority) VALUES ";
+            for (int i = first; i < first + BATCH && i < JOBS; ++i) {
+                int customer = customers[regular(rng) % customers.size()];
+                bool queued = i >= JOBS - 20; // the newest few are still waiting for a printer
+                sql << (i == first ? "" : ", ")
+                    << "(" << customer << ", " << pages(rng) << ", 0.10, '2025-01-01' + INTERVAL " << second(rng)
+                    << " SECOND, '" << (queued ? "Queued" : "Done") << "', " << (priority(rng) == 0 ? 1 : 0) << ")";
+            }
+            inserted += stmt->executeUpdate(sql.str());
+        }
+
+        // Three jobs in four are paid an hour after printing
+        inserted += stmt->executeUpdate(
+            "INSERT INTO payment (UserID, JobID, Amount, Method, PaymentStatus, TimeStamp) "
+            "SELECT UserID, JobID, JobCost, IF(JobID % 3 = 0, 'Card', 'Cash'), 'Complete', TimeStamp + INTERVAL 1 HOUR "
+            "FROM printjob WHERE JobID % 4 <> 0");
+        inserted += stmt->executeUpdate(
+            "INSERT INTO inventoryconsumption (InventoryID, QuantityUsed, TimeStamp) "
+            "SELECT i.InventoryID, IF(i.ItemType = 'Paper', p.PageCount, CEIL(p.PageCount / 100)), p.TimeStamp "
+            "FROM printjob p JOIN inventory i ON i.ItemType IN ('Paper', 'Ink')");
+        con->commit();
+    }
+    catch (SQLException&) {
+        con->rollback();
+        con->setAutoCommit(true);
+        throw;
+    }
+    con->setAutoCommit(true);
+    bumpCustomerDirectoryVersion(con);
+
+    // Fresh statistics, so the estimates do not depend on when InnoDB last sampled
+    unique_ptr<ResultSet> analyzed(stmt->executeQuery("ANALYZE TABLE user, printjob, payment, inventory, inventoryconsumption"));
+    while (analyzed->next()) {}
+    return inserted;
+}
+
+// ==========================================
+// BASELINE & CHECK
+// ==========================================
+
+bool recordPlanBaseline(sql::Connection* con, const std::string& path) {
+    ofstream out(path, ios::trunc);
+    if (!out) return false;
+    out << "# query\ttable#occurrence\taccess_type\tkey\trows_examined_per_scan\n";
+    for (const PlannedQuery& query : plannedQueries()) {
+        for (const auto& entry : keyed(query.name, explainQuery(con, query))) {
+            const TablePlan& t = entry.second;
+            out << entry.first << "\t" << t.accessType << "\t" << (t.key.empty() ? "-" : t.key) << "\t" << t.rows << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+int checkQueryPlans(sql::Connection* con, const std::string& path) {
+    PlanMap baseline;
+    if (!loadBaseline(path, baseline)) return -1;
+    const long long tolerancePct = getConfigInt("PLAN_ROWS_TOLERANCE_PCT", 50);
+
+    cout << left << setw(22) << "Query" << setw(20) << "Table"
+        << setw(30) << "Baseline" << setw(30) << "Now" << "Status\n";
+    cout << string(110, '-') << "\n";
+
+    int regressions = 0;
+    set<string> registered, failed, seen;
+    for (const PlannedQuery& query : plannedQueries()) {
+        registered.insert(query.name);
+        PlanMap now;
+        try {
+            now = keyed(query.name, explainQuery(con, query));
+        }
+        catch (SQLException& e) {
+            cout << setw(22) << query.name << "[FAIL] EXPLAIN failed (" << query.source << "): " << e.what() << "\n";
+            failed.insert(query.name);
+            ++regressions;
+            continue;
+        }
+
+        for (const auto& entry : now) {
+            const TablePlan& t = entry.second;
+            auto base = baseline.find(entry.first);
+            seen.insert(entry.first);
+
+            string status;
+            if (base == baseline.end()) {
+                status = "new";
+            }
+            else {
+                const TablePlan& b = base->second;
+                int was = accessRank(b.accessType), is = accessRank(t.accessType);
+                long long allowed = b.rows + max(b.rows * tolerancePct / 100, ROWS_SLACK);
+                if (was >= 0 && is > was) status = "[FAIL] access " + b.accessType + " -> " + t.accessType;
+                else if (t.rows > allowed) status = "[FAIL] rows " + to_string(b.rows) + " -> " + to_string(t.rows);
+                else if (t.key != b.key) status = "ok (index " + (b.key.empty() ? "-" : b.key) + " -> " + (t.key.empty() ? "-" : t.key) + ")";
+                else status = "ok";
+                if (status.compare(0, 6, "[FAIL]") == 0) ++regressions;
+            }
+
+            cout << setw(22) << query.name << setw(20) << t.table
+                << setw(30) << (base == baseline.end() ? "-" : describe(base->second))
+                << setw(30) << describe(t) << status << "\n";
+        }
+    }
+
+    // Recorded accesses the current plans no longer make
+    for (const auto& entry : baseline) {
+        if (seen.count(entry.first)) continue;
+        const string query = entry.first.substr(0, entry.first.find('\t'));
+        if (failed.count(query)) continue;
+        cout << setw(22) << query << setw(20) << entry.second.table
+            << setw(30) << describe(entry.second) << setw(30) << "-"
+            << (registered.count(query) ? "[FAIL] table gone from the plan" : "[FAIL] statement no longer registered") << "\n";
+        ++regressions;
+    }
+
+    cout << string(110, '-') << "\n";
+    if (regressions == 0) cout << "[PASS] No plan regressions against " << path << ".\n";
+    else cout << "[FAIL] " << regressions << " plan regression(s) against " << path << ".\n";
+    return regressions;
+}
+
+// ==========================================
+// COMMANDS
+// ==========================================
+
+void runQueryPlanCheck(sql::Connection* con) {
+    const string path = baselinePath();
+    cout << "\n--- Query Plan Check (" << plannedQueries().size() << " statements, baseline " << path << ") ---\n";
+    cout << "1. Check plans against the baseline\n";
+    cout << "2. Record the current plans as the baseline\n";
+    cout << "3. Seed an empty test database\n";
+    cout << "4. Back\n";
+    int choice = readInt("Enter your choice (1-4): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    try {
+        switch (choice) {
+        case 1:
+            if (checkQueryPlans(con, path) < 0)
+                cout << "[Notice] No baseline at " << path << "; record one first.\n";
+            break;
+        case 2:
+            if (recordPlanBaseline(con, path)) cout << "[Success] Baseline written to " << path << ".\n";
+            else cout << "[Error] Could not write " << path << ".\n";
+            break;
+        case 3: {
+            long long rows = seedPlanCheckData(con);
+            if (rows == 0) cout << "[Notice] This database already has jobs or payments; nothing seeded.\n";
+            else cout << "[Success] Seeded " << rows << " rows.\n";
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Query plan check failed: " << e.what() << endl;
+    }
+}
+
+int runPlanCheckCommand(int argc, char* argv[]) {
+    bool seed = false, record = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0) seed = true;
+        else if (std::strcmp(argv[i], "--record") == 0) record = true;
+    }
+
+    sql::Connection* con = connectDB();
+    if (con == nullptr) return 2;
+    int result = 0;
+    try {
+        if (!prepareSchema(con)) result = 2;
+        if (result == 0 && seed) cout << "Seeded " << seedPlanCheckData(con) << " rows.\n";
+        if (result == 0 && record) {
+            result = recordPlanBaseline(con, baselinePath()) ? 0 : 2;
+            if (result == 0) cout << "Baseline written to " << baselinePath() << ".\n";
+        }
+        else if (result == 0) {
+            int regressions = checkQueryPlans(con, baselinePath());
+            result = regressions < 0 ? 2 : (regressions > 0 ? 1 : 0);
+            if (regressions < 0) cerr << "No baseline at " << baselinePath() << "; run with --record first." << endl;
+        }
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Query plan check failed: " << e.what() << endl;
+        result = 2;
+    }
+    releaseStatementCache(con);
+    delete con;
+    return result;
+}
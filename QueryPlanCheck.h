@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+
+// ==========================================
+// QUERY PLAN REGRESSION GUARD
+// ==========================================
+// Every static statement the program issues is registered, with sample
+// parameters, by the module that issues it (PlanRegistration, next to the
+// constant the module runs), so the catalogue cannot drift from the code. The
+// check runs each through EXPLAIN FORMAT=JSON and compares every table it
+// touches with the plan recorded in PLAN_BASELINE_FILE. A statement regresses
+// when a table's access type gets worse (ref -> ALL, say) or its examined-row
+// estimate grows by more than PLAN_ROWS_TOLERANCE_PCT. A baseline entry the
+// current plans no longer produce (a table gone from a plan, or a statement no
+// longer registered) fails too.
+//
+// Estimates only compare between like databases, so run it against a test
+// install (DB_NAME) filled by seedPlanCheckData. `workshop --plan-check` prints
+// the comparison and exits 1 on a regression; `--plan-check --record` rewrites
+// the baseline after an intended change.
+//
+// Samples fall in June 2025, inside the seeded year. Dynamic SQL registers
+// the shape it usually takes (the stock check with the two standard materials).
+
+struct PlannedQuery {
+    const char* name;
+    const char* source;               // file that issues it
+    const char* sql;                  // as issued, with ? placeholders
+    std::vector<std::string> params;  // sample values, bound in order as literals
+};
+
+// Declared at namespace scope beside the statement's constant:
+//   const char* const SQL_JOB_DETAILS = "SELECT ... WHERE JobID = ?";
+//   const PlanRegistration planJobDetails("job_details", "printjob.cpp", SQL_JOB_DETAILS, { "17" });
+struct PlanRegistration {
+    PlanRegistration(const char* name, const char* source, const char* sql, std::vector<std::string> params);
+};
+
+// One table access in a plan
+struct TablePlan {
+    std::string table;       // alias as written in the query
+    std::string accessType;  // system, const, eq_ref, ref, range, index, ALL, ...
+    std::string key;         // "" = no index used
+    long long rows = 0;      // rows_examined_per_scan
+};
+
+// Every registered statement, by name
+const std::vector<PlannedQuery>& plannedQueries();
+
+// Throws sql::SQLException
+std::vector<TablePlan> explainQuery(sql::Connection* con, const PlannedQuery& query);
+
+// Fills an install with no print jobs with a fixed data set (customers, a year
+// of jobs, payments and consumption in 2025); returns rows inserted, 0 if the
+// install already has data. Throws sql::SQLException.
+long long seedPlanCheckData(sql::Connection* con);
+
+// Writes the current plans to `path`; false if the file could not be written
+bool recordPlanBaseline(sql::Connection* con, const std::string& path);
+
+// Prints current vs. baseline plans; returns regressions found, -1 if there is no baseline
+int checkQueryPlans(sql::Connection* con, const std::string& path);
+
+// System Maintenance command: check, record or seed
+void runQueryPlanCheck(sql::Connection* con);
+
+// `workshop --plan-check [--seed] [--record]`: 0 = no regressions, 1 = regressions, 2 = error
+int runPlanCheckCommand(int argc, char* argv[]);
@@ -0,0 +1,187 @@
+#include "ReplicaRouting.h"
+#include "db.h" // getConfigValue(), getConfigInt()
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cppconn/statement.h>
+#include <cppconn/resultset.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// REPLICA HEALTH
+// ==========================================
+
+namespace {
+    ConnectionPool& replicaPool() {
+        static ConnectionPool pool(0, DbEndpoint::Replica);
+        return pool;
+    }
+
+    struct ReplicaHealth {
+        bool checked = false;
+        chrono::steady_clock::time_point checkedAt;
+        bool usable = false;
+        long long lagS = -1;  // at the last check; -1 = unknown
+        string reason;        // why it is not usable
+        bool announcedDown = false;
+    };
+
+    mutex g_healthMutex;
+    ReplicaHealth g_health;
+
+    int maxLagSeconds() {
+        return getConfigInt("REPLICA_MAX_LAG_S", 10);
+    }
+
+    chrono::seconds checkInterval() {
+        return chrono::seconds(max(getConfigInt("REPLICA_LAG_CHECK_S", 5), 1));
+    }
+
+    bool checkDue(chrono::steady_clock::time_point now) {
+        lock_guard<mutex> lock(g_healthMutex);
+        return !g_health.checked || now - g_health.checkedAt >= checkInterval();
+    }
+
+    void record(bool usable, long long lagS, const string& reason) {
+        lock_guard<mutex> lock(g_healthMutex);
+        g_health.checked = true;
+        g_health.checkedAt = chrono::steady_clock::now();
+        g_health.usable = usable;
+        g_health.lagS = lagS;
+        g_health.reason = reason;
+        if (!usable && !g_health.announcedDown) {
+            cerr << "[Replica] Reports run on the primary: " << reason << endl;
+            g_health.announcedDown = true;
+        }
+        else if (usable && g_health.announcedDown) {
+            cerr << "[Replica] Reports run on the replica again." << endl;
+            g_health.announcedDown = false;
+        }
+    }
+
+    // Worst lag over every replication channel; false with `reason` if one is not running
+    bool readLag(Connection* con, long long& lagS, string& reason) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res;
+        bool legacy = false;
+        try {
+            res.reset(stmt->executeQuery("SHOW REPLICA STATUS"));  // 8.0.22 and later
+        }
+        catch (SQLException&) {
+            res.reset(stmt->executeQuery("SHOW SLAVE STATUS"));
+            legacy = true;
+        }
+        const char* ioColumn = legacy ? "Slave_IO_Running" : "Replica_IO_Running";
+        const char* sqlColumn = legacy ? "Slave_SQL_Running" : "Replica_SQL_Running";
+        const char* lagColumn = legacy ? "Seconds_Behind_Master" : "Seconds_Behind_Source";
+
+        bool any = false;
+        lagS = 0;
+        while (res->next()) {
+            any = true;
+            // The lag reads 0 once the relay log is applied, even with the source unreachable
+            if (res->getString(ioColumn) != "Yes" || res->getString(sqlColumn) != "Yes" || res->isNull(lagColumn)) {
+                reason = "replication is not running";
+                return false;
+            }
+            lagS = max<long long>(lagS, res->getInt64(lagColumn));
+        }
+        if (!any) reason = "the server is not configured as a replica";
+        return any;
+    }
+
+    // A pooled session whose link dropped; reconnected without touching the
+    // primary's online state
+    void reviveSession(Connection* con) {
+        if (con->isValid()) return;
+        releaseStatementCache(con);
+        if (!con->reconnect()) throw SQLException("Replica unreachable");
+        con->setSchema(getConfigValue("DB_NAME"));
+        unique_ptr<Statement> stmt(con->createStatement());
+        stmt->execute("SET SESSION TRANSACTION READ ONLY");
+    }
+}
+
+ConnectionPool::Lease acquireReportReplica() {
+    if (getConfigValue("DB_REPLICA_HOST").empty()) return ConnectionPool::Lease();
+
+    const auto now = chrono::steady_clock::now();
+    const bool due = checkDue(now);
+    if (!due) {
+        lock_guard<mutex> lock(g_healthMutex);
+        if (!g_health.usable) return ConnectionPool::Lease();
+    }
+
+    ConnectionPool::Lease lease = replicaPool().acquire();
+    if (!lease) {
+        record(false, -1, "replica unreachable");
+        return ConnectionPool::Lease();
+    }
+    if (due) {
+        long long lagS = -1;
+        string reason;
+        try {
+            reviveSession(lease.get());
+            if (!readLag(lease.get(), lagS, reason)) {
+                record(false, -1, reason);
+                return ConnectionPool::Lease();
+            }
+        }
+        catch (SQLException& e) {
+            record(false, -1, e.what());
+            return ConnectionPool::Lease();
+        }
+        if (lagS > maxLagSeconds()) {
+            record(false, lagS, to_string(lagS) + " s behind (limit " + to_string(maxLagSeconds()) + " s)");
+            return ConnectionPool::Lease();
+        }
+        record(true, lagS, "");
+    }
+    return lease;
+}
+
+void replicaReadFailed(const sql::SQLException& e) {
+    record(false, -1, string("read failed: ") + e.what());
+}
+
+void killReplicaQuery(long long sessionID) {
+    ConnectionPool::Lease lease = replicaPool().acquire();
+    if (!lease) throw SQLException("Replica unreachable");
+    reviveSession(lease.get());
+    unique_ptr<Statement> stmt(lease.get()->createStatement());
+    stmt->execute("KILL QUERY " + to_string(sessionID));
+}
+
+// ==========================================
+// STATUS
+// ==========================================
+
+void runReplicaStatus() {
+    cout << "\n--- Read Replica Status ---\n";
+    const string host = getConfigValue("DB_REPLICA_HOST");
+    if (host.empty()) {
+        cout << "No replica configured (DB_REPLICA_HOST in config.ini); reports run on the primary.\n";
+        return;
+    }
+
+    {
+        // Measure now rather than report a reading up to REPLICA_LAG_CHECK_S old
+        lock_guard<mutex> lock(g_healthMutex);
+        g_health.checked = false;
+    }
+    bool onReplica = static_cast<bool>(acquireReportReplica());
+
+    lock_guard<mutex> lock(g_healthMutex);
+    cout << left << setw(16) << "Endpoint:" << host << "\n";
+    cout << left << setw(16) << "Lag:";
+    if (g_health.lagS >= 0) cout << g_health.lagS << " s (limit " << maxLagSeconds() << " s)\n";
+    else cout << "unknown\n";
+    if (!g_health.reason.empty()) cout << left << setw(16) << "Problem:" << g_health.reason << "\n";
+    cout << left << setw(16) << "Reports run on:" << (onReplica ? "the replica" : "the primary") << "\n";
+}
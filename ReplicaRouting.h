@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mysql_connection.h>
+#include <cppconn/exception.h>
+#include "ConnectionPool.h"
+#include "ResilientConnection.h"
+
+// ==========================================
+// READ REPLICA ROUTING
+// ==========================================
+// Heavy read-only reports run on a replica when DB_REPLICA_HOST is set in
+// config.ini (DB_REPLICA_USER / DB_REPLICA_PASS default to the primary's
+// account). That keeps report scans off the primary, where they compete with
+// checkout writes. Writes never come through here.
+//
+// The replica is handed out only while it is replicating (both threads
+// running) and at most REPLICA_MAX_LAG_S seconds behind. The lag is measured
+// with SHOW REPLICA STATUS, at most once every REPLICA_LAG_CHECK_S. Otherwise,
+// or if the read fails on the replica, it runs on the primary under the usual
+// retry policy. After a failure the replica is left alone for
+// REPLICA_LAG_CHECK_S.
+//
+// The paged listings stream from the replica under the same rules
+// (StreamSource::ReplicaFirst in ResultStreaming.h).
+//
+// Replica reads are never retried on the replica. A lost replica link must
+// not mark the database offline, so `fn` should query directly rather than
+// through withReadRetry().
+
+// A replica session within the lag limit, or an empty lease
+ConnectionPool::Lease acquireReportReplica();
+
+// Stops routing to the replica until the next check (reported on cerr)
+void replicaReadFailed(const sql::SQLException& e);
+
+// KILL QUERY for a replica session, sent from another replica session (a
+// stream's early close). Throws sql::SQLException if the replica is unreachable.
+void killReplicaQuery(long long sessionID);
+
+// Runs `fn(con)` on the replica, else on `primary`. `fn` must not print until
+// it has its rows, because a failed replica read is run again on the primary.
+template <typename Fn>
+auto readOnReplica(sql::Connection* primary, Fn fn) -> decltype(fn(primary)) {
+    {
+        ConnectionPool::Lease replica = acquireReportReplica();
+        if (replica) {
+            try {
+                return fn(replica.get());
+            }
+            catch (sql::SQLException& e) {
+                replicaReadFailed(e);
+            }
+        }
+    }
+    return withReadRetry(primary, [&]() { return fn(primary); });
+}
+
+// System Maintenance command: replica health, lag and where reports run now
+void runReplicaStatus();
@@ -1,14 +1,58 @@
 #include "ReportGeneration.h"
 #include "utils.h" // Assuming readInt is defined here
+#include "ListPager.h"
+#include "Repositories.h"
+#include "PaymentAnalytics.h"
+#include "Money.h"
+#include "ReplicaRouting.h"
+#include "QueryPlanCheck.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <memory>
 #include <vector>
 #include <cmath>
+#include <sstream>
+#include <limits>
 
 using namespace std;
 
+namespace {
+    const char* const SQL_ASSETS_AND_COST =
+        "SELECT "
+        "  (SELECT IFNULL(SUM(Quantity * UnitCost), 0) FROM inventory) AS TotalAssets, "
+        "  (SELECT IFNULL(SUM(ic.QuantityUsed * i.UnitCost), 0) "
+        "   FROM inventoryconsumption ic "
+        "   JOIN inventory i ON ic.InventoryID = i.InventoryID "
+        "   WHERE ic.TimeStamp >= ? AND ic.TimeStamp < ?) "
+        "  + (SELECT IFNULL(SUM(ca.QuantityUsed * i.UnitCost), 0) "
+        "   FROM consumption_monthly_archive ca "
+        "   JOIN inventory i ON ca.InventoryID = i.InventoryID "
+        "   WHERE ca.Year = ? AND ca.Month = ?) AS TotalCost";
+    const char* const SQL_MONTH_TRANSACTIONS =
+        "SELECT p.TransactionID, u.FullName, p.Amount, p.TimeStamp "
+        "FROM payment p JOIN user u ON p.UserID = u.UserID "
+        "WHERE p.PaymentStatus = 'Complete' AND p.TimeStamp >= ? AND p.TimeStamp < ? "
+        "ORDER BY p.TimeStamp ASC";
+    const PlanRegistration planAssetsAndCost("assets_and_cost", "ReportGeneration.cpp", SQL_ASSETS_AND_COST,
+        { "2025-06-01", "2025-07-01", "2025", "6" });
+    const PlanRegistration planMonthTransactions("month_transactions", "ReportGeneration.cpp", SQL_MONTH_TRANSACTIONS,
+        { "2025-06-01", "2025-07-01" });
+
+    // "YYYY-MM-01" for month-range predicates. Reports filter with
+    // TimeStamp >= start AND TimeStamp < end instead of YEAR()/MONTH() so the
+    // monthly partitions (and any TimeStamp index) are pruned to the range.
+    string monthStart(int year, int month) {
+        while (month > 12) { month -= 12; year++; }
+        ostringstream oss;
+        oss << year << "-" << setw(2) << setfill('0') << month << "-01";
+        return oss.str();
+    }
+
+    const char* const MONTH_NAMES[] = { "January", "February", "March", "April", "May", "June",
+        "July", "August", "September", "October", "November", "December" };
+}
+
 void runReportGeneration(sql::Connection* con) {
     int choice;
     do {
@@ -73,49 +117,54 @@ void runReportGeneration(sql::Connection* con) {
 }
 
 // 1. FINANCIAL SUMMARY
-void generateFinancialSummary(sql::Connection* con, int year, int month) {
+void generateFinancialSummary(sql::Connection* con, int year, int month, std::ostream& out) {
     try {
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement(
-                "SELECT "
-                "  (SELECT IFNULL(SUM(Amount), 0) FROM payment "
-                "   WHERE PaymentStatus = 'Complete' AND YEAR(TimeStamp) = ? AND MONTH(TimeStamp) = ?) AS TotalSales, "
-                "  (SELECT IFNULL(SUM(Quantity * UnitCost), 0) FROM inventory) AS TotalAssets, "
-                "  (SELECT IFNULL(SUM(ic.QuantityUsed * i.UnitCost), 0) "
-                "   FROM inventoryconsumption ic "
-                "   JOIN inventory i ON ic.InventoryID = i.InventoryID "
-                "   WHERE YEAR(ic.TimeStamp) = ? AND MONTH(ic.TimeStamp) = ?) AS TotalCost"
-            )
-        );
-
-        pstmt->setInt(1, year);
-        pstmt->setInt(2, month);
-        pstmt->setInt(3, year);
-        pstmt->setInt(4, month);
-
-        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-
-        if (res->next()) {
-            double sales = res->getDouble("TotalSales");
-            double assetVal = res->getDouble("TotalAssets");
-            double cost = res->getDouble("TotalCost");
-            double profit = sales - cost;
-            double margin = (sales > 0) ? (profit / sales) * 100 : 0.0;
-
-            cout << "\n==========================================" << endl;
-            cout << "    FINANCIAL SUMMARY FOR " << month << "/" << year << endl;
-            cout << "==========================================" << endl;
-            cout << left << setw(28) << "1. Monthly Total Sales:" << "$" << fixed << setprecision(2) << sales << endl;
-            cout << left << setw(28) << "2. Total Operating Cost:" << "$" << cost << endl;
-            cout << "------------------------------------------" << endl;
-            cout << left << setw(28) << "3. Net Profit:" << "$" << profit << endl;
-            cout << left << setw(28) << "4. Profit Margin:" << margin << "%" << endl;
-            cout << "------------------------------------------" << endl;
-            cout << left << setw(28) << "5. Total Current Assets:" << "$" << assetVal << " (Current)" << endl;
-            cout << "==========================================" << endl;
-
-            if (sales == 0 && cost == 0) {
-                cout << "[Notice] No data found for this specific period." << endl;
+        // Sales from the payment store; cost from consumption, live plus archived aggregates.
+        // The store follows the primary; the cost scan runs on the read replica when one is healthy.
+        Money sales = completedSalesByMonth(con, year, month, 1)[0].amount;
+
+        struct AssetsAndCost {
+            bool found = false;
+            Money assets, cost;
+        };
+        AssetsAndCost totals = readOnReplica(con, [&](sql::Connection* db) {
+            unique_ptr<sql::PreparedStatement> pstmt(db->prepareStatement(SQL_ASSETS_AND_COST));
+
+            pstmt->setString(1, monthStart(year, month));
+            pstmt->setString(2, monthStart(year, month + 1));
+            pstmt->setInt(3, year);
+            pstmt->setInt(4, month);
+
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            AssetsAndCost found;
+            if (res->next()) {
+                found.found = true;
+                found.assets = getMoney(*res, "TotalAssets");
+                found.cost = getMoney(*res, "TotalCost");
+            }
+            return found;
+            });
+
+        if (totals.found) {
+            Money assetVal = totals.assets;
+            Money cost = totals.cost;
+            Money profit = sales - cost;
+            double margin = (sales > Money()) ? (profit.toDouble() / sales.toDouble()) * 100 : 0.0;
+
+            out << "\n==========================================" << endl;
+            out << "    FINANCIAL SUMMARY FOR " << month << "/" << year << endl;
+            out << "==========================================" << endl;
+            out << left << setw(28) << "1. Monthly Total Sales:" << "$" << fixed << setprecision(2) << sales << endl;
+            out << left << setw(28) << "2. Total Operating Cost:" << "$" << cost << endl;
+            out << "------------------------------------------" << endl;
+            out << left << setw(28) << "3. Net Profit:" << "$" << profit << endl;
+            out << left << setw(28) << "4. Profit Margin:" << margin << "%" << endl;
+            out << "------------------------------------------" << endl;
+            out << left << setw(28) << "5. Total Current Assets:" << "$" << assetVal << " (Current)" << endl;
+            out << "==========================================" << endl;
+
+            if (sales == Money() && cost == Money()) {
+                out << "[Notice] No data found for this specific period." << endl;
             }
         }
     }
@@ -125,74 +174,53 @@ void generateFinancialSummary(sql::Connection* con, int year, int month) {
 }
 
 // 2. SALES TREND
-void displaySalesTrendChart(sql::Connection* con, int year) {
+void displaySalesTrendChart(sql::Connection* con, int year, std::ostream& out) {
     try {
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement(
-                "SELECT MONTHNAME(TimeStamp) AS Month, SUM(Amount) AS MonthlySales "
-                "FROM payment "
-                "WHERE PaymentStatus = 'Complete' AND YEAR(TimeStamp) = ? "
-                "GROUP BY MONTH(TimeStamp), MONTHNAME(TimeStamp) "
-                "ORDER BY MONTH(TimeStamp) ASC"
-            )
-        );
-        pstmt->setInt(1, year);
-        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-
-        std::cout << "\n--- Sales Trend for " << year << " (Scale: 1 # = $500) ---\n";
-        while (res->next()) {
-            string month = res->getString("Month");
-            double sales = res->getDouble("MonthlySales");
-            // Change from / 100 to / 5000 or / 10000
-            int barWidth = static_cast<int>(sales / 500);
+        vector<MonthlySales> months = completedSalesByMonth(con, year, 1, 12);
 
-            
+        out << "\n--- Sales Trend for " << year << " (Scale: 1 # = $500) ---\n";
+        for (int m = 0; m < 12; m++) {
+            if (months[m].payments == 0) continue;
+            Money sales = months[m].amount;
+            int barWidth = static_cast<int>(sales.cents() / 50000);
 
-            cout << left << setw(12) << month << " | ";
-            for (int i = 0; i < barWidth; ++i) cout << "#";
-            cout << "  $" << fixed << setprecision(2) << sales << endl;
+            out << left << setw(12) << MONTH_NAMES[m] << " | ";
+            for (int i = 0; i < barWidth; ++i) out << "#";
+            out << "  $" << sales << endl;
         }
     }
     catch (sql::SQLException& e) { cerr << "SQL Error: " << e.what() << endl; }
 }
 
 // 3. SALES GROWTH
-void displaySalesGrowthGraph(sql::Connection* con, int year) {
+void displaySalesGrowthGraph(sql::Connection* con, int year, std::ostream& out) {
     try {
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement(
-                "SELECT Month, MonthlySales, PrevSales FROM ("
-                "  SELECT MONTHNAME(TimeStamp) AS Month, "
-                "  YEAR(TimeStamp) as YearVal, "
-                "  MONTH(TimeStamp) as MonthNum, "
-                "  SUM(Amount) AS MonthlySales, "
-                "  LAG(SUM(Amount)) OVER (ORDER BY YEAR(TimeStamp), MONTH(TimeStamp)) AS PrevSales "
-                "  FROM payment WHERE PaymentStatus = 'Complete' "
-                "  GROUP BY YEAR(TimeStamp), MONTH(TimeStamp), MONTHNAME(TimeStamp)"
-                ") AS GrowthData WHERE YearVal = ?"
-            )
-        );
-        pstmt->setInt(1, year);
-        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-
-        cout << "\n--- Monthly Sales Growth Graph for " << year << " ---\n";
-        while (res->next()) {
-            string month = res->getString("Month");
-            double current = res->getDouble("MonthlySales");
-            double previous = res->getDouble("PrevSales");
+        // The previous year is included only so January has a month to compare with
+        vector<MonthlySales> months = completedSalesByMonth(con, year - 1, 1, 24);
+
+        out << "\n--- Monthly Sales Growth Graph for " << year << " ---\n";
+        double previous = 0.0; // the last month with sales, as LAG over the months that have any
+        for (int m = 0; m < 24; m++) {
+            if (months[m].payments == 0) continue;
+            double current = months[m].amount.toDouble();
+            if (m < 12) {
+                previous = current;
+                continue;
+            }
 
-            cout << left << setw(12) << month << ": ";
+            out << left << setw(12) << MONTH_NAMES[m - 12] << ": ";
             if (previous <= 0) {
-                cout << "[No Previous Data]";
+                out << "[No Previous Data]";
             }
             else {
                 double growth = ((current - previous) / previous) * 100;
-                cout << (growth >= 0 ? "+" : "") << fixed << setprecision(1) << growth << "% ";
+                out << (growth >= 0 ? "+" : "") << fixed << setprecision(1) << growth << "% ";
                 int blocks = static_cast<int>(abs(growth) / 10);
                 char marker = (growth >= 0 ? '+' : '-');
-                for (int i = 0; i < blocks; i++) cout << marker;
+                for (int i = 0; i < blocks; i++) out << marker;
             }
-            cout << endl;
+            out << endl;
+            previous = current;
         }
     }
     catch (sql::SQLException& e) { cerr << "SQL Error: " << e.what() << endl; }
@@ -202,24 +230,12 @@ void displaySalesGrowthGraph(sql::Connection* con, int year) {
 // 4. MONTHLY SALES DATA (Optimized for Big Data)
 void displayMonthlySalesTable(sql::Connection* con, int year, int month) {
     try {
-        // Step 1: Summary Query
-        unique_ptr<sql::PreparedStatement> summaryPstmt(
-            con->prepareStatement(
-                "SELECT COUNT(*) AS total_count, IFNULL(SUM(Amount), 0) AS total_sum "
-                "FROM payment WHERE PaymentStatus = 'Complete' "
-                "AND YEAR(TimeStamp) = ? AND MONTH(TimeStamp) = ?"
-            )
-        );
-        summaryPstmt->setInt(1, year);
-        summaryPstmt->setInt(2, month);
-        unique_ptr<sql::ResultSet> summaryRes(summaryPstmt->executeQuery());
-
-        long long totalRows = 0;
-        double totalRevenue = 0;
-        if (summaryRes->next()) {
-            totalRows = summaryRes->getInt64("total_count");
-            totalRevenue = summaryRes->getDouble("total_sum");
-        }
+        // Step 1: Summary (live rows plus archived monthly aggregates)
+        MonthTotals totals = makeMySqlRepositories(con)->completedPayments(year, month);
+        long long totalRows = totals.count;
+        Money totalRevenue = totals.amount;
+        long long archivedRows = totals.archivedCount;
+        long long liveRows = totalRows - archivedRows;
 
         if (totalRows == 0) {
             cout << "\n[Notice] No transactions found for " << month << "/" << year << ".\n";
@@ -229,27 +245,28 @@ void displayMonthlySalesTable(sql::Connection* con, int year, int month) {
         cout << "\n==================================================================" << endl;
         cout << "   SUMMARY FOR " << month << "/" << year << endl;
         cout << "   Total Transactions: " << totalRows << endl;
-        cout << "   Total Revenue:      $" << fixed << setprecision(2) << totalRevenue << endl;
+        cout << "   Total Revenue:      $" << totalRevenue << endl;
+        if (archivedRows > 0) cout << "   (" << archivedRows << " archived transactions are not listed)" << endl;
         cout << "==================================================================" << endl;
+        if (liveRows == 0) return;
         cout << "Proceed to view detailed list? (y/n): ";
         char proceed; cin >> proceed;
         if (tolower(proceed) != 'y') return;
 
-        // Step 2: Detailed List Query
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement(
-                "SELECT p.TransactionID, u.FullName, p.Amount, p.TimeStamp "
-                "FROM payment p JOIN user u ON p.UserID = u.UserID "
-                "WHERE p.PaymentStatus = 'Complete' AND YEAR(p.TimeStamp) = ? AND MONTH(p.TimeStamp) = ? "
-                "ORDER BY p.TimeStamp ASC"
-            )
-        );
-        pstmt->setInt(1, year);
-        pstmt->setInt(2, month);
-        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-
-        int rowCount = 0;
-        int pageSize = 20;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n'); // the pager reads whole lines
+
+        // Step 2: Detailed List Query, streamed; the next page is decoded while this one is read.
+        // Streams take no parameters; the bounds are generated dates, so they are inlined.
+        const int pageSize = 20;
+        ListPager pager(con, inlineParams(SQL_MONTH_TRANSACTIONS, { monthStart(year, month), monthStart(year, month + 1) }),
+            pageSize, [](sql::ResultSet& res) {
+                ostringstream line;
+                line << "| " << left << setw(10) << res.getInt("TransactionID")
+                    << "| " << setw(22) << res.getString("FullName")
+                    << "| $" << setw(11) << getMoney(res, "Amount")
+                    << "| " << res.getString("TimeStamp").substr(0, 10) << " |";
+                return line.str();
+            }, StreamSource::ReplicaFirst);
 
         // Header printing logic in a lambda to avoid repetition
         auto printHeader = [&]() {
@@ -267,36 +284,8 @@ void displayMonthlySalesTable(sql::Connection* con, int year, int month) {
         system("clear");
 #endif
 
-        printHeader();
-
-        while (res->next()) {
-            cout << "| " << left << setw(10) << res->getInt("TransactionID")
-                << "| " << setw(22) << res->getString("FullName")
-                << "| $" << setw(11) << fixed << setprecision(2) << res->getDouble("Amount")
-                << "| " << res->getString("TimeStamp").substr(0, 10) << " |" << endl;
-
-            rowCount++;
-
-            if (rowCount % pageSize == 0) {
-                cout << "------------------------------------------------------------------" << endl;
-                cout << ">>> Showing " << rowCount << " of " << totalRows << " records." << endl;
-                cout << ">>> [Enter] for more, [q] to quit, [c] to clear & continue: ";
-
-                string input;
-                getline(cin >> ws, input);
-
-                if (!input.empty() && tolower(input[0]) == 'q') break;
-
-                if (!input.empty() && tolower(input[0]) == 'c') {
-#ifdef _WIN32
-                    system("cls");
-#else
-                    system("clear");
-#endif
-                    printHeader(); // Use the lambda to reprint headers
-                }
-            }
-        }
+        browsePages(pager, liveRows, pageSize, printHeader,
+            "------------------------------------------------------------------");
         cout << "========================== END OF REPORT ==========================" << endl;
 
     }
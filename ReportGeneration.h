@@ -7,6 +7,7 @@
 #include <cppconn/prepared_statement.h>
 #include <cppconn/resultset.h>
 #include "utils.h"
+#include <iostream>
 
 /**
  * Entry point for the Report Generation Module.
@@ -17,20 +18,21 @@ void runReportGeneration(sql::Connection* con);
 /**
  * Requirement: Generating Summary Lists.
  * Summarizes Monthly Sales, Inventory Value, and Profit Margin.
+ * The three chart/summary reports write to `out` so server mode can send them to a client.
  */
-void generateFinancialSummary(sql::Connection* con, int year, int month);
+void generateFinancialSummary(sql::Connection* con, int year, int month, std::ostream& out = std::cout);
 
 /**
  * Requirement: Generating Text-Based Charts.
  * Visualizes monthly sales volume using a bar chart format.
  */
-void displaySalesTrendChart(sql::Connection* con, int year);  // Requirement 4
+void displaySalesTrendChart(sql::Connection* con, int year, std::ostream& out = std::cout);  // Requirement 4
 
 /**
  * Requirement: Generating Text-Based Graph Summaries.
  * Shows percentage changes in sales from month to month.
  */
-void displaySalesGrowthGraph(sql::Connection* con, int year); // Requirement 5
+void displaySalesGrowthGraph(sql::Connection* con, int year, std::ostream& out = std::cout); // Requirement 5
 
 /**
  * Requirement: Generating Reports in Table Format.
@@ -0,0 +1,116 @@
+#include "Repositories.h"
+#include "printjob.h"
+#include "PaymentModule.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <chrono>
+#include <cppconn/statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// BACKEND BENCHMARK
+// ==========================================
+
+namespace {
+    struct RuleTimings {
+        double createUs = 0.0;
+        double payUs = 0.0;
+        double reportUs = 0.0;
+        int rejected = 0;
+    };
+
+    template <typename Fn>
+    double averageUs(int count, Fn fn) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) fn(i);
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / count;
+    }
+
+    // `count` jobs for one customer, a payment for each, then the monthly report
+    RuleTimings timeRules(Repositories& repos, BomRange bom, int customerID, int count) {
+        RuleTimings timings;
+        vector<int> jobs(count, -1);
+        timings.createUs = averageUs(count, [&](int i) {
+            string error;
+            jobs[i] = placePrintJob(repos, repos, repos, bom, customerID, 25, 0.10, "2025-06-15 12:00:00", NOT_QUEUED, error);
+            if (jobs[i] < 0) timings.rejected++;
+            });
+        timings.payUs = averageUs(count, [&](int i) {
+            int transactionID = 0;
+            string reason;
+            if (takePayment(repos, repos, customerID, jobs[i], Money::fromCents(500), "Cash", "2025-06-15 12:00:00", transactionID, reason).empty()) {
+                timings.rejected++;
+            }
+            });
+        timings.reportUs = averageUs(count, [&](int) { repos.completedPayments(2025, 6); });
+        return timings;
+    }
+}
+
+void runRepositoryBenchmark(sql::Connection* con) {
+    cout << "\n--- Repository Benchmark (in-memory vs MySQL) ---\n";
+    cout << "Runs the job and payment rules on both backends. The MySQL run writes real\n"
+        "rows inside one transaction and rolls it back, holding row locks until then.\n"
+        "Run it on a test database. Continue? (y/n): ";
+    string answer;
+    getline(cin, answer);
+    if (answer.empty() || tolower(answer[0]) != 'y') return;
+
+    int count = readInt("Operations per rule (e.g., 500): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (count <= 0) {
+        cout << "[Error] Operations must be positive.\n";
+        return;
+    }
+
+    RuleTimings memory, mysql;
+    try {
+        BomRange bom = bomForJobType(con);
+
+        // Same bill of materials, one customer, stock that never runs out
+        unique_ptr<Repositories> inMemory = makeInMemoryRepositories();
+        int memoryCustomer = inMemory->addUser("Benchmark Customer", "bench@example.com", "Customer");
+        for (const BomLine& line : bom) inMemory->restock(line.inventoryID, 1000000000LL);
+        memory = timeRules(*inMemory, bom, memoryCustomer, count);
+
+        unique_ptr<Repositories> db = makeMySqlRepositories(con);
+        con->setAutoCommit(false);
+        try {
+            int dbCustomer = db->addUser("Benchmark Customer", "bench@example.com", "Customer");
+            for (const BomLine& line : bom) db->restock(line.inventoryID, 1000000000LL);
+            mysql = timeRules(*db, bom, dbCustomer, count);
+        }
+        catch (SQLException&) {
+            con->rollback();
+            con->setAutoCommit(true);
+            throw;
+        }
+        con->rollback();
+        con->setAutoCommit(true);
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Benchmark stopped: " << e.what() << endl;
+        return;
+    }
+
+    cout << "\n" << left << setw(18) << "Rule" << right << setw(16) << "In-memory (us)"
+        << setw(14) << "MySQL (us)" << setw(16) << "Database share" << "\n";
+    cout << string(64, '-') << "\n";
+    auto row = [](const char* rule, double cpu, double db) {
+        cout << left << setw(18) << rule << right << fixed << setprecision(2) << setw(16) << cpu
+            << setw(14) << db << setw(15) << setprecision(1) << (db > 0 ? 100.0 * (db - cpu) / db : 0.0) << "%\n";
+        };
+    row("Place print job", memory.createUs, mysql.createUs);
+    row("Take payment", memory.payUs, mysql.payUs);
+    row("Monthly totals", memory.reportUs, mysql.reportUs);
+    if (memory.rejected + mysql.rejected > 0) {
+        cout << "[Warning] Rejected operations: in-memory " << memory.rejected << ", MySQL " << mysql.rejected << ".\n";
+    }
+    cout << "(" << count << " operations each; the MySQL rows were rolled back.)\n";
+}
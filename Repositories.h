@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+#include "BillOfMaterials.h"
+#include "Money.h"
+
+// ==========================================
+// REPOSITORIES (storage behind the business rules)
+// ==========================================
+// The job and payment rules (placePrintJob in printjob.h, takePayment in
+// PaymentModule.h) reach storage only through these interfaces. That way the
+// same rule code runs on two backends:
+//   MySQL      today's statements on a sql::Connection. Writes join the
+//              caller's transaction, and failures throw sql::SQLException.
+//   in-memory  hash-indexed containers, with no server and no I/O.
+//              Deterministic: an empty timestamp means the backend's fixed clock.
+// Timing a rule on both backends separates its CPU cost from its database cost
+// (runRepositoryBenchmark). Neither backend is thread-safe.
+//
+// ShopRepository.h is a different seam: it decides how multi-query reads are
+// sent (JDBC or X Protocol), not where the data lives.
+
+struct PaymentRecord {
+    int userID = 0;
+    int jobID = 0;
+    Money amount;
+    std::string method;
+    std::string status;     // Complete / Insufficient
+    std::string timeStamp;  // "YYYY-MM-DD HH:MM:SS"; empty = now
+};
+
+// Complete payments in one month
+struct MonthTotals {
+    long long count = 0;          // live and archived
+    Money amount;
+    long long archivedCount = 0;  // part of count held only as aggregates (ColdArchive.h)
+};
+
+class UserRepo {
+public:
+    virtual ~UserRepo() {}
+    virtual int addUser(const std::string& fullName, const std::string& email, const std::string& role) = 0;
+    virtual bool exists(int userID) = 0;
+    virtual bool isCustomer(int userID) = 0;
+};
+
+class PrintJobRepo {
+public:
+    virtual ~PrintJobRepo() {}
+    // Returns the new JobID. Stock is the InventoryRepo's business. queuePriority
+    // is insertPrintJobRecord's (printjob.h); the in-memory backend has no queue.
+    virtual int addJob(int userID, int pageCount, double costPerPage, const std::string& timeStamp, int queuePriority) = 0;
+    // False when the job does not exist or belongs to another user
+    virtual bool jobCost(int jobID, int userID, Money& cost) = 0;
+};
+
+class PaymentRepo {
+public:
+    virtual ~PaymentRepo() {}
+    virtual bool isPaid(int jobID) = 0;
+    // Returns the new TransactionID
+    virtual int addPayment(const PaymentRecord& payment) = 0;
+};
+
+class InventoryRepo {
+public:
+    virtual ~InventoryRepo() {}
+    virtual void restock(int inventoryID, long long units) = 0;
+    virtual long long quantity(int inventoryID) = 0;
+    // Takes and logs every need, or nothing: false with `shortItem` set when one item is short
+    virtual bool take(const std::vector<MaterialNeed>& needs, int& shortItem) = 0;
+};
+
+class ReportRepo {
+public:
+    virtual ~ReportRepo() {}
+    virtual MonthTotals completedPayments(int year, int month) = 0;
+};
+
+// One backend serves all five
+class Repositories : public UserRepo, public PrintJobRepo, public PaymentRepo, public InventoryRepo, public ReportRepo {
+public:
+    virtual const char* backendName() const = 0;
+};
+
+std::unique_ptr<Repositories> makeMySqlRepositories(sql::Connection* con);
+
+// `clock` stamps rows added with an empty timestamp
+std::unique_ptr<Repositories> makeInMemoryRepositories(const std::string& clock = "2025-06-15 12:00:00");
+
+// System Maintenance command: the job and payment rules timed on both backends
+void runRepositoryBenchmark(sql::Connection* con);
@@ -0,0 +1,106 @@
+#include "ResilientConnection.h"
+#include "OfflineJournal.h" // markDatabaseOnline(), markDatabaseOffline()
+#include "db.h"             // getConfigInt(), getConfigValue()
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+
+using namespace std;
+
+namespace {
+    mutex g_cacheMutex;
+    map<sql::Connection*, map<string, unique_ptr<sql::PreparedStatement>>> g_statementCache;
+
+    mutex g_schemaMutex;
+    map<sql::Connection*, string> g_schemaOf;  // sessions moved off DB_NAME by useSchema()
+
+    string schemaFor(sql::Connection* con) {
+        lock_guard<mutex> lock(g_schemaMutex);
+        auto it = g_schemaOf.find(con);
+        return it != g_schemaOf.end() ? it->second : getConfigValue("DB_NAME");
+    }
+}
+
+DbErrorClass classifyDbError(const sql::SQLException& e) {
+    switch (e.getErrorCode()) {
+    case 2002: // CR_CONNECTION_ERROR
+    case 2003: // CR_CONN_HOST_ERROR
+    case 2006: // CR_SERVER_GONE_ERROR
+    case 2013: // CR_SERVER_LOST
+    case 2055: // CR_SERVER_LOST_EXTENDED
+    case 1053: // ER_SERVER_SHUTDOWN
+        return DbErrorClass::ConnectionLost;
+    case 1205: // ER_LOCK_WAIT_TIMEOUT
+    case 1213: // ER_LOCK_DEADLOCK
+    case 1040: // ER_CON_COUNT_ERROR (too many connections)
+        return DbErrorClass::Transient;
+    default:
+        return DbErrorClass::Permanent;
+    }
+}
+
+int readRetryLimit() {
+    return getConfigInt("READ_RETRY_LIMIT", 3);
+}
+
+// Exponential backoff with jitter: base, 2x base, 4x base ... capped at 5 s
+void backoffSleep(int attempt) {
+    static thread_local mt19937 rng(random_device{}());
+    int baseMs = getConfigInt("RECONNECT_BASE_MS", 200);
+    long long delay = static_cast<long long>(baseMs) << (attempt < 5 ? attempt : 5);
+    if (delay > 5000) delay = 5000;
+    uniform_int_distribution<long long> jitter(0, delay / 2);
+    this_thread::sleep_for(chrono::milliseconds(delay / 2 + jitter(rng)));
+}
+
+bool reconnectWithBackoff(sql::Connection* con, int maxAttempts) {
+    if (maxAttempts <= 0) maxAttempts = getConfigInt("RECONNECT_ATTEMPTS", 5);
+
+    // Statements belong to the dead session; re-prepare lazily on the new one
+    releaseStatementCache(con);
+
+    for (int attempt = 0; attempt < maxAttempts; attempt++) {
+        if (attempt > 0) backoffSleep(attempt - 1);
+        try {
+            if (con->isValid() || con->reconnect()) {
+                con->setSchema(schemaFor(con));
+                markDatabaseOnline();
+                return true;
+            }
+        }
+        catch (sql::SQLException&) {
+            // Server still unreachable; try again after the next backoff step
+        }
+    }
+    markDatabaseOffline();
+    return false;
+}
+
+sql::PreparedStatement* cachedStatement(sql::Connection* con, const string& sql) {
+    lock_guard<mutex> lock(g_cacheMutex);
+    auto& perConnection = g_statementCache[con];
+    auto it = perConnection.find(sql);
+    if (it != perConnection.end()) return it->second.get();
+
+    sql::PreparedStatement* pstmt = con->prepareStatement(sql);
+    perConnection[sql].reset(pstmt);
+    return pstmt;
+}
+
+void useSchema(sql::Connection* con, const std::string& schema) {
+    releaseStatementCache(con);
+    lock_guard<mutex> lock(g_schemaMutex);
+    if (schema.empty()) {
+        g_schemaOf.erase(con);
+        return;
+    }
+    g_schemaOf[con] = schema;
+    con->setSchema(schema);
+}
+
+void releaseStatementCache(sql::Connection* con) {
+    lock_guard<mutex> lock(g_cacheMutex);
+    g_statementCache.erase(con);
+}
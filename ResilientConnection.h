@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <chrono>
+#include <mysql_connection.h>
+#include <cppconn/exception.h>
+#include <cppconn/prepared_statement.h>
+
+// ==========================================
+// RECONNECT & RETRY POLICY
+// ==========================================
+// Reads go through withReadRetry(): a lost link is reconnected with backoff and
+// the read is re-run, unless it is part of an open transaction. Writes go through runWrite(): they are never re-run
+// (the server may already have committed them), the link is repaired for the
+// next caller and the original exception is rethrown so the caller can journal
+// the write or tell the operator it was not saved.
+//
+// Tunables in config.ini: RECONNECT_ATTEMPTS, RECONNECT_BASE_MS, READ_RETRY_LIMIT.
+
+enum class DbErrorClass {
+    ConnectionLost, // Link gone: reconnect, then retry reads
+    Transient,      // Deadlock / lock wait timeout: back off and retry reads
+    Permanent       // Syntax, constraint, permission... never retried
+};
+
+DbErrorClass classifyDbError(const sql::SQLException& e);
+
+// Reconnects in place (the sql::Connection* stays valid) with exponential backoff.
+// maxAttempts <= 0 uses RECONNECT_ATTEMPTS. Cached statements for this connection
+// are dropped so they are re-prepared on the new session.
+bool reconnectWithBackoff(sql::Connection* con, int maxAttempts = 0);
+
+// Prepared statement cached per connection and SQL text. The pointer is owned by
+// the cache and stays valid until the connection reconnects or is released.
+sql::PreparedStatement* cachedStatement(sql::Connection* con, const std::string& sql);
+
+// Moves a session to another schema (the benchmarks' scratch schemas); a
+// reconnect returns it there instead of to DB_NAME. "" forgets the session
+// (call before deleting it).
+void useSchema(sql::Connection* con, const std::string& schema);
+
+// Drop every cached statement for a connection (call before deleting it)
+void releaseStatementCache(sql::Connection* con);
+
+int readRetryLimit();
+void backoffSleep(int attempt);
+
+// Runs an idempotent read, retrying transient failures and reconnecting lost
+// links. Inside a transaction it runs once: a deadlock has already rolled the
+// transaction back and a reconnect would drop it, so re-running the read alone
+// would mix its rows with a transaction that is gone. The caller sees the error.
+template <typename Fn>
+auto withReadRetry(sql::Connection* con, Fn fn) -> decltype(fn()) {
+    const int limit = con->getAutoCommit() ? readRetryLimit() : 0;
+    for (int attempt = 0; ; attempt++) {
+        try {
+            return fn();
+        }
+        catch (sql::SQLException& e) {
+            DbErrorClass kind = classifyDbError(e);
+            if (kind == DbErrorClass::Permanent || attempt >= limit) throw;
+            if (kind == DbErrorClass::ConnectionLost) {
+                if (!reconnectWithBackoff(con)) throw;
+            }
+            else {
+                backoffSleep(attempt);
+            }
+        }
+    }
+}
+
+// Runs a write exactly once; a lost link is repaired for the next call, then rethrown
+template <typename Fn>
+auto runWrite(sql::Connection* con, Fn fn) -> decltype(fn()) {
+    try {
+        return fn();
+    }
+    catch (sql::SQLException& e) {
+        if (classifyDbError(e) == DbErrorClass::ConnectionLost) {
+            reconnectWithBackoff(con, 1);
+        }
+        throw;
+    }
+}
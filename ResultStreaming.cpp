@@ -0,0 +1,261 @@
+#include "ResultStreaming.h"
+#include "ResilientConnection.h"
+#include "ReplicaRouting.h"
+#include "RowCounts.h"
+#include "db.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cppconn/exception.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// RESULT STREAM
+// ==========================================
+
+namespace {
+    // Sessions reserved for open streams; a listing holds one while it is on screen
+    ConnectionPool& streamPool() {
+        static ConnectionPool pool(2);
+        return pool;
+    }
+}
+
+std::string inlineParams(const std::string& sql, const std::vector<std::string>& values) {
+    string bound;
+    size_t next = 0;
+    for (char c : sql) {
+        if (c != '?' || next >= values.size()) {
+            bound += c;
+            continue;
+        }
+        bound += '\'';
+        for (char v : values[next++]) {
+            if (v == '\'' || v == '\\') bound += '\\';
+            bound += v;
+        }
+        bound += '\'';
+    }
+    return bound;
+}
+
+ResultStream::ResultStream(sql::Connection* con, const std::string& sql, StreamSource source)
+    : owner_(con) {
+    if (source == StreamSource::ReplicaFirst) {
+        // Not retried on the replica: a failure there moves the stream to the primary
+        lease_ = acquireReportReplica();
+        if (lease_) {
+            try {
+                open(lease_.get(), sql);
+                onReplica_ = true;
+                return;
+            }
+            catch (SQLException& e) {
+                replicaReadFailed(e);
+                res_.reset();
+                stmt_.reset();
+                sessionID_ = 0;
+                lease_ = ConnectionPool::Lease();
+            }
+        }
+    }
+
+    lease_ = streamPool().acquire();
+    Connection* session = lease_ ? lease_.get() : con;
+    withReadRetry(session, [&]() {
+        open(session, sql);
+        return 0;
+        });
+}
+
+void ResultStream::open(sql::Connection* session, const std::string& sql) {
+    stmt_.reset(session->createStatement());
+    if (lease_) {
+        stmt_->execute("SET SESSION net_write_timeout = " + to_string(getConfigInt("STREAM_WRITE_TIMEOUT_S", 3600)));
+        unique_ptr<ResultSet> id(stmt_->executeQuery("SELECT CONNECTION_ID()"));
+        sessionID_ = id->next() ? id->getInt64(1) : 0;
+    }
+    stmt_->setResultSetType(ResultSet::TYPE_FORWARD_ONLY);
+    res_.reset(stmt_->executeQuery(sql));
+}
+
+ResultStream::~ResultStream() {
+    close();
+}
+
+bool ResultStream::next() {
+    if (finished_ || !res_) return false;
+    if (!res_->next()) finished_ = true;
+    return !finished_;
+}
+
+void ResultStream::close() {
+    if (!res_) return;
+    // Otherwise freeing the result would read every row the server has left to send
+    if (!finished_) interrupt();
+    res_.reset();
+    stmt_.reset();
+    finished_ = true;
+    lease_ = ConnectionPool::Lease();
+}
+
+void ResultStream::interrupt() {
+    if (!lease_ || sessionID_ <= 0 || killed_.exchange(true)) return;
+    try {
+        if (onReplica_) {
+            killReplicaQuery(sessionID_);
+            return;
+        }
+        unique_ptr<Statement> kill(owner_->createStatement());
+        kill->execute("KILL QUERY " + to_string(sessionID_));
+    }
+    catch (SQLException&) {} // the remaining rows are drained instead
+}
+
+size_t processMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+#else
+    ifstream statm("/proc/self/statm");
+    size_t total = 0, resident = 0;
+    if (!(statm >> total >> resident)) return 0;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// ==========================================
+// MEMORY BENCHMARK
+// ==========================================
+
+namespace {
+    struct ReadRun {
+        double peakMB = 0.0;
+        double seconds = 0.0;
+        long long rows = 0;
+    };
+
+    // Decodes every column the way the payment listing does, sampling resident
+    // memory as it goes; `advance` moves to the next row
+    template <typename Advance>
+    void readAll(ResultSet& res, Advance advance, size_t base, size_t& peak, ReadRun& run) {
+        while (advance()) {
+            res.getInt("TransactionID");
+            res.getInt("UserID");
+            res.getInt("JobID");
+            res.getDouble("Amount");
+            res.getString("Method");
+            res.getString("PaymentStatus");
+            res.getString("TimeStamp");
+            if (++run.rows % 1000 == 0) peak = max(peak, processMemoryBytes());
+        }
+        peak = max(peak, processMemoryBytes());
+        run.peakMB = (peak > base ? peak - base : 0) / (1024.0 * 1024.0);
+    }
+
+    ReadRun streamedRun(Connection* con, const string& sql) {
+        ReadRun run;
+        size_t base = processMemoryBytes(), peak = base;
+        auto start = chrono::steady_clock::now();
+        ResultStream stream(con, sql);
+        peak = max(peak, processMemoryBytes());
+        readAll(stream.row(), [&]() { return stream.next(); }, base, peak, run);
+        run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return run;
+    }
+
+    ReadRun bufferedRun(Connection* con, const string& sql) {
+        ReadRun run;
+        size_t base = processMemoryBytes(), peak = base;
+        auto start = chrono::steady_clock::now();
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(sql));
+        peak = max(peak, processMemoryBytes());
+        readAll(*res, [&]() { return res->next(); }, base, peak, run);
+        run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return run;
+    }
+}
+
+void runStreamingMemoryBenchmark(sql::Connection* con) {
+    cout << "\n--- Streaming Memory Benchmark ---\n";
+    if (processMemoryBytes() == 0) {
+        cout << "[Error] Process memory cannot be read on this system.\n";
+        return;
+    }
+
+    long long payments = 0;
+    try {
+        payments = rowCount(con, "payment");
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] " << e.what() << endl;
+        return;
+    }
+    if (payments == 0) {
+        cout << "[Error] No payments to read. Seed a test database from Query Plan Check first.\n";
+        return;
+    }
+
+    int largest = readInt("Largest result in rows (e.g., 1000000): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (largest < 1000) {
+        cout << "[Error] Use at least 1000 rows.\n";
+        return;
+    }
+    // Each payment is repeated up to 1000 times so the result can outgrow the table
+    if (largest > payments * 1000) {
+        largest = static_cast<int>(payments * 1000);
+        cout << "Capped at " << largest << " rows (1000 x the payment table).\n";
+    }
+
+    vector<long long> sizes;
+    for (long long rows = 1000; rows < largest; rows *= 10) sizes.push_back(rows);
+    sizes.push_back(largest);
+
+    const string digits = "(SELECT 0 AS d UNION ALL SELECT 1 UNION ALL SELECT 2 UNION ALL SELECT 3 UNION ALL SELECT 4 "
+        "UNION ALL SELECT 5 UNION ALL SELECT 6 UNION ALL SELECT 7 UNION ALL SELECT 8 UNION ALL SELECT 9)";
+    auto query = [&](long long rows) {
+        return "SELECT p.TransactionID, p.UserID, p.JobID, p.Amount, p.Method, p.PaymentStatus, p.TimeStamp "
+            "FROM payment p CROSS JOIN " + digits + " a CROSS JOIN " + digits + " b CROSS JOIN " + digits + " c "
+            "LIMIT " + to_string(rows);
+    };
+
+    // Streamed runs first, so heap the buffered runs grow cannot hide their cost
+    vector<ReadRun> streamed, buffered;
+    try {
+        for (long long rows : sizes) streamed.push_back(streamedRun(con, query(rows)));
+        for (long long rows : sizes) buffered.push_back(bufferedRun(con, query(rows)));
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Benchmark stopped: " << e.what() << endl;
+        return;
+    }
+
+    cout << "\n" << right << setw(12) << "Rows" << setw(18) << "Buffered peak MB" << setw(18) << "Streamed peak MB"
+        << setw(14) << "Buffered s" << setw(14) << "Streamed s" << "\n";
+    cout << string(76, '-') << "\n";
+    for (size_t i = 0; i < sizes.size(); i++) {
+        cout << setw(12) << sizes[i] << fixed << setprecision(1) << setw(18) << buffered[i].peakMB
+            << setw(18) << streamed[i].peakMB << setprecision(2) << setw(14) << buffered[i].seconds
+            << setw(14) << streamed[i].seconds << "\n";
+    }
+    cout << "(Peak growth in resident memory over each read. The streamed column should stay flat.)\n";
+}
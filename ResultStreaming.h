@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+#include <cppconn/statement.h>
+#include <cppconn/resultset.h>
+#include "ConnectionPool.h"
+
+// ==========================================
+// UNBUFFERED RESULT STREAMING
+// ==========================================
+// A default result set is read into client memory in full before next() returns
+// the first row, so listing every payment costs memory in proportion to the table.
+// ResultStream runs the query as a forward-only result on a plain Statement,
+// which the connector reads from the socket one row at a time: client memory
+// stays at one row plus the network buffer however many rows the query returns.
+// (The connector ignores setFetchSize, so row-at-a-time is the only
+// unbuffered mode it offers.)
+//
+// While a stream is open, its session cannot run anything else. So each stream
+// runs on a session from a small pool of its own, and the caller's connection
+// stays free. The server waits for the reader, so those sessions raise
+// net_write_timeout to STREAM_WRITE_TIMEOUT_S so the operator can pause on a
+// page. Closing a stream early kills the query from the caller's connection,
+// which avoids pulling every remaining row just to discard it.
+//
+// Listings may stream from the read replica instead (StreamSource::ReplicaFirst,
+// under the rules in ReplicaRouting.h). If the replica is behind or the query
+// fails there, the stream opens on the primary as usual. A replica query is
+// killed from another replica session, because KILL only reaches the server
+// it is sent to.
+//
+// Only plain statements stream: prepared statements are always buffered, so
+// streamed queries take no parameters; inlineParams() fills the placeholders.
+
+enum class StreamSource { Primary, ReplicaFirst };
+
+class ResultStream {
+public:
+    // Throws sql::SQLException if the query fails. If no stream session can be
+    // opened, the query runs unbuffered on `con` itself.
+    ResultStream(sql::Connection* con, const std::string& sql, StreamSource source = StreamSource::Primary);
+    ~ResultStream();
+    ResultStream(const ResultStream&) = delete;
+    ResultStream& operator=(const ResultStream&) = delete;
+
+    bool next();
+    sql::ResultSet& row() { return *res_; }
+
+    // Abandon the remaining rows (also done by the destructor)
+    void close();
+
+    // Kills the running query from the caller's connection so a next() blocked
+    // on another thread returns. The caller's connection must be otherwise idle.
+    void interrupt();
+
+private:
+    void open(sql::Connection* session, const std::string& sql);
+
+    sql::Connection* owner_;
+    ConnectionPool::Lease lease_;
+    std::unique_ptr<sql::Statement> stmt_;
+    std::unique_ptr<sql::ResultSet> res_;
+    long long sessionID_ = 0;
+    bool onReplica_ = false;
+    bool finished_ = false;
+    std::atomic<bool> killed_{ false };
+};
+
+// `sql` with each ? replaced, in order, by the next of `values` as a quoted
+// literal. For values the program generates (dates, sample IDs), not user text.
+std::string inlineParams(const std::string& sql, const std::vector<std::string>& values);
+
+// Resident memory of this process in bytes (0 if unavailable)
+size_t processMemoryBytes();
+
+// System Maintenance command: peak client memory of buffered vs streamed reads
+// as the result grows
+void runStreamingMemoryBenchmark(sql::Connection* con);
@@ -0,0 +1,59 @@
+#include "RowCounts.h"
+#include "ResilientConnection.h"
+#include "QueryPlanCheck.h"
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+
+using namespace std;
+using namespace sql;
+
+namespace {
+    // A counter is the sum of its slots; no row at all means no counter
+    const char* const SQL_ROW_COUNT =
+        "SELECT SUM(RowCount) AS RowCount FROM row_counts WHERE Name = ? GROUP BY Name";
+    const PlanRegistration planRowCount("row_count", "RowCounts.cpp", SQL_ROW_COUNT, { "user:Customer" });
+}
+
+long long rowCount(sql::Connection* con, const std::string& table, const std::string& role) {
+    const string name = role.empty() ? table : table + ":" + role;
+    return withReadRetry(con, [&]() -> long long {
+        PreparedStatement* pstmt = cachedStatement(con, SQL_ROW_COUNT);
+        pstmt->setString(1, name);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        if (res->next()) return res->getInt64("RowCount");
+
+        // No counter yet (an unused role reads 0 once the table is seeded)
+        PreparedStatement* seeded = cachedStatement(con, "SELECT 1 FROM row_counts WHERE Name = ?");
+        seeded->setString(1, table);
+        unique_ptr<ResultSet> seededRes(seeded->executeQuery());
+        if (seededRes->next()) return 0;
+
+        PreparedStatement* count = cachedStatement(con, role.empty()
+            ? "SELECT COUNT(*) FROM `" + table + "`"
+            : "SELECT COUNT(*) FROM `" + table + "` WHERE Role = ?");
+        if (!role.empty()) count->setString(1, role);
+        unique_ptr<ResultSet> countRes(count->executeQuery());
+        return countRes->next() ? countRes->getInt64(1) : 0;
+        });
+}
+
+std::map<std::string, long long> userCountsByRole(sql::Connection* con) {
+    return withReadRetry(con, [&]() {
+        map<string, long long> counts;
+        PreparedStatement* pstmt = cachedStatement(con,
+            "SELECT Name, SUM(RowCount) AS RowCount FROM row_counts WHERE Name LIKE 'user:%' GROUP BY Name ORDER BY Name");
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        while (res->next()) counts[res->getString("Name").substr(5)] = res->getInt64("RowCount");
+        return counts;
+        });
+}
+
+void adjustRowCount(sql::Connection* con, const std::string& table, long long delta) {
+    // Slot 0 exists for every counted table (seeded by migration 14)
+    PreparedStatement* pstmt = cachedStatement(con, "UPDATE row_counts SET RowCount = RowCount + ? WHERE Name = ? AND Slot = 0");
+    pstmt->setInt64(1, delta);
+    pstmt->setString(2, table);
+    pstmt->executeUpdate();
+}
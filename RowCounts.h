@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <mysql_connection.h>
+
+// ==========================================
+// ROW COUNTERS (listing headers)
+// ==========================================
+// `row_counts` holds the exact size of user, printjob and payment, plus one
+// "user:<Role>" row per role. Triggers on those tables move the counters inside
+// the writing transaction, so every insert/delete path (stored procedures,
+// journal replay, server mode, archiving) keeps them exact and a rolled-back
+// write leaves them untouched. Headers sum a few primary-key rows instead of
+// scanning an index with COUNT(*). Schema migration 10 creates the table and
+// triggers and seeds them from a one-off count.
+//
+// Each counter is spread over 16 slot rows (migration 14), and a trigger
+// bumps the slot of its session (CONNECTION_ID() % 16). A counter row stays
+// locked until the writing transaction commits. With a single row, every job
+// insert and every replay batch queued behind the previous writer; now only
+// sessions that share a slot do.
+//
+// Rows that leave a table without a DELETE (EXCHANGE PARTITION) must be
+// subtracted by the caller with adjustRowCount().
+
+// Rows in `table`, or only those with `role` for the user table. Falls back to
+// COUNT(*) if the counter is missing (migration not applied). Throws sql::SQLException.
+long long rowCount(sql::Connection* con, const std::string& table, const std::string& role = "");
+
+// Role -> user count, for every role that has had a user
+std::map<std::string, long long> userCountsByRole(sql::Connection* con);
+
+// Applies a delta in the caller's transaction (no-op for a table without a counter)
+void adjustRowCount(sql::Connection* con, const std::string& table, long long delta);
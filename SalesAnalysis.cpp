@@ -1,5 +1,7 @@
 #include "SalesAnalysis.h"
 #include "utils.h" // Assumes readInt, clearScreen, etc.
+#include "ShopRepository.h"
+#include "QueryPlanCheck.h"
 #include <iostream>
 #include <iomanip>
 #include <limits>
@@ -9,12 +11,17 @@
 using namespace std;
 using namespace sql;
 
+namespace {
+    const char* const SQL_TOTAL_REVENUE = "SELECT SUM(Amount) AS TotalRevenue FROM payment WHERE PaymentStatus = 'Complete'";
+    const PlanRegistration planTotalRevenue("total_revenue", "SalesAnalysis.cpp", SQL_TOTAL_REVENUE, {});
+}
+
 // ==========================================
 // HELPER FUNCTION (Shared by Option 1 & 2)
 // ==========================================
 
 // Node OC1 / P2: Fetch/Compute OperationCost = SUM(QuantityUsed  UnitCost)
-double fetchOperationCost(sql::Connection* con) {
+Money fetchOperationCost(sql::Connection* con) {
     // SQL Query: Joins consumption_log and inventory to multiply QuantityUsed by UnitCost and sum the results.
     // NOTE: This assumes consumption_log and inventory are the only cost sources.
     const char* sql =
@@ -27,13 +34,13 @@ double fetchOperationCost(sql::Connection* con) {
         unique_ptr<ResultSet> res(stmt->executeQuery(sql));
 
         if (res->next()) {
-            return res->getDouble("OperationCost");
+            return getMoney(*res, "OperationCost");
         }
     }
     catch (SQLException& e) {
         cerr << "[Error] SQL Error fetching Operation Cost: " << e.what() << endl;
     }
-    return 0.0;
+    return Money();
 }
 
 // ==========================================
@@ -43,11 +50,10 @@ void calculateOperationCost(sql::Connection* con) {
     cout << "\n--- Calculate Operation Cost ---\n";
 
     // Node OC1: Fetch/Compute OperationCost
-    double operationCost = fetchOperationCost(con);
+    Money operationCost = fetchOperationCost(con);
 
     // Node OCX: Display Operation Cost
-    cout << "Total Operational Cost (from consumed inventory): $"
-        << fixed << setprecision(2) << operationCost << endl;
+    cout << "Total Operational Cost (from consumed inventory): $" << operationCost << endl;
 }
 
 // ==========================================
@@ -55,34 +61,28 @@ void calculateOperationCost(sql::Connection* con) {
 // ==========================================
 void calculateProfit(sql::Connection* con) {
     cout << "\n--- Calculate Profit ---\n";
-    double totalJobCost = 0.0;
-    double operationCost = 0.0;
 
-    // Node P1: Fetch TotalJobCost = SUM(JobCost)
+    // Nodes P1 + P2: TotalJobCost, OperationCost (and collected revenue) in one repository call
+    SalesTotals totals;
     try {
-        unique_ptr<Statement> stmt(con->createStatement());
-        unique_ptr<ResultSet> res(stmt->executeQuery("SELECT SUM(JobCost) AS TotalJobCost FROM printjob"));
-
-        if (res->next()) {
-            totalJobCost = res->getDouble("TotalJobCost");
-        }
+        totals = makeShopRepository(con)->salesTotals();
     }
-    catch (SQLException& e) {
-        cerr << "[Error] SQL Error fetching Total Job Cost: " << e.what() << endl;
+    catch (exception& e) {
+        cerr << "[Error] SQL Error fetching sales totals: " << e.what() << endl;
         return;
     }
-
-    // Node P2: Fetch OperationCost (calls helper)
-    operationCost = fetchOperationCost(con);
+    Money totalJobCost = totals.jobCost;
+    Money operationCost = totals.operationCost;
 
     // Node P3: Compute Profit = TotalJobCost - OperationCost
-    double profit = totalJobCost - operationCost;
+    Money profit = totalJobCost - operationCost;
 
     // Node PX: Display Results
-    cout << left << setw(30) << "Total Revenue (Job Costs):" << "$" << fixed << setprecision(2) << totalJobCost << endl;
-    cout << left << setw(30) << "(-) Total Operational Cost:" << "$" << fixed << setprecision(2) << operationCost << endl;
+    cout << left << setw(30) << "Total Revenue (Job Costs):" << "$" << totalJobCost << endl;
+    cout << left << setw(30) << "(-) Total Operational Cost:" << "$" << operationCost << endl;
     cout << "------------------------------------------\n";
-    cout << left << setw(30) << "Net Profit:" << "$" << fixed << setprecision(2) << profit << endl;
+    cout << left << setw(30) << "Net Profit:" << "$" << profit << endl;
+    cout << left << setw(30) << "Collected (Complete):" << "$" << totals.revenue << endl;
 }
 
 
@@ -91,18 +91,18 @@ void calculateProfit(sql::Connection* con) {
 // ==========================================
 void calculateTotalRevenue(sql::Connection* con) {
     cout << "\n--- Calculate Total Revenue ---\n";
-    double revenue = 0.0;
+    Money revenue;
 
     // Node R1: Fetch Revenue = SUM(Amount WHERE Status = 'Complete')
     // NOTE: This assumes PaymentStatus is the column name based on your previous fix.
     try {
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT SUM(Amount) AS TotalRevenue FROM payment WHERE PaymentStatus = 'Complete'")
+            con->prepareStatement(SQL_TOTAL_REVENUE)
         );
         unique_ptr<ResultSet> res(pstmt->executeQuery());
 
         if (res->next()) {
-            revenue = res->getDouble("TotalRevenue");
+            revenue = getMoney(*res, "TotalRevenue");
         }
     }
     catch (SQLException& e) {
@@ -111,8 +111,7 @@ void calculateTotalRevenue(sql::Connection* con) {
     }
 
     // Node RX: Display Revenue
-    cout << "Total Revenue (Sum of ALL 'Complete' Payments): $"
-        << fixed << setprecision(2) << revenue << endl;
+    cout << "Total Revenue (Sum of ALL 'Complete' Payments): $" << revenue << endl;
 }
 
 // ==========================================
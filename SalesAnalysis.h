@@ -6,6 +6,7 @@
 #include <cppconn/resultset.h>
 #include <cppconn/statement.h>
 #include <cppconn/prepared_statement.h>
+#include "Money.h"
 
 // ==========================================
 // FUNCTION DECLARATIONS
@@ -20,4 +21,4 @@ void calculateProfit(sql::Connection* con);
 void calculateTotalRevenue(sql::Connection* con);
 
 // Helper function for cost (used by multiple options)
-double fetchOperationCost(sql::Connection* con);
\ No newline at end of file
+Money fetchOperationCost(sql::Connection* con);
\ No newline at end of file
@@ -0,0 +1,561 @@
+#include "SchemaMigrations.h"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// EXPECTED INDEXES
+// ==========================================
+
+const std::vector<ExpectedIndex>& expectedIndexes() {
+    static const vector<ExpectedIndex> indexes = {
+        { "user", "idx_user_fullname", "FullName", "login, customer name search" },
+        { "user", "idx_user_role", "Role", "customer lists and counts" },
+        { "printjob", "idx_printjob_user_time", "UserID,TimeStamp", "listJobsForUser" },
+        { "printjob", "idx_printjob_queue", "Status,Priority,JobID", "print queue load" },
+        { "payment", "idx_payment_user_time", "UserID,TimeStamp", "listPaymentsForUser" },
+        { "payment", "idx_payment_job", "JobID", "duplicate payment check, unpaid jobs" },
+        { "payment", "idx_payment_status_time", "PaymentStatus,TimeStamp", "sales reports" },
+        { "inventory", "idx_inventory_itemtype", "ItemType", "stock lookup by item type" },
+        { "inventoryconsumption", "idx_consumption_item_time", "InventoryID,TimeStamp", "consumption totals per item" },
+        { "inventoryconsumption", "idx_consumption_time", "TimeStamp", "monthly cost report, rollup rebuild" },
+    };
+    return indexes;
+}
+
+// ==========================================
+// MIGRATIONS
+// ==========================================
+
+namespace {
+    void execute(Connection* con, const string& sql) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        stmt->execute(sql);
+    }
+
+    long long countRows(Connection* con, const string& sql) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(sql));
+        return res->next() ? res->getInt64(1) : 0;
+    }
+
+    // 1. Core tables, as the modules use them. payment and inventoryconsumption
+    // carry no foreign keys so they can be partitioned (TablePartitioning.h).
+    void createBaseTables(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS `user` ("
+            "UserID INT NOT NULL AUTO_INCREMENT PRIMARY KEY, "
+            "FullName VARCHAR(100) NOT NULL, "
+            "Email VARCHAR(100) NULL, "
+            "Password VARCHAR(255) NOT NULL, "
+            "Role ENUM('Admin', 'Staff', 'Customer') NOT NULL DEFAULT 'Customer')");
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS printjob ("
+            "JobID INT NOT NULL AUTO_INCREMENT PRIMARY KEY, "
+            "UserID INT NOT NULL, "
+            "PageCount INT NOT NULL, "
+            "CostPerPage DECIMAL(10,2) NOT NULL, "
+            "JobCost DECIMAL(12,2) AS (PageCount * CostPerPage) STORED, "
+            "TimeStamp DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP, "
+            "CONSTRAINT fk_printjob_user FOREIGN KEY (UserID) REFERENCES `user` (UserID))");
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS payment ("
+            "TransactionID INT NOT NULL AUTO_INCREMENT PRIMARY KEY, "
+            "UserID INT NOT NULL, "
+            "JobID INT NOT NULL, "
+            "Amount DECIMAL(12,2) NOT NULL, "
+            "Method VARCHAR(30) NOT NULL, "
+            "PaymentStatus VARCHAR(20) NOT NULL, "
+            "TimeStamp DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP)");
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS inventory ("
+            "InventoryID INT NOT NULL AUTO_INCREMENT PRIMARY KEY, "
+            "ItemType VARCHAR(50) NOT NULL, "
+            "Quantity INT NOT NULL DEFAULT 0, "
+            "UnitCost DECIMAL(10,2) NOT NULL DEFAULT 0, "
+            "TimeStamp DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP)");
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS inventoryconsumption ("
+            "ConsumptionID BIGINT NOT NULL AUTO_INCREMENT PRIMARY KEY, "
+            "InventoryID INT NOT NULL, "
+            "QuantityUsed INT NOT NULL, "
+            "TimeStamp DATETIME NOT NULL DEFAULT CURRENT_TIMESTAMP)");
+
+        // A fresh install starts with the two items every print job draws from
+        if (countRows(con, "SELECT COUNT(*) FROM inventory") == 0) {
+            execute(con, "INSERT INTO inventory (ItemType, Quantity, UnitCost) VALUES ('Paper', 0, 0), ('Ink', 0, 0)");
+        }
+    }
+
+    // 2. Print queue lifecycle. Rows that existed before are history, so they
+    // land as Done; new rows default to Queued.
+    void addPrintQueueColumns(Connection* con) {
+        if (countRows(con,
+            "SELECT COUNT(*) FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'printjob' AND COLUMN_NAME = 'Status'") > 0) return;
+
+        execute(con,
+            "ALTER TABLE printjob "
+            "ADD COLUMN Status ENUM('Queued', 'Printing', 'Done') NOT NULL DEFAULT 'Done', "
+            "ADD COLUMN Priority TINYINT NOT NULL DEFAULT 0, "
+            "ADD COLUMN StartedAt DATETIME NULL, "
+            "ADD COLUMN CompletedAt DATETIME NULL, "
+            "ADD INDEX idx_printjob_queue (Status, Priority, JobID)");
+        execute(con, "ALTER TABLE printjob ALTER COLUMN Status SET DEFAULT 'Queued'");
+    }
+
+    // 3. Idempotency keys of replayed offline journal entries
+    void createJournalApplied(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS journal_applied ("
+            "IdemKey VARCHAR(64) NOT NULL PRIMARY KEY, "
+            "AppliedAt TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP)");
+    }
+
+    // 4. Daily consumption rollup and its watermark
+    void createConsumptionRollup(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS consumption_daily ("
+            "InventoryID INT NOT NULL, "
+            "Day DATE NOT NULL, "
+            "QuantityUsed BIGINT NOT NULL DEFAULT 0, "
+            "PRIMARY KEY (InventoryID, Day))");
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS rollup_watermark ("
+            "Name VARCHAR(64) NOT NULL PRIMARY KEY, "
+            "LastID BIGINT NOT NULL)");
+    }
+
+    // 5. Bill of materials, seeded with the Standard job's Paper/Ink ratios
+    void createBillOfMaterials(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS job_bom ("
+            "JobType VARCHAR(32) NOT NULL, "
+            "InventoryID INT NOT NULL, "
+            "UnitsPerPage DECIMAL(10,4) NOT NULL, "
+            "PRIMARY KEY (JobType, InventoryID))");
+        if (countRows(con, "SELECT COUNT(*) FROM job_bom") > 0) return;
+
+        const struct { const char* itemType; const char* unitsPerPage; } defaults[] = {
+            { "Paper", "1.0000" }, { "Ink", "0.0100" }
+        };
+        for (const auto& item : defaults) {
+            unique_ptr<PreparedStatement> seed(con->prepareStatement(
+                "INSERT INTO job_bom (JobType, InventoryID, UnitsPerPage) "
+                "SELECT 'Standard', MIN(InventoryID), ? FROM inventory WHERE ItemType = ? HAVING MIN(InventoryID) IS NOT NULL"
+            ));
+            seed->setString(1, item.unitsPerPage);
+            seed->setString(2, item.itemType);
+            seed->executeUpdate();
+        }
+    }
+
+    // 6. Monthly aggregates of archived rows (ColdArchive.h)
+    void createArchiveAggregates(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS payment_monthly_archive ("
+            "Year SMALLINT NOT NULL, "
+            "Month TINYINT NOT NULL, "
+            "CompleteCount BIGINT NOT NULL DEFAULT 0, "
+            "CompleteAmount DECIMAL(14,2) NOT NULL DEFAULT 0, "
+            "PRIMARY KEY (Year, Month))");
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS consumption_monthly_archive ("
+            "InventoryID INT NOT NULL, "
+            "Year SMALLINT NOT NULL, "
+            "Month TINYINT NOT NULL, "
+            "QuantityUsed BIGINT NOT NULL DEFAULT 0, "
+            "PRIMARY KEY (Year, Month, InventoryID))");
+    }
+
+    // 7. Indexes behind each module's lookups (an existing index with the same
+    // leading columns, e.g. one created for a foreign key, is reused)
+    void createQueryIndexes(Connection* con) {
+        for (const ExpectedIndex& index : findMissingIndexes(con)) {
+            string columns;
+            string list = index.columns;
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = list.find(',', start);
+                if (comma == string::npos) comma = list.size();
+                columns += (columns.empty() ? "`" : ", `") + list.substr(start, comma - start) + "`";
+                start = comma + 1;
+            }
+            execute(con, string("ALTER TABLE `") + index.table + "` ADD INDEX " + index.name + " (" + columns + ")");
+        }
+    }
+
+    // 8. Multi-step business writes as one CALL each (StoredProcedures.h). A
+    // later change to a procedure is a new migration that drops and recreates it.
+    // Material units follow unitsForPages(): per-10k-page rate, rounded up.
+    void createBusinessProcedures(Connection* con) {
+        const string units = "CEIL(p_pages * ROUND(b.UnitsPerPage * 10000) / 10000)";
+        const string oldUnits = "CEIL(v_old_pages * ROUND(b.UnitsPerPage * 10000) / 10000)";
+        const string delta = "(" + units + " - " + oldUnits + ")";
+
+        execute(con, "DROP PROCEDURE IF EXISTS sp_create_job");
+        execute(con,
+            "CREATE PROCEDURE sp_create_job("
+            "  IN p_user INT, IN p_pages INT, IN p_cost_per_page DECIMAL(10,2), IN p_time DATETIME, IN p_job_type VARCHAR(32), "
+            "  OUT p_job_id INT, OUT p_job_cost DECIMAL(12,2), OUT p_error VARCHAR(255)) "
+            "BEGIN "
+            "  DECLARE v_lines INT DEFAULT 0; "
+            "  DECLARE EXIT HANDLER FOR SQLEXCEPTION BEGIN ROLLBACK; RESIGNAL; END; "
+            "  SET p_job_id = NULL, p_job_cost = NULL, p_error = NULL; "
+            "  SELECT COUNT(*) INTO v_lines FROM job_bom b WHERE b.JobType = p_job_type AND " + units + " > 0; "
+            "  START TRANSACTION; "
+            // Guarded decrement: every line must find enough stock, or nothing is written
+            "  UPDATE inventory i JOIN job_bom b ON b.InventoryID = i.InventoryID AND b.JobType = p_job_type "
+            "     SET i.Quantity = i.Quantity - " + units + " "
+            "   WHERE " + units + " > 0 AND i.Quantity >= " + units + "; "
+            "  IF ROW_COUNT() < v_lines THEN "
+            "    ROLLBACK; "
+            "    SELECT CONCAT('Insufficient ', i.ItemType, '. Need: ', " + units + ", ', Have: ', i.Quantity) INTO p_error "
+            "      FROM job_bom b JOIN inventory i ON i.InventoryID = b.InventoryID "
+            "     WHERE b.JobType = p_job_type AND i.Quantity < " + units + " ORDER BY b.InventoryID LIMIT 1; "
+            "    SET p_error = IFNULL(p_error, 'Insufficient inventory.'); "
+            "  ELSE "
+            "    INSERT INTO printjob (UserID, PageCount, CostPerPage, TimeStamp) "
+            "      VALUES (p_user, p_pages, p_cost_per_page, IFNULL(p_time, NOW())); "
+            "    SET p_job_id = LAST_INSERT_ID(); "
+            "    INSERT INTO inventoryconsumption (InventoryID, QuantityUsed) "
+            "      SELECT b.InventoryID, " + units + " FROM job_bom b WHERE b.JobType = p_job_type AND " + units + " > 0; "
+            "    SELECT JobCost INTO p_job_cost FROM printjob WHERE JobID = p_job_id; "
+            "    COMMIT; "
+            "  END IF; "
+            "  SELECT p_job_id AS JobID, p_job_cost AS JobCost, p_error AS Error; "
+            "END");
+
+        execute(con, "DROP PROCEDURE IF EXISTS sp_update_job");
+        execute(con,
+            "CREATE PROCEDURE sp_update_job("
+            "  IN p_job INT, IN p_pages INT, IN p_cost_per_page DECIMAL(10,2), IN p_job_type VARCHAR(32), "
+            "  OUT p_old_pages INT, OUT p_error VARCHAR(255)) "
+            "BEGIN "
+            "  DECLARE v_old_pages INT DEFAULT NULL; "
+            "  DECLARE v_lines INT DEFAULT 0; "
+            "  DECLARE EXIT HANDLER FOR SQLEXCEPTION BEGIN ROLLBACK; RESIGNAL; END; "
+            "  SET p_old_pages = NULL, p_error = NULL; "
+            "  START TRANSACTION; "
+            "  SELECT PageCount INTO v_old_pages FROM printjob WHERE JobID = p_job FOR UPDATE; "
+            "  IF v_old_pages IS NULL THEN "
+            "    ROLLBACK; "
+            "    SET p_error = 'Job ID not found.'; "
+            "  ELSE "
+            "    SET p_old_pages = v_old_pages; "
+            // Only the per-item difference moves; a smaller job gives stock back
+            "    IF p_pages > 0 AND p_pages <> v_old_pages THEN "
+            "      SELECT COUNT(*) INTO v_lines FROM job_bom b WHERE b.JobType = p_job_type AND " + delta + " <> 0; "
+            "      UPDATE inventory i JOIN job_bom b ON b.InventoryID = i.InventoryID AND b.JobType = p_job_type "
+            "         SET i.Quantity = i.Quantity - " + delta + " "
+            "       WHERE " + delta + " <> 0 AND i.Quantity >= " + delta + "; "
+            "      IF ROW_COUNT() < v_lines THEN "
+            "        ROLLBACK; "
+            "        SELECT CONCAT('Insufficient ', i.ItemType, '. Need: ', " + delta + ", ', Have: ', i.Quantity) INTO p_error "
+            "          FROM job_bom b JOIN inventory i ON i.InventoryID = b.InventoryID "
+            "         WHERE b.JobType = p_job_type AND i.Quantity < " + delta + " ORDER BY b.InventoryID LIMIT 1; "
+            "        SET p_error = IFNULL(p_error, 'Insufficient inventory.'); "
+            "      END IF; "
+            "    END IF; "
+            "    IF p_error IS NULL THEN "
+            "      UPDATE printjob SET PageCount = IF(p_pages > 0, p_pages, PageCount), "
+            "        CostPerPage = IF(p_cost_per_page > 0, p_cost_per_page, CostPerPage) WHERE JobID = p_job; "
+            "      COMMIT; "
+            "    END IF; "
+            "  END IF; "
+            "  SELECT p_old_pages AS OldPageCount, p_error AS Error; "
+            "END");
+
+        execute(con, "DROP PROCEDURE IF EXISTS sp_create_payment");
+        execute(con,
+            "CREATE PROCEDURE sp_create_payment("
+            "  IN p_user INT, IN p_job INT, IN p_amount DECIMAL(12,2), IN p_method VARCHAR(30), IN p_time DATETIME, "
+            "  OUT p_transaction_id INT, OUT p_status VARCHAR(20), OUT p_job_cost DECIMAL(12,2), OUT p_error VARCHAR(255)) "
+            "BEGIN "
+            "  DECLARE EXIT HANDLER FOR SQLEXCEPTION BEGIN ROLLBACK; RESIGNAL; END; "
+            "  SET p_transaction_id = NULL, p_status = NULL, p_job_cost = NULL, p_error = NULL; "
+            "  START TRANSACTION; "
+            // Locking the job row keeps two terminals from paying the same job
+            "  SELECT JobCost INTO p_job_cost FROM printjob WHERE JobID = p_job AND UserID = p_user FOR UPDATE; "
+            "  IF p_job_cost IS NULL THEN "
+            "    ROLLBACK; "
+            "    SET p_error = CONCAT('Job ', p_job, ' not found for User ', p_user, '.'); "
+            "  ELSEIF EXISTS (SELECT 1 FROM payment WHERE JobID = p_job) THEN "
+            "    ROLLBACK; "
+            "    SET p_error = CONCAT('Job ', p_job, ' already has a payment.'); "
+            "  ELSE "
+            "    SET p_status = IF(p_amount >= p_job_cost, 'Complete', 'Insufficient'); "
+            "    INSERT INTO payment (UserID, JobID, Amount, Method, PaymentStatus, TimeStamp) "
+            "      VALUES (p_user, p_job, p_amount, p_method, p_status, IFNULL(p_time, NOW())); "
+            "    SET p_transaction_id = LAST_INSERT_ID(); "
+            "    COMMIT; "
+            "  END IF; "
+            "  SELECT p_transaction_id AS TransactionID, p_status AS PaymentStatus, p_job_cost AS JobCost, p_error AS Error; "
+            "END");
+    }
+
+    // 9. Change stamps for in-memory snapshots (CustomerDirectory.h)
+    void createTableVersions(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS table_versions ("
+            "Name VARCHAR(64) NOT NULL PRIMARY KEY, "
+            "Version BIGINT NOT NULL DEFAULT 0)");
+        execute(con, "INSERT IGNORE INTO table_versions (Name, Version) VALUES ('customer_directory', 0)");
+    }
+
+    // 10. Exact row counts kept by triggers (RowCounts.h)
+    void createRowCounters(Connection* con) {
+        execute(con,
+            "CREATE TABLE IF NOT EXISTS row_counts ("
+            "Name VARCHAR(64) NOT NULL PRIMARY KEY, "
+            "RowCount BIGINT NOT NULL DEFAULT 0)");
+
+        // +1 / -1 on a counter row, creating it for a first-seen role
+        auto bump = [](const string& name, int delta) {
+            return "INSERT INTO row_counts (Name, RowCount) VALUES (" + name + ", " + to_string(delta) + ") "
+                "ON DUPLICATE KEY UPDATE RowCount = RowCount + (" + to_string(delta) + ")";
+        };
+        for (const char* table : { "printjob", "payment" }) {
+            const string quoted = string("'") + table + "'";
+            execute(con, string("DROP TRIGGER IF EXISTS trg_") + table + "_count_insert");
+            execute(con, string("CREATE TRIGGER trg_") + table + "_count_insert AFTER INSERT ON `" + table + "` "
+                "FOR EACH ROW " + bump(quoted, 1));
+            execute(con, string("DROP TRIGGER IF EXISTS trg_") + table + "_count_delete");
+            execute(con, string("CREATE TRIGGER trg_") + table + "_count_delete AFTER DELETE ON `" + table + "` "
+                "FOR EACH ROW " + bump(quoted, -1));
+        }
+        execute(con, "DROP TRIGGER IF EXISTS trg_user_count_insert");
+        execute(con, "CREATE TRIGGER trg_user_count_insert AFTER INSERT ON `user` FOR EACH ROW BEGIN "
+            + bump("'user'", 1) + "; " + bump("CONCAT('user:', NEW.Role)", 1) + "; END");
+        execute(con, "DROP TRIGGER IF EXISTS trg_user_count_delete");
+        execute(con, "CREATE TRIGGER trg_user_count_delete AFTER DELETE ON `user` FOR EACH ROW BEGIN "
+            + bump("'user'", -1) + "; " + bump("CONCAT('user:', OLD.Role)", -1) + "; END");
+        execute(con, "DROP TRIGGER IF EXISTS trg_user_count_update");
+        execute(con, "CREATE TRIGGER trg_user_count_update AFTER UPDATE ON `user` FOR EACH ROW "
+            "IF NOT (NEW.Role <=> OLD.Role) THEN "
+            + bump("CONCAT('user:', OLD.Role)", -1) + "; " + bump("CONCAT('user:', NEW.Role)", 1) + "; END IF");
+
+        // Seed with writers held off, so no row is both counted here and by a trigger
+        execute(con, "LOCK TABLES row_counts WRITE, `user` READ, printjob READ, payment READ");
+        try {
+            execute(con, "DELETE FROM row_counts");
+            // One table reference per statement: LOCK TABLES allows no second one
+            execute(con, "INSERT INTO row_counts (Name, RowCount) SELECT CONCAT('user:', Role), COUNT(*) FROM `user` GROUP BY Role");
+            for (const char* table : { "user", "printjob", "payment" }) {
+                execute(con, string("INSERT INTO row_counts (Name, RowCount) SELECT '") + table + "', COUNT(*) FROM `" + table + "`");
+            }
+            execute(con, "UNLOCK TABLES");
+        }
+        catch (SQLException&) {
+            execute(con, "UNLOCK TABLES");
+            throw;
+        }
+    }
+
+    // 11. Change stamp for the payment analytics store (PaymentAnalytics.h)
+    void addPaymentHistoryVersion(Connection* con) {
+        execute(con, "INSERT IGNORE INTO table_versions (Name, Version) VALUES ('payment_history', 0)");
+    }
+
+    // 12. Only the server's printer queue reads Queued rows, so a job lands as
+    // Done unless the code that writes it hands it to a queue (insertPrintJobRecord)
+    void restorePrintJobDoneDefault(Connection* con) {
+        execute(con, "ALTER TABLE printjob ALTER COLUMN Status SET DEFAULT 'Done'");
+    }
+
+    // 13. The consumption rollup folds a log range only after it has settled
+    // (ConsumptionForecast.h)
+    void addRollupSettling(Connection* con) {
+        if (countRows(con,
+            "SELECT COUNT(*) FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'rollup_watermark' AND COLUMN_NAME = 'SettlingID'") > 0) return;
+
+        execute(con,
+            "ALTER TABLE rollup_watermark "
+            "ADD COLUMN SettlingID BIGINT NOT NULL DEFAULT 0, "
+            "ADD COLUMN SettlingSince DATETIME NULL");
+    }
+
+    // 14. Each counter spread over ROW_COUNT_SLOTS rows, so concurrent writers to
+    // one table no longer queue on a single row lock until they commit (RowCounts.h)
+    const int ROW_COUNT_SLOTS = 16;
+
+    void spreadRowCounters(Connection* con) {
+        if (countRows(con,
+            "SELECT COUNT(*) FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = 'row_counts' AND COLUMN_NAME = 'Slot'") == 0) {
+            // Existing rows become slot 0; the old triggers keep writing there until replaced
+            execute(con,
+                "ALTER TABLE row_counts "
+                "ADD COLUMN Slot TINYINT UNSIGNED NOT NULL DEFAULT 0, "
+                "DROP PRIMARY KEY, ADD PRIMARY KEY (Name, Slot)");
+        }
+
+        // A session keeps to one slot, so its own rows never wait on each other
+        auto bump = [](const string& name, int delta) {
+            return "INSERT INTO row_counts (Name, Slot, RowCount) VALUES (" + name + ", CONNECTION_ID() % "
+                + to_string(ROW_COUNT_SLOTS) + ", " + to_string(delta) + ") "
+                "ON DUPLICATE KEY UPDATE RowCount = RowCount + (" + to_string(delta) + ")";
+        };
+        for (const char* table : { "printjob", "payment" }) {
+            const string quoted = string("'") + table + "'";
+            execute(con, string("DROP TRIGGER IF EXISTS trg_") + table + "_count_insert");
+            execute(con, string("CREATE TRIGGER trg_") + table + "_count_insert AFTER INSERT ON `" + table + "` "
+                "FOR EACH ROW " + bump(quoted, 1));
+            execute(con, string("DROP TRIGGER IF EXISTS trg_") + table + "_count_delete");
+            execute(con, string("CREATE TRIGGER trg_") + table + "_count_delete AFTER DELETE ON `" + table + "` "
+                "FOR EACH ROW " + bump(quoted, -1));
+        }
+        execute(con, "DROP TRIGGER IF EXISTS trg_user_count_insert");
+        execute(con, "CREATE TRIGGER trg_user_count_insert AFTER INSERT ON `user` FOR EACH ROW BEGIN "
+            + bump("'user'", 1) + "; " + bump("CONCAT('user:', NEW.Role)", 1) + "; END");
+        execute(con, "DROP TRIGGER IF EXISTS trg_user_count_delete");
+        execute(con, "CREATE TRIGGER trg_user_count_delete AFTER DELETE ON `user` FOR EACH ROW BEGIN "
+            + bump("'user'", -1) + "; " + bump("CONCAT('user:', OLD.Role)", -1) + "; END");
+        execute(con, "DROP TRIGGER IF EXISTS trg_user_count_update");
+        execute(con, "CREATE TRIGGER trg_user_count_update AFTER UPDATE ON `user` FOR EACH ROW "
+            "IF NOT (NEW.Role <=> OLD.Role) THEN "
+            + bump("CONCAT('user:', OLD.Role)", -1) + "; " + bump("CONCAT('user:', NEW.Role)", 1) + "; END IF");
+
+        // Writes between a DROP and its CREATE went uncounted: reseed into slot 0
+        // with writers held off, as migration 10 did
+        execute(con, "LOCK TABLES row_counts WRITE, `user` READ, printjob READ, payment READ");
+        try {
+            execute(con, "DELETE FROM row_counts");
+            execute(con, "INSERT INTO row_counts (Name, RowCount) SELECT CONCAT('user:', Role), COUNT(*) FROM `user` GROUP BY Role");
+            for (const char* table : { "user", "printjob", "payment" }) {
+                execute(con, string("INSERT INTO row_counts (Name, RowCount) SELECT '") + table + "', COUNT(*) FROM `" + table + "`");
+            }
+            execute(con, "UNLOCK TABLES");
+        }
+        catch (SQLException&) {
+            execute(con, "UNLOCK TABLES");
+            throw;
+        }
+    }
+
+    struct Migration {
+        int version;
+        const char* description;
+        void (*apply)(Connection*);
+    };
+
+    const Migration MIGRATIONS[] = {
+        { 1, "Base tables", createBaseTables },
+        { 2, "Print queue status columns", addPrintQueueColumns },
+        { 3, "Offline journal idempotency keys", createJournalApplied },
+        { 4, "Daily consumption rollup", createConsumptionRollup },
+        { 5, "Bill of materials", createBillOfMaterials },
+        { 6, "Archive aggregates", createArchiveAggregates },
+        { 7, "Query indexes", createQueryIndexes },
+        { 8, "Business procedures v1 (sp_create_job, sp_update_job, sp_create_payment)", createBusinessProcedures },
+        { 9, "Snapshot version stamps", createTableVersions },
+        { 10, "Row counters", createRowCounters },
+        { 11, "Payment history version stamp", addPaymentHistoryVersion },
+        { 12, "Print jobs default to Done unless queued", restorePrintJobDoneDefault },
+        { 13, "Consumption rollup settling watermark", addRollupSettling },
+        { 14, "Row counters spread over slots", spreadRowCounters },
+    };
+
+    const char* const MIGRATION_LOCK = "workshop_schema_migrations";
+}
+
+// ==========================================
+// RUNNER
+// ==========================================
+
+int schemaVersion(sql::Connection* con) {
+    execute(con,
+        "CREATE TABLE IF NOT EXISTS schema_migrations ("
+        "Version INT NOT NULL PRIMARY KEY, "
+        "Description VARCHAR(200) NOT NULL, "
+        "AppliedAt TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP)");
+    return static_cast<int>(countRows(con, "SELECT IFNULL(MAX(Version), 0) FROM schema_migrations"));
+}
+
+int runMigrations(sql::Connection* con) {
+    // Serialise with other processes starting at the same time
+    if (countRows(con, string("SELECT IFNULL(GET_LOCK('") + MIGRATION_LOCK + "', 30), 0)") != 1) {
+        cerr << "[Schema] Another process is migrating the database; skipped." << endl;
+        return 0;
+    }
+
+    int applied = 0;
+    try {
+        int current = schemaVersion(con);
+        for (const Migration& migration : MIGRATIONS) {
+            if (migration.version <= current) continue;
+
+            migration.apply(con);
+            unique_ptr<PreparedStatement> record(con->prepareStatement(
+                "INSERT INTO schema_migrations (Version, Description) VALUES (?, ?)"
+            ));
+            record->setInt(1, migration.version);
+            record->setString(2, migration.description);
+            record->executeUpdate();
+
+            cout << "[Schema] Applied migration " << migration.version << ": " << migration.description << endl;
+            applied++;
+        }
+    }
+    catch (SQLException& e) {
+        cerr << "[Schema] Migration failed: " << e.what() << endl;
+        applied = -1;
+    }
+
+    try {
+        execute(con, string("DO RELEASE_LOCK('") + MIGRATION_LOCK + "')");
+    }
+    catch (SQLException&) {}
+    return applied;
+}
+
+std::vector<ExpectedIndex> findMissingIndexes(sql::Connection* con) {
+    // Column list of every index per table, e.g. "UserID,TimeStamp"
+    map<string, vector<string>> existing;
+    {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery(
+            "SELECT TABLE_NAME, GROUP_CONCAT(COLUMN_NAME ORDER BY SEQ_IN_INDEX) AS Columns "
+            "FROM information_schema.STATISTICS WHERE TABLE_SCHEMA = DATABASE() "
+            "GROUP BY TABLE_NAME, INDEX_NAME"
+        ));
+        while (res->next()) existing[res->getString("TABLE_NAME")].push_back(res->getString("Columns"));
+    }
+
+    vector<ExpectedIndex> missing;
+    for (const ExpectedIndex& index : expectedIndexes()) {
+        string wanted = index.columns;
+        bool covered = false;
+        for (const string& columns : existing[index.table]) {
+            if (columns.compare(0, wanted.size(), wanted) == 0 &&
+                (columns.size() == wanted.size() || columns[wanted.size()] == ',')) {
+                covered = true;
+                break;
+            }
+        }
+        if (!covered) missing.push_back(index);
+    }
+    return missing;
+}
+
+bool prepareSchema(sql::Connection* con) {
+    if (runMigrations(con) < 0) return false;
+    try {
+        for (const ExpectedIndex& index : findMissingIndexes(con)) {
+            cerr << "[Schema] Missing index " << index.table << "(" << index.columns << ") - "
+                << index.usedBy << " will scan the whole table." << endl;
+        }
+    }
+    catch (SQLException& e) {
+        cerr << "[Schema] Index check skipped: " << e.what() << endl;
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+
+// ==========================================
+// SCHEMA MIGRATIONS
+// ==========================================
+// Every table, column and index the program needs is created here by numbered
+// migrations, recorded in `schema_migrations (Version, Description, AppliedAt)`.
+// Startup (console and --server) applies the pending ones under a named lock,
+// so two terminals starting together do not race. Each migration is written to
+// be a no-op on databases that already have its objects, so installs that grew
+// the tables ad hoc adopt the versioned history on first run.
+//
+// A new schema change is a new entry at the end of the list in
+// SchemaMigrations.cpp; released entries are never edited.
+
+// An index some module's queries depend on
+struct ExpectedIndex {
+    const char* table;
+    const char* name;
+    const char* columns;  // comma-separated, in index order
+    const char* usedBy;   // which query pays for a missing index
+};
+
+const std::vector<ExpectedIndex>& expectedIndexes();
+
+// Applies pending migrations in order; returns how many ran, or -1 if one failed
+// (later ones are then skipped and retried on the next start)
+int runMigrations(sql::Connection* con);
+
+// Highest applied version (0 = none)
+int schemaVersion(sql::Connection* con);
+
+// Expected indexes with no index covering their columns as a prefix (any name counts)
+std::vector<ExpectedIndex> findMissingIndexes(sql::Connection* con);
+
+// Startup hook: migrate, then warn about missing indexes. False if the schema is unusable.
+bool prepareSchema(sql::Connection* con);
@@ -0,0 +1,726 @@
+// Socket headers first: winsock2.h must precede anything that pulls in windows.h
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <csignal>
+#endif
+
+#include "ServerMode.h"
+#include "ConnectionPool.h"
+#include "PrintQueue.h"
+#include "InventoryReservations.h"
+#include "BillOfMaterials.h"
+#include "ResilientConnection.h"
+#include "OfflineJournal.h"
+#include "SchemaMigrations.h"
+#include "db.h"
+#include "printjob.h"
+#include "PaymentModule.h"
+#include "ReportGeneration.h"
+#include "PaymentAnalytics.h"
+#include "Money.h"
+#include "ChangeFeed.h"
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// SOCKET HELPERS
+// ==========================================
+
+namespace {
+#ifdef _WIN32
+    typedef SOCKET socket_t;
+    void closeSocket(socket_t s) { closesocket(s); }
+#else
+    typedef int socket_t;
+    const socket_t INVALID_SOCKET = -1;
+    void closeSocket(socket_t s) { close(s); }
+#endif
+
+    const size_t MAX_REQUEST_LINE = 4096;
+
+    bool socketStartup() {
+#ifdef _WIN32
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+        signal(SIGPIPE, SIG_IGN); // a vanished client must not kill the server
+        return true;
+#endif
+    }
+
+    void socketCleanup() {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    sockaddr_in loopbackAddress(int port) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // counters on this machine only
+        addr.sin_port = htons(static_cast<unsigned short>(port));
+        return addr;
+    }
+
+    bool sendAll(socket_t s, const string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int n = send(s, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Buffered reader for the line-oriented requests and length-prefixed replies
+    class SocketReader {
+    public:
+        explicit SocketReader(socket_t s) : sock_(s) {}
+
+        bool readLine(string& line) {
+            for (;;) {
+                size_t pos = buffer_.find('\n');
+                if (pos != string::npos) {
+                    line = buffer_.substr(0, pos);
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    buffer_.erase(0, pos + 1);
+                    return true;
+                }
+                if (buffer_.size() > MAX_REQUEST_LINE || !fill()) return false;
+            }
+        }
+
+        bool readExact(string& out, size_t n) {
+            while (buffer_.size() < n) {
+                if (!fill()) return false;
+            }
+            out = buffer_.substr(0, n);
+            buffer_.erase(0, n);
+            return true;
+        }
+
+    private:
+        bool fill() {
+            char chunk[4096];
+            int n = recv(sock_, chunk, sizeof(chunk), 0);
+            if (n <= 0) return false;
+            buffer_.append(chunk, static_cast<size_t>(n));
+            return true;
+        }
+
+        socket_t sock_;
+        string buffer_;
+    };
+
+    string encodeReply(bool ok, const string& body) {
+        return string(ok ? "OK " : "ERR ") + to_string(body.size()) + "\n" + body;
+    }
+
+    bool parseInt(const string& text, int& value) {
+        try {
+            size_t used = 0;
+            value = stoi(text, &used);
+            return used == text.size();
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+    bool parseDouble(const string& text, double& value) {
+        try {
+            size_t used = 0;
+            value = stod(text, &used);
+            return used == text.size();
+        }
+        catch (...) {
+            return false;
+        }
+    }
+}
+
+vector<string> splitRequest(const string& line) {
+    vector<string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == string::npos ? string::npos : tab - start));
+        if (tab == string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+// ==========================================
+// SERVER: SHARED STATE
+// ==========================================
+
+namespace {
+    struct Reply {
+        bool ok;
+        string body;
+    };
+
+    struct Session {
+        int userID = 0;
+        string role;
+    };
+
+    ConnectionPool* g_pool = nullptr;
+    PrintQueue* g_queue = nullptr;
+    InventoryReservations* g_reservations = nullptr;
+    atomic<int> g_clients(0);
+
+    // Rendered reports keyed by request; any write clears the cache, and so does
+    // any change the feed reports. While the feed is current, entries don't expire.
+    mutex g_reportMutex;
+    map<string, pair<chrono::steady_clock::time_point, string>> g_reportCache;
+
+    void invalidateReportCache() {
+        lock_guard<mutex> lock(g_reportMutex);
+        g_reportCache.clear();
+    }
+
+    // ==========================================
+    // SERVER: REQUEST HANDLERS
+    // ==========================================
+
+    Reply handleLogin(Session& session, const vector<string>& f) {
+        if (f.size() < 3) return { false, "Usage: LOGIN <name> <password>" };
+        ConnectionPool::Lease lease = g_pool->acquire();
+        if (!lease) return { false, "Database unavailable." };
+
+        int userID = 0;
+        string role;
+        try {
+            if (!authenticateUser(lease.get(), f[1], f[2], userID, role)) {
+                return { false, "Invalid login." };
+            }
+        }
+        catch (SQLException& e) {
+            return { false, string("Login error: ") + e.what() };
+        }
+        if (role != "Admin" && role != "Staff") return { false, "Access denied for role " + role + "." };
+
+        session.userID = userID;
+        session.role = role;
+        return { true, role };
+    }
+
+    Reply handleCreateJob(const vector<string>& f) {
+        int userID = 0, pageCount = 0, priority = 0;
+        double costPerPage = 0.0;
+        if (f.size() < 4 || !parseInt(f[1], userID) || !parseInt(f[2], pageCount) || !parseDouble(f[3], costPerPage)
+            || (f.size() >= 5 && !parseInt(f[4], priority))) {
+            return { false, "Usage: CREATE_JOB <userID> <pageCount> <costPerPage> [priority]" };
+        }
+        if (pageCount <= 0 || costPerPage <= 0.0) return { false, "Page count and cost per page must be positive." };
+        if (priority < 0 || priority > MAX_QUEUE_PRIORITY) {
+            return { false, "Priority must be 0-" + to_string(MAX_QUEUE_PRIORITY) + "." };
+        }
+
+        ConnectionPool::Lease lease = g_pool->acquire();
+        if (!lease) {
+            markDatabaseOffline();
+            return { true, "Queued offline (" + journalPrintJob(userID, pageCount, costPerPage, priority) + ")." };
+        }
+        Connection* con = lease.get();
+
+        syncJournalIfPending(con);
+        if (!isCustomerUser(con, userID)) return { false, "UserID " + to_string(userID) + " is not a customer." };
+        if (!isDatabaseOnline()) {
+            return { true, "Queued offline (" + journalPrintJob(userID, pageCount, costPerPage, priority) + ")." };
+        }
+
+        // Reserve stock up front (CAS, no round trip). If the counters could not be
+        // seeded at startup, the job rules run on the MySQL backend instead, with
+        // the stock rows locked from the check to the commit.
+        const bool reserved = g_reservations->isReady();
+        if (reserved && !g_reservations->reserve(pageCount)) return { false, "Insufficient inventory." };
+
+        try {
+            string error;
+            int jobID = runWrite(con, [&]() {
+                con->setAutoCommit(false);
+                int id = reserved
+                    ? insertPrintJobRecord(con, userID, pageCount, costPerPage, "", StockUpdate::Deferred, priority)
+                    : placePrintJobRecord(con, userID, pageCount, costPerPage, priority, error);
+                if (id == -1) con->rollback();
+                else con->commit();
+                con->setAutoCommit(true);
+                return id;
+                });
+            if (jobID == -1) {
+                if (reserved) g_reservations->release(pageCount);
+                return { false, error.empty() ? "Print job not recorded." : error };
+            }
+            if (reserved) g_reservations->commit(pageCount);
+            invalidateReportCache();
+            g_queue->submit(jobID, pageCount, priority);
+
+            Money jobCost = withReadRetry(con, [&]() {
+                PreparedStatement* pstmt = cachedStatement(con, "SELECT JobCost FROM printjob WHERE JobID = ?");
+                pstmt->setInt(1, jobID);
+                unique_ptr<ResultSet> res(pstmt->executeQuery());
+                return res->next() ? getMoney(*res, "JobCost") : Money();
+                });
+
+            ostringstream body;
+            body << "JobID " << jobID << " | Cost $" << jobCost;
+            return { true, body.str() };
+        }
+        catch (SQLException& e) {
+            try {
+                con->rollback();
+                con->setAutoCommit(true);
+            }
+            catch (SQLException&) {}
+
+            // The journal replay decrements the table itself; the next stock refresh picks that up
+            if (reserved) g_reservations->release(pageCount);
+            if (isConnectionLost(e)) {
+                return { true, "Queued offline (" + journalPrintJob(userID, pageCount, costPerPage, priority) + ")." };
+            }
+            return { false, string("Print job not recorded: ") + e.what() };
+        }
+    }
+
+    Reply handleCancelJob(const vector<string>& f) {
+        int jobID = 0;
+        if (f.size() < 2 || !parseInt(f[1], jobID)) return { false, "Usage: CANCEL_JOB <jobID>" };
+
+        ConnectionPool::Lease lease = g_pool->acquire();
+        if (!lease) return { false, "Database unavailable." };
+        Connection* con = lease.get();
+
+        try {
+            int pageCount = -1, priority = 0;
+            withReadRetry(con, [&]() {
+                PreparedStatement* pstmt = cachedStatement(con, "SELECT PageCount, Priority FROM printjob WHERE JobID = ? AND Status = 'Queued'");
+                pstmt->setInt(1, jobID);
+                unique_ptr<ResultSet> res(pstmt->executeQuery());
+                if (res->next()) {
+                    pageCount = res->getInt("PageCount");
+                    priority = res->getInt("Priority");
+                }
+                return 0;
+                });
+            // The queue is the authority on "not printing yet"; its DB status lags by one flush
+            if (pageCount < 0 || !g_queue->cancel(jobID)) {
+                return { false, "Job " + to_string(jobID) + " is not waiting in the queue." };
+            }
+
+            // The row and, without the counters, its stock go back together or not at all
+            const bool reserved = g_reservations->isReady();
+            try {
+                runWrite(con, [&]() {
+                    con->setAutoCommit(false);
+                    unique_ptr<PreparedStatement> del(con->prepareStatement("DELETE FROM printjob WHERE JobID = ?"));
+                    del->setInt(1, jobID);
+                    del->executeUpdate();
+                    if (!reserved) {
+                        vector<MaterialNeed> restock = materialsForPages(bomForJobType(con), pageCount);
+                        for (MaterialNeed& need : restock) need.units = -need.units;
+                        applyMaterialUsage(con, restock, false);
+                    }
+                    con->commit();
+                    con->setAutoCommit(true);
+                    return 0;
+                    });
+            }
+            catch (SQLException&) {
+                try {
+                    con->rollback();
+                    con->setAutoCommit(true);
+                }
+                catch (SQLException&) {}
+                g_queue->submit(jobID, pageCount, priority); // still a valid job: put it back in line
+                throw;
+            }
+
+            // The counters hand the stock back in memory; the next flush writes it
+            if (reserved) g_reservations->returnStock(pageCount);
+            invalidateReportCache();
+            return { true, "Job " + to_string(jobID) + " cancelled; stock released." };
+        }
+        catch (SQLException& e) {
+            return { false, string("Cancel failed: ") + e.what() };
+        }
+    }
+
+    Reply handlePayment(const vector<string>& f) {
+        int userID = 0, jobID = 0;
+        Money amount;
+        if (f.size() < 5 || !parseInt(f[1], userID) || !parseInt(f[2], jobID) || !Money::parse(f[3], amount)) {
+            return { false, "Usage: PAYMENT <userID> <jobID> <amount> <method>" };
+        }
+        if (amount <= Money()) return { false, "Amount must be positive." };
+        const string& method = f[4];
+
+        ConnectionPool::Lease lease = g_pool->acquire();
+        if (!lease) {
+            markDatabaseOffline();
+            return { true, "Queued offline (" + journalPayment(userID, jobID, amount, method) + ")." };
+        }
+        Connection* con = lease.get();
+
+        syncJournalIfPending(con);
+        if (!isDatabaseOnline()) {
+            return { true, "Queued offline (" + journalPayment(userID, jobID, amount, method) + ")." };
+        }
+
+        try {
+            string reason;
+            string status = runWrite(con, [&]() {
+                return insertPaymentRecord(con, userID, jobID, amount, method, "", reason);
+                });
+            if (status.empty()) return { false, reason };
+
+            invalidateReportCache();
+            return { true, "Payment recorded. Status: " + status };
+        }
+        catch (SQLException& e) {
+            if (isConnectionLost(e)) {
+                return { true, "Queued offline (" + journalPayment(userID, jobID, amount, method) + ")." };
+            }
+            return { false, string("Payment not recorded: ") + e.what() };
+        }
+    }
+
+    Reply handleReport(const Session& session, const vector<string>& f, const string& requestLine) {
+        if (session.role != "Admin") return { false, "Access denied. Reports are Admin only." };
+
+        int year = 0, month = 0;
+        const string kind = f.size() > 1 ? f[1] : "";
+        bool valid = f.size() > 2 && parseInt(f[2], year);
+        if (kind == "SUMMARY") valid = valid && f.size() > 3 && parseInt(f[3], month) && month >= 1 && month <= 12;
+        else if (kind != "TREND" && kind != "GROWTH") valid = false;
+        if (!valid) return { false, "Usage: REPORT SUMMARY <year> <month> | TREND <year> | GROWTH <year>" };
+
+        const int ttl = getConfigInt("SERVER_REPORT_CACHE_SECONDS", 30);
+        const auto now = chrono::steady_clock::now();
+        {
+            lock_guard<mutex> lock(g_reportMutex);
+            auto it = g_reportCache.find(requestLine);
+            if (it != g_reportCache.end() && (changeFeedCurrent() || now - it->second.first < chrono::seconds(ttl))) {
+                return { true, it->second.second };
+            }
+        }
+
+        ConnectionPool::Lease lease = g_pool->acquire();
+        if (!lease) return { false, "Database unavailable." };
+
+        ostringstream out;
+        if (kind == "SUMMARY") generateFinancialSummary(lease.get(), year, month, out);
+        else if (kind == "TREND") displaySalesTrendChart(lease.get(), year, out);
+        else displaySalesGrowthGraph(lease.get(), year, out);
+
+        if (ttl > 0) {
+            lock_guard<mutex> lock(g_reportMutex);
+            g_reportCache[requestLine] = make_pair(now, out.str());
+        }
+        return { true, out.str() };
+    }
+
+    Reply handleQueueStatus() {
+        QueueMetrics m = g_queue->metrics();
+        ostringstream body;
+        body << "Printers: " << g_queue->printerCount() << " | Waiting: " << m.depth << " | Printing: " << m.printing
+            << " | Done: " << m.completed << " | Avg wait: " << fixed << setprecision(1) << m.avgWaitMs / 1000.0
+            << " s | Max wait: " << m.maxWaitMs / 1000.0 << " s";
+        return { true, body.str() };
+    }
+
+    Reply dispatch(Session& session, const string& line, bool& quit) {
+        vector<string> f = splitRequest(line);
+        const string& command = f[0];
+
+        if (command == "PING") return { true, "PONG" };
+        if (command == "QUIT") {
+            quit = true;
+            return { true, "BYE" };
+        }
+        if (command == "LOGIN") return handleLogin(session, f);
+        if (session.userID == 0) return { false, "Please LOGIN first." };
+
+        if (command == "CREATE_JOB") return handleCreateJob(f);
+        if (command == "CANCEL_JOB") return handleCancelJob(f);
+        if (command == "PAYMENT") return handlePayment(f);
+        if (command == "REPORT") return handleReport(session, f, line);
+        if (command == "QUEUE") return handleQueueStatus();
+        return { false, "Unknown command: " + command };
+    }
+
+    void serveClient(socket_t client) {
+        int active = ++g_clients;
+        cout << "[Server] Terminal connected (" << active << " active)" << endl;
+
+        Session session;
+        SocketReader reader(client);
+        string line;
+        bool quit = false;
+        while (!quit && reader.readLine(line)) {
+            if (line.empty()) continue;
+            Reply reply;
+            try {
+                reply = dispatch(session, line, quit);
+            }
+            catch (exception& e) {
+                reply = { false, string("Server error: ") + e.what() };
+            }
+            if (!sendAll(client, encodeReply(reply.ok, reply.body))) break;
+        }
+
+        closeSocket(client);
+        active = --g_clients;
+        cout << "[Server] Terminal disconnected (" << active << " active)" << endl;
+    }
+}
+
+// ==========================================
+// SERVER ENTRY POINT
+// ==========================================
+
+int runServer() {
+    const int port = getConfigInt("SERVER_PORT", 5050);
+    if (!socketStartup()) {
+        cerr << "[Server] Socket library failed to start." << endl;
+        return 1;
+    }
+
+    socket_t listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == INVALID_SOCKET) {
+        cerr << "[Server] Could not create a socket." << endl;
+        socketCleanup();
+        return 1;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    sockaddr_in addr = loopbackAddress(port);
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+        cerr << "[Server] Port " << port << " is unavailable (is another server running?)." << endl;
+        closeSocket(listener);
+        socketCleanup();
+        return 1;
+    }
+
+    ConnectionPool pool;
+    g_pool = &pool;
+
+    // Other writers' changes clear the report cache
+    for (const char* table : { "user", "printjob", "payment", "inventory" }) {
+        subscribeToChanges(table, [](const TableChange&) { invalidateReportCache(); });
+    }
+    bool following = startChangeFeed();
+    {
+        // Warm one session up front so configuration errors show immediately
+        ConnectionPool::Lease warm = pool.acquire();
+        if (!warm) cout << "[Server] Database unreachable; writes will be journaled until it returns." << endl;
+        else if (!prepareSchema(warm.get())) cout << "[Server] Continuing on the existing schema; some features may fail." << endl;
+        if (warm) {
+            long long payments = loadPaymentAnalytics(warm.get());
+            if (payments >= 0) cout << "[Server] " << payments << " payments loaded for the sales reports." << endl;
+        }
+    }
+
+    // Stock counters for lock-free reservations; flushed to the table in batches
+    InventoryReservations reservations(&pool);
+    g_reservations = &reservations;
+    if (reservations.load()) reservations.start();
+    else cout << "[Server] Stock counters unavailable; using per-job stock checks." << endl;
+    subscribeToChanges("inventory", [&reservations](const TableChange&) { reservations.requestRefresh(); });
+
+    // Printers drain the queue for every terminal; jobs created here are submitted as they
+    // commit, Queued rows written elsewhere (journal replays) are polled for
+    PrintQueue queue(pool, getConfigInt("PRINTER_COUNT", 2), getConfigInt("PRINTER_PAGES_PER_MINUTE", 30));
+    g_queue = &queue;
+    int loaded = queue.loadPending();
+    queue.start();
+
+    cout << "[Server] Print queue: " << queue.printerCount() << " printers, " << loaded << " jobs waiting" << endl;
+    cout << "[Server] Listening on 127.0.0.1:" << port << " | Pool size: " << pool.maxSize()
+        << " | Report cache: " << getConfigInt("SERVER_REPORT_CACHE_SECONDS", 30) << " s"
+        << (following ? " (or until the binlog shows a change)" : "") << endl;
+    cout << "[Server] Start counters with: workshop --client (Ctrl+C to stop the server)" << endl;
+
+    for (;;) {
+        socket_t client = accept(listener, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        thread(serveClient, client).detach();
+    }
+}
+
+// ==========================================
+// THIN CLIENT
+// ==========================================
+
+namespace {
+    // Sends one request and waits for its reply; false means the server is gone
+    bool roundTrip(socket_t s, SocketReader& reader, const vector<string>& fields, Reply& reply) {
+        string line;
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (i > 0) line += '\t';
+            for (char c : fields[i]) line += (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+        }
+        if (!sendAll(s, line + "\n")) return false;
+
+        string header;
+        if (!reader.readLine(header)) return false;
+        size_t space = header.find(' ');
+        int length = 0;
+        if (space == string::npos || !parseInt(header.substr(space + 1), length) || length < 0) return false;
+
+        reply.ok = header.compare(0, space, "OK") == 0;
+        return reader.readExact(reply.body, static_cast<size_t>(length));
+    }
+
+    void printReply(const Reply& reply) {
+        if (reply.ok) cout << "[Success] " << reply.body << "\n";
+        else cout << "[Error] " << reply.body << "\n";
+    }
+
+    string promptLine(const string& prompt) {
+        cout << prompt;
+        string input;
+        getline(cin, input);
+        return input;
+    }
+}
+
+int runClient() {
+    const int port = getConfigInt("SERVER_PORT", 5050);
+    if (!socketStartup()) return 1;
+
+    socket_t s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr = loopbackAddress(port);
+    if (s == INVALID_SOCKET || connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        cerr << "[Error] No server on 127.0.0.1:" << port << ". Start one with: workshop --server" << endl;
+        if (s != INVALID_SOCKET) closeSocket(s);
+        socketCleanup();
+        return 1;
+    }
+    SocketReader reader(s);
+    Reply reply{ false, "" };
+
+    cout << "=== Login (Server Mode) ===\n";
+    string name = promptLine("Username: ");
+    string password = getMaskedPassword("Password: ");
+    if (!roundTrip(s, reader, { "LOGIN", name, password }, reply) || !reply.ok) {
+        printReply(reply.body.empty() ? Reply{ false, "Server closed the connection." } : reply);
+        closeSocket(s);
+        socketCleanup();
+        return 1;
+    }
+    const string role = reply.body;
+
+    int choice;
+    bool connected = true;
+    do {
+        cout << "\n==========================================\n";
+        cout << "   Counter Terminal (" << role << ")\n";
+        cout << "==========================================\n";
+        cout << "1. Create Print Job\n";
+        cout << "2. Cancel Queued Print Job\n";
+        cout << "3. Record Payment\n";
+        if (role == "Admin") {
+            cout << "4. Financial Summary\n";
+            cout << "5. Sales Trend\n";
+            cout << "6. Sales Growth\n";
+        }
+        cout << "7. Print Queue Status\n";
+        cout << "8. Exit\n";
+        cout << "==========================================\n";
+
+        choice = readInt("Enter choice: ");
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        vector<string> request;
+        switch (choice) {
+        case 1: {
+            int uid = readInt("Enter Customer UserID: ");
+            int pages = readInt("Enter Page Count: ");
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            string cost = promptLine("Enter Cost Per Page (e.g., 0.50): ");
+            string priority = promptLine("Priority (0-" + to_string(MAX_QUEUE_PRIORITY) + ", higher prints first; Enter for 0): ");
+            request = { "CREATE_JOB", to_string(uid), to_string(pages), cost, priority.empty() ? "0" : priority };
+            break;
+        }
+        case 2: {
+            int jid = readInt("Enter JobID to cancel: ");
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            request = { "CANCEL_JOB", to_string(jid) };
+            break;
+        }
+        case 3: {
+            int uid = readInt("Enter UserID: ");
+            int jid = readInt("Enter JobID: ");
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            string amount = promptLine("Enter Payment Amount: ");
+            string method = promptLine("Enter Payment Method (e.g., Cash, Card): ");
+            request = { "PAYMENT", to_string(uid), to_string(jid), amount, method };
+            break;
+        }
+        case 4: {
+            int y = readInt("Enter Year (e.g., 2024): ");
+            int m = readInt("Enter Month (1-12): ");
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            request = { "REPORT", "SUMMARY", to_string(y), to_string(m) };
+            break;
+        }
+        case 5:
+        case 6: {
+            int y = readInt("Enter Year: ");
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            request = { "REPORT", choice == 5 ? "TREND" : "GROWTH", to_string(y) };
+            break;
+        }
+        case 7:
+            request = { "QUEUE" };
+            break;
+        case 8:
+            request = { "QUIT" };
+            break;
+        default:
+            cout << "Invalid choice. Try again.\n";
+            continue;
+        }
+
+        if (!roundTrip(s, reader, request, reply)) {
+            cout << "[Error] Lost contact with the server.\n";
+            connected = false;
+            break;
+        }
+        if (choice == 8) break;
+        if (request[0] == "REPORT" && reply.ok) cout << reply.body;
+        else printReply(reply);
+    } while (choice != 8);
+
+    closeSocket(s);
+    socketCleanup();
+    return connected ? 0 : 1;
+}
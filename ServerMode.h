@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// ==========================================
+// SERVER MODE (multi-terminal)
+// ==========================================
+// `workshop --server` hosts the module logic for every counter: one process owns
+// the connection pool, the per-connection statement caches, a short-lived
+// report cache and the print queue with its printers. `workshop --client` is a
+// thin console that talks to it over a localhost TCP socket (SERVER_PORT).
+//
+// Protocol (one request per line, fields separated by TAB):
+//   PING
+//   LOGIN        <name> <password>
+//   CREATE_JOB   <userID> <pageCount> <costPerPage>
+//   CANCEL_JOB   <jobID>   (only while still waiting in the queue)
+//   PAYMENT      <userID> <jobID> <amount> <method>
+//   REPORT       SUMMARY <year> <month> | TREND <year> | GROWTH <year>
+//   QUEUE        (print queue depth and wait times)
+//   QUIT
+// Reply: "OK <n>\n" or "ERR <n>\n" followed by exactly n bytes of text.
+
+// Runs the daemon until the process is stopped. Returns a process exit code.
+int runServer();
+
+// Interactive thin client for a running server. Returns a process exit code.
+int runClient();
+
+// Splits a request line on TAB (exposed for the client and server alike)
+std::vector<std::string> splitRequest(const std::string& line);
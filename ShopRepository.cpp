@@ -0,0 +1,85 @@
+#include "ShopRepository.h"
+#include "XDevApiRepository.h"
+#include "ResilientConnection.h"
+#include "db.h"
+#include <iostream>
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// JDBC BACKEND
+// ==========================================
+
+namespace {
+    // The queries the modules have always run, one round trip at a time
+    class JdbcShopRepository : public ShopRepository {
+    public:
+        explicit JdbcShopRepository(Connection* con) : con_(con) {}
+
+        const char* backendName() const override { return "jdbc"; }
+
+        PaymentCheck checkPayment(int userID, int jobID) override {
+            return withReadRetry(con_, [&]() {
+                PaymentCheck check;
+                PreparedStatement* paid = cachedStatement(con_, "SELECT 1 FROM payment WHERE JobID = ? LIMIT 1");
+                paid->setInt(1, jobID);
+                unique_ptr<ResultSet> paidRes(paid->executeQuery());
+                check.alreadyPaid = paidRes->next();
+
+                PreparedStatement* cost = cachedStatement(con_,
+                    "SELECT JobCost FROM printjob WHERE JobID = ? AND UserID = ? LIMIT 1");
+                cost->setInt(1, jobID);
+                cost->setInt(2, userID);
+                unique_ptr<ResultSet> costRes(cost->executeQuery());
+                if (costRes->next()) {
+                    check.jobFound = true;
+                    check.jobCost = getMoney(*costRes, "JobCost");
+                }
+                return check;
+                });
+        }
+
+        SalesTotals salesTotals() override {
+            return withReadRetry(con_, [&]() {
+                SalesTotals totals;
+                unique_ptr<Statement> stmt(con_->createStatement());
+                {
+                    unique_ptr<ResultSet> res(stmt->executeQuery("SELECT SUM(JobCost) FROM printjob"));
+                    if (res->next()) totals.jobCost = getMoney(*res, 1);
+                }
+                {
+                    unique_ptr<ResultSet> res(stmt->executeQuery(
+                        "SELECT SUM(cl.QuantityUsed * i.UnitCost) "
+                        "FROM inventoryconsumption cl JOIN inventory i ON cl.InventoryID = i.InventoryID"));
+                    if (res->next()) totals.operationCost = getMoney(*res, 1);
+                }
+                {
+                    unique_ptr<ResultSet> res(stmt->executeQuery(
+                        "SELECT SUM(Amount) FROM payment WHERE PaymentStatus = 'Complete'"));
+                    if (res->next()) totals.revenue = getMoney(*res, 1);
+                }
+                return totals;
+                });
+        }
+
+    private:
+        Connection* con_;
+    };
+}
+
+// ==========================================
+// BACKEND SELECTION
+// ==========================================
+
+std::unique_ptr<ShopRepository> makeShopRepository(sql::Connection* con) {
+    if (getConfigValue("DB_BACKEND", "jdbc") == "xdevapi") {
+        std::unique_ptr<ShopRepository> x = makeXDevApiRepository();
+        if (x) return x;
+    }
+    return std::unique_ptr<ShopRepository>(new JdbcShopRepository(con));
+}
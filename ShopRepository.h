@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <mysql_connection.h>
+#include "Money.h"
+
+// ==========================================
+// SHOP REPOSITORY (backend-neutral reads)
+// ==========================================
+// Reads made of several independent queries go through this interface, so a
+// backend can overlap them instead of waiting on each in turn. DB_BACKEND picks
+// the implementation:
+//   jdbc     (default) the session's sql::Connection, one query after another
+//   xdevapi  X Protocol sessions (XDevApiRepository.h), queries in flight together
+// Failures throw std::exception subclasses (sql::SQLException for jdbc).
+
+// What createPayment needs to know before taking money for a job
+struct PaymentCheck {
+    bool alreadyPaid = false;
+    bool jobFound = false;   // false = no such job for this user
+    Money jobCost;
+};
+
+struct SalesTotals {
+    Money jobCost;        // SUM(printjob.JobCost)
+    Money operationCost;  // SUM(QuantityUsed * UnitCost)
+    Money revenue;        // SUM(Amount) of Complete payments
+};
+
+class ShopRepository {
+public:
+    virtual ~ShopRepository() {}
+
+    virtual const char* backendName() const = 0;
+
+    // Duplicate-payment check and job cost/ownership lookup
+    virtual PaymentCheck checkPayment(int userID, int jobID) = 0;
+
+    // The three all-time sums behind the Sales Analysis screens
+    virtual SalesTotals salesTotals() = 0;
+};
+
+// Backend chosen by DB_BACKEND; `con` serves the jdbc backend (and is the
+// fallback when the X Protocol port cannot be reached)
+std::unique_ptr<ShopRepository> makeShopRepository(sql::Connection* con);
@@ -0,0 +1,282 @@
+#include "StoredProcedures.h"
+#include "BillOfMaterials.h"
+#include "ResilientConnection.h"
+#include "PaymentModule.h"
+#include "printjob.h"
+#include "SchemaMigrations.h"
+#include "ConnectionPool.h" // openPooledConnection()
+#include "db.h"             // getConfigValue()
+#include "utils.h"
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <chrono>
+#include <vector>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// CALL WRAPPERS
+// ==========================================
+
+namespace {
+    // Executes a prepared CALL, hands its one-row result to `read` and drains the
+    // trailing status result so the session is ready for the next statement
+    template <typename Fn>
+    void callProcedure(PreparedStatement* pstmt, Fn read) {
+        pstmt->execute();
+        bool seen = false;
+        do {
+            unique_ptr<ResultSet> res(pstmt->getResultSet());
+            if (!seen && res && res->next()) {
+                read(*res);
+                seen = true;
+            }
+        } while (pstmt->getMoreResults());
+    }
+}
+
+int callCreateJob(sql::Connection* con, int userID, int pageCount, double costPerPage,
+    Money& jobCost, std::string& error) {
+    PreparedStatement* pstmt = cachedStatement(con,
+        "CALL sp_create_job(?, ?, ?, NULL, ?, @sp_job_id, @sp_job_cost, @sp_error)");
+    pstmt->setInt(1, userID);
+    pstmt->setInt(2, pageCount);
+    pstmt->setDouble(3, costPerPage);
+    pstmt->setString(4, STANDARD_JOB_TYPE);
+
+    int jobID = -1;
+    error.clear();
+    callProcedure(pstmt, [&](ResultSet& row) {
+        if (!row.isNull("Error")) {
+            error = row.getString("Error");
+            return;
+        }
+        jobID = row.getInt("JobID");
+        jobCost = getMoney(row, "JobCost");
+        });
+    return jobID;
+}
+
+bool callUpdateJob(sql::Connection* con, int jobID, int newPageCount, double newCostPerPage,
+    int& oldPageCount, std::string& error) {
+    PreparedStatement* pstmt = cachedStatement(con,
+        "CALL sp_update_job(?, ?, ?, ?, @sp_old_pages, @sp_error)");
+    pstmt->setInt(1, jobID);
+    pstmt->setInt(2, newPageCount > 0 ? newPageCount : 0);
+    pstmt->setDouble(3, newCostPerPage > 0.0 ? newCostPerPage : 0.0);
+    pstmt->setString(4, STANDARD_JOB_TYPE);
+
+    error.clear();
+    callProcedure(pstmt, [&](ResultSet& row) {
+        oldPageCount = row.isNull("OldPageCount") ? 0 : row.getInt("OldPageCount");
+        if (!row.isNull("Error")) error = row.getString("Error");
+        });
+    return error.empty();
+}
+
+std::string callCreatePayment(sql::Connection* con, int userID, int jobID, Money amount,
+    const std::string& method, int& transactionID, std::string& error) {
+    PreparedStatement* pstmt = cachedStatement(con,
+        "CALL sp_create_payment(?, ?, ?, ?, NULL, @sp_transaction_id, @sp_status, @sp_job_cost, @sp_error)");
+    pstmt->setInt(1, userID);
+    pstmt->setInt(2, jobID);
+    pstmt->setString(3, amount.toString());
+    pstmt->setString(4, method);
+
+    string status;
+    error.clear();
+    callProcedure(pstmt, [&](ResultSet& row) {
+        if (!row.isNull("Error")) {
+            error = row.getString("Error");
+            return;
+        }
+        transactionID = row.getInt("TransactionID");
+        status = row.getString("PaymentStatus");
+        });
+    return status;
+}
+
+// ==========================================
+// BENCHMARK
+// ==========================================
+
+namespace {
+    // Average milliseconds per call of fn(i) over `count` calls
+    template <typename Fn>
+    double averageMs(int count, Fn fn) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) fn(i);
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / count;
+    }
+
+    // The statements createPrintJob issued before the procedure: stock check,
+    // insert + consumption in a transaction, then the generated cost
+    int clientCreateJob(Connection* con, int userID, int pages) {
+        if (!isInventorySufficient(con, pages)) return -1;
+        con->setAutoCommit(false);
+        int jobID = insertPrintJobRecord(con, userID, pages, 0.10, "");
+        con->commit();
+        con->setAutoCommit(true);
+
+        unique_ptr<PreparedStatement> cost(con->prepareStatement("SELECT JobCost FROM printjob WHERE JobID = ?"));
+        cost->setInt(1, jobID);
+        unique_ptr<ResultSet> res(cost->executeQuery());
+        res->next();
+        return jobID;
+    }
+
+    // updatePrintJob before the procedure: old count, stock check on the delta,
+    // then the job update and inventory adjustment in a transaction
+    void clientUpdateJob(Connection* con, int jobID, int newPages) {
+        unique_ptr<PreparedStatement> select(con->prepareStatement("SELECT PageCount FROM printjob WHERE JobID = ?"));
+        select->setInt(1, jobID);
+        unique_ptr<ResultSet> res(select->executeQuery());
+        if (!res->next()) return;
+        int oldPages = res->getInt("PageCount");
+
+        vector<MaterialNeed> delta = materialDeltaForPages(bomForJobType(con), oldPages, newPages);
+        {
+            unique_ptr<Statement> stmt(con->createStatement());
+            string ids;
+            for (const MaterialNeed& need : delta) ids += (ids.empty() ? "" : ",") + to_string(need.inventoryID);
+            if (!ids.empty()) {
+                unique_ptr<ResultSet> stock(stmt->executeQuery("SELECT InventoryID, Quantity FROM inventory WHERE InventoryID IN (" + ids + ")"));
+                while (stock->next()) {}
+            }
+        }
+
+        unique_ptr<PreparedStatement> update(con->prepareStatement("UPDATE printjob SET PageCount = ? WHERE JobID = ?"));
+        update->setInt(1, newPages);
+        update->setInt(2, jobID);
+        con->setAutoCommit(false);
+        update->executeUpdate();
+        applyMaterialUsage(con, delta, false);
+        con->commit();
+        con->setAutoCommit(true);
+    }
+
+    // createPayment before the procedure: user check, then insertPaymentRecord's
+    // job/duplicate checks and insert
+    void clientCreatePayment(Connection* con, int userID, int jobID) {
+        if (!doesUserExist(con, userID)) return;
+        string reason;
+        insertPaymentRecord(con, userID, jobID, Money::fromCents(100000), "Cash", "", reason);
+    }
+}
+
+void runStoredProcedureBenchmark(sql::Connection* con) {
+    const string live = getConfigValue("DB_NAME");
+    const string scratch = live + "_bench";
+    cout << "\n--- Stored Procedure Benchmark ---\n";
+    cout << "Creates, edits and pays jobs in a scratch schema (" << scratch << ") holding a copy of the\n"
+        "inventory and bill of materials; the shop's tables are not touched. The schema is\n"
+        "dropped afterwards (needs CREATE and DROP privileges). Continue? (y/n): ";
+    string answer;
+    getline(cin, answer);
+    if (answer.empty() || tolower(answer[0]) != 'y') return;
+
+    int iterations = readInt("Iterations per flow (e.g., 200): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (iterations <= 0) {
+        cout << "[Error] Iterations must be positive.\n";
+        return;
+    }
+    if (live.empty() || live.find('`') != string::npos) {
+        cout << "[Error] DB_NAME in config.ini is not usable for a scratch schema name.\n";
+        return;
+    }
+
+    unique_ptr<Connection> bench;
+    try {
+        // A schema left behind by an interrupted run is simply replaced
+        unique_ptr<Statement> admin(con->createStatement());
+        admin->execute("DROP DATABASE IF EXISTS `" + scratch + "`");
+        admin->execute("CREATE DATABASE `" + scratch + "`");
+
+        // Its own session, so no statement cached for the shop's schema is reused
+        bench.reset(openPooledConnection());
+        if (!bench) throw SQLException("Database unavailable");
+        Connection* db = bench.get();
+        useSchema(db, scratch);
+        cout << "Preparing the scratch schema...\n";
+        if (runMigrations(db) < 0) throw SQLException("Scratch schema could not be migrated");
+
+        unique_ptr<Statement> stmt(db->createStatement());
+        // Same InventoryIDs as the shop, so the cached bill of materials applies; enough
+        // headroom that no run is cut short by the real stock level
+        stmt->execute("DELETE FROM job_bom");
+        stmt->execute("DELETE FROM inventory");
+        stmt->execute("INSERT INTO inventory (InventoryID, ItemType, Quantity, UnitCost) "
+            "SELECT InventoryID, ItemType, Quantity + 1000000, UnitCost FROM `" + live + "`.inventory");
+        stmt->execute("INSERT INTO job_bom (JobType, InventoryID, UnitsPerPage) "
+            "SELECT JobType, InventoryID, UnitsPerPage FROM `" + live + "`.job_bom");
+        stmt->execute("INSERT INTO `user` (FullName, Password, Role) VALUES ('Benchmark Customer', '-', 'Customer')");
+        int userID;
+        {
+            unique_ptr<ResultSet> res(stmt->executeQuery("SELECT LAST_INSERT_ID()"));
+            res->next();
+            userID = res->getInt(1);
+        }
+
+        vector<int> clientJobs, procJobs;
+        const int pages = 25;
+        double clientCreate = averageMs(iterations, [&](int) {
+            clientJobs.push_back(clientCreateJob(db, userID, pages));
+            });
+        double procCreate = averageMs(iterations, [&](int) {
+            Money cost;
+            string error;
+            procJobs.push_back(callCreateJob(db, userID, pages, 0.10, cost, error));
+            });
+
+        double clientUpdate = averageMs(iterations, [&](int i) { clientUpdateJob(db, clientJobs[i], pages + 5); });
+        double procUpdate = averageMs(iterations, [&](int i) {
+            int oldPages = 0;
+            string error;
+            callUpdateJob(db, procJobs[i], pages + 5, 0.0, oldPages, error);
+            });
+
+        double clientPay = averageMs(iterations, [&](int i) { clientCreatePayment(db, userID, clientJobs[i]); });
+        double procPay = averageMs(iterations, [&](int i) {
+            int transactionID = 0;
+            string error;
+            callCreatePayment(db, userID, procJobs[i], Money::fromCents(100000), "Cash", transactionID, error);
+            });
+
+        cout << "\n" << left << setw(16) << "Flow" << right << setw(16) << "Client (ms)"
+            << setw(16) << "Procedure (ms)" << setw(10) << "Speedup" << "\n";
+        cout << string(58, '-') << "\n";
+        auto row = [](const char* flow, double client, double proc) {
+            cout << left << setw(16) << flow << right << fixed << setprecision(3) << setw(16) << client
+                << setw(16) << proc << setw(9) << setprecision(2) << (proc > 0 ? client / proc : 0.0) << "x\n";
+            };
+        row("Create job", clientCreate, procCreate);
+        row("Update job", clientUpdate, procUpdate);
+        row("Create payment", clientPay, procPay);
+        cout << "(" << iterations << " calls each; the gap grows with network latency to the server.)\n";
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Benchmark stopped: " << e.what() << endl;
+    }
+
+    if (bench) {
+        useSchema(bench.get(), "");
+        releaseStatementCache(bench.get());
+        bench.reset();
+    }
+    try {
+        unique_ptr<Statement> admin(con->createStatement());
+        admin->execute("DROP DATABASE IF EXISTS `" + scratch + "`");
+        cout << "Scratch schema dropped.\n";
+    }
+    catch (SQLException& e) {
+        cerr << "[Error] Drop " << scratch << " by hand: " << e.what() << endl;
+    }
+}
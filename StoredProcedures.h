@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <mysql_connection.h>
+#include "Money.h"
+
+// ==========================================
+// BUSINESS STORED PROCEDURES
+// ==========================================
+// Job creation, job edits and payment capture run server-side as one CALL each
+// (installed by schema migration 8). Every procedure validates, writes and
+// commits in its own transaction, so the caller must not have one open.
+// Business rejections (short stock, job not found, already paid) come back as
+// `error`; database failures throw sql::SQLException as usual.
+//
+// Each procedure has OUT parameters for SQL callers and ends by selecting them
+// as one row, which is what these wrappers read: the JDBC-style connector
+// cannot bind OUT parameters, and reading @session variables would cost a
+// second round trip.
+//
+// The client-side versions (insertPrintJobRecord, insertPaymentRecord) remain
+// for journal replay and server mode, which batch several writes per transaction.
+
+// sp_create_job: returns the new JobID and its cost, or -1 with `error` set
+int callCreateJob(sql::Connection* con, int userID, int pageCount, double costPerPage,
+    Money& jobCost, std::string& error);
+
+// sp_update_job: pass 0 to leave pages or cost unchanged. False with `error` set
+// when the job is missing or stock is short; oldPageCount is the count before.
+bool callUpdateJob(sql::Connection* con, int jobID, int newPageCount, double newCostPerPage,
+    int& oldPageCount, std::string& error);
+
+// sp_create_payment: returns the PaymentStatus written, or "" with `error` set
+std::string callCreatePayment(sql::Connection* con, int userID, int jobID, Money amount,
+    const std::string& method, int& transactionID, std::string& error);
+
+// System Maintenance command: times each procedure against its client-side flow
+// in a scratch schema (DB_NAME + "_bench") that `con` creates and drops
+void runStoredProcedureBenchmark(sql::Connection* con);
@@ -0,0 +1,366 @@
+#include "SystemMaintenance.h"
+#include "PasswordHash.h"
+#include "OfflineJournal.h"
+#include "PrintQueue.h"
+#include "ConnectionPool.h"
+#include "InventoryReservations.h"
+#include "TablePartitioning.h"
+#include "ColdArchive.h"
+#include "QueryPlanCheck.h"
+#include "StoredProcedures.h"
+#include "ResultStreaming.h"
+#include "Repositories.h"
+#include "AggregationKernels.h"
+#include "ReplicaRouting.h"
+#include "utils.h" // Assumes readInt, clearScreen, etc.
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <random>
+#include <mutex>
+#include <functional>
+
+using namespace std;
+using namespace sql;
+
+// ==========================================
+// 1) LOGIN THROUGHPUT BENCHMARK
+// ==========================================
+void runLoginThroughputBenchmark(sql::Connection* con) {
+    cout << "\n--- Login Throughput Benchmark ---\n";
+
+    ScryptParams configured = loadScryptParams();
+    unsigned threadCount = thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    const double secondsPerSetting = 2.0;
+
+    // Step 1: Cost of the name lookup that precedes every verification
+    double lookupMs = 0.0;
+    try {
+        string sampleName;
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> nameRes(stmt->executeQuery("SELECT FullName FROM user WHERE Role = 'Admin' LIMIT 1"));
+        if (nameRes->next()) sampleName = nameRes->getString("FullName");
+
+        unique_ptr<PreparedStatement> pstmt(
+            con->prepareStatement("SELECT UserID, Role, Password FROM user WHERE FullName = ?")
+        );
+        const int lookups = 20;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < lookups; i++) {
+            pstmt->setString(1, sampleName);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            while (res->next()) {}
+        }
+        lookupMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / lookups;
+    }
+    catch (SQLException& e) {
+        cerr << "[Warning] Lookup timing skipped: " << e.what() << endl;
+    }
+
+    cout << "Configured: ln=" << configured.logN << ", r=" << configured.r << ", p=" << configured.p
+        << " | Worker threads: " << threadCount << " | Name lookup: "
+        << fixed << setprecision(2) << lookupMs << " ms\n";
+
+    // Step 2: Verify throughput around the configured cost
+    cout << "+--------+------------+--------------+--------------+\n";
+    cout << "| " << left << setw(6) << "ln" << " | " << setw(10) << "Mem/hash"
+        << " | " << setw(12) << "Latency (ms)" << " | " << setw(12) << "Logins/sec" << " |\n";
+    cout << "+--------+------------+--------------+--------------+\n";
+
+    for (int logN = configured.logN - 2; logN <= configured.logN + 2; logN++) {
+        if (logN < 10 || logN > 20) continue;
+
+        ScryptParams params = configured;
+        params.logN = logN;
+        string stored = hashPassword("benchmark-password", params);
+
+        // Single-login latency (what one cashier waits for)
+        auto t0 = chrono::steady_clock::now();
+        verifyPassword("benchmark-password", stored);
+        double latencyMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        // Saturated throughput with every core verifying
+        atomic<long long> completed(0);
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned t = 0; t < threadCount; t++) {
+            workers.emplace_back([&]() {
+                do {
+                    verifyPassword("benchmark-password", stored);
+                    completed++;
+                } while (chrono::duration<double>(chrono::steady_clock::now() - start).count() < secondsPerSetting);
+                });
+        }
+        for (auto& w : workers) w.join();
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        double memMiB = (128.0 * params.r * (1 << logN) * params.p) / (1024.0 * 1024.0);
+        cout << "| " << left << setw(6) << (to_string(logN) + (logN == configured.logN ? "*" : ""))
+            << " | " << setw(6) << fixed << setprecision(1) << memMiB << " MiB"
+            << " | " << setw(12) << setprecision(1) << latencyMs
+            << " | " << setw(12) << setprecision(1) << (completed / elapsed) << " |\n";
+    }
+    cout << "+--------+------------+--------------+--------------+\n";
+    cout << "(* = current SCRYPT_LOG_N in config.ini)\n";
+}
+
+// ==========================================
+// 2) OFFLINE JOURNAL REPLAY
+// ==========================================
+void runJournalReplay(sql::Connection* con) {
+    cout << "\n--- Offline Journal ---\n";
+    int pending = pendingJournalEntries();
+    cout << "Pending entries: " << pending << "\n";
+    if (pending == 0) return;
+
+    int applied = replayJournal(con);
+    if (applied < 0) {
+        cout << "[Error] Database still unreachable. Entries kept for the next attempt.\n";
+    }
+    else {
+        cout << "[Success] Applied " << applied << " entries. Remaining: " << pendingJournalEntries() << "\n";
+    }
+}
+
+// ==========================================
+// 3) PRINT QUEUE SIMULATION
+// ==========================================
+void runPrintQueueSimulation() {
+    cout << "\n--- Print Queue Simulation ---\n";
+    int printers = readInt("Number of printers: ");
+    int pagesPerMinute = readInt("Pages per minute per printer: ");
+    int timeScale = readInt("Time scale (e.g., 60 = one simulated minute per second): ");
+    int syntheticJobs = readInt("Extra synthetic peak-hour jobs (0 for none): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cout << "Dispatch real queued jobs from the database too (marks them Done)? (y/n): ";
+    string answer;
+    getline(cin, answer);
+    bool includeReal = !answer.empty() && tolower(answer[0]) == 'y';
+
+    if (printers <= 0 || pagesPerMinute <= 0 || timeScale <= 0 || syntheticJobs < 0) {
+        cout << "[Error] All values must be positive.\n";
+        return;
+    }
+
+    // The queue's flusher runs on its own thread, so it gets its own session
+    ConnectionPool pool(1);
+    PrintQueue queue(pool, printers, pagesPerMinute, timeScale);
+
+    int loaded = includeReal ? queue.loadPending() : 0;
+    mt19937 rng(random_device{}());
+    uniform_int_distribution<int> pages(1, 60);
+    for (int i = 1; i <= syntheticJobs; i++) queue.submit(-i, pages(rng));
+    cout << "Queued: " << loaded << " real + " << syntheticJobs << " synthetic jobs\n";
+    if (loaded + syntheticJobs == 0) return;
+
+    cout << "+----------+--------+----------+--------+---------------+\n";
+    cout << "| " << left << setw(8) << "Sim time" << " | " << setw(6) << "Depth" << " | " << setw(8) << "Printing"
+        << " | " << setw(6) << "Done" << " | " << setw(13) << "Avg wait (s)" << " |\n";
+    cout << "+----------+--------+----------+--------+---------------+\n";
+
+    auto printRow = [&](const QueueMetrics& m) {
+        cout << "| " << right << setw(7) << fixed << setprecision(0) << m.elapsedSeconds << "s"
+            << " | " << setw(6) << m.depth << " | " << setw(8) << m.printing
+            << " | " << setw(6) << m.completed << " | " << setw(13) << setprecision(1) << m.avgWaitMs / 1000.0 << " |\n";
+        };
+
+    queue.start();
+    while (!queue.isIdle()) {
+        this_thread::sleep_for(chrono::seconds(1));
+        printRow(queue.metrics());
+    }
+    queue.stop(true);
+    QueueMetrics m = queue.metrics();
+    cout << "+----------+--------+----------+--------+---------------+\n";
+
+    double minutes = m.elapsedSeconds / 60.0;
+    cout << left << "Jobs completed:   " << m.completed << " (" << m.pagesPrinted << " pages)\n";
+    cout << "Throughput:       " << setprecision(1) << (minutes > 0 ? m.completed / minutes : 0.0) << " jobs/min, "
+        << (minutes > 0 ? m.pagesPrinted / minutes : 0.0) << " pages/min\n";
+    cout << "Wait time:        avg " << m.avgWaitMs / 1000.0 << " s, max " << m.maxWaitMs / 1000.0 << " s (simulated)\n";
+}
+
+// ==========================================
+// 4) RESERVATION STRESS TEST
+// ==========================================
+namespace {
+    struct StressResult {
+        long long attempts = 0;
+        long long pagesTaken = 0;   // net of give-backs
+        double seconds = 0.0;
+    };
+
+    // Every thread grabs random job sizes until the stock runs dry; 1 in 10 successful
+    // reservations is handed back, like a job whose transaction failed
+    StressResult hammerStock(unsigned threadCount, const function<bool(int)>& take, const function<void(int)>& giveBack) {
+        atomic<long long> attempts(0), pagesTaken(0);
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned t = 0; t < threadCount; t++) {
+            workers.emplace_back([&, t]() {
+                mt19937 rng(t * 7919u + 17u);
+                uniform_int_distribution<int> pages(1, 50);
+                int misses = 0;
+                long long localAttempts = 0, localTaken = 0, localPages = 0;
+                while (misses < 200) {
+                    int want = pages(rng);
+                    localAttempts++;
+                    if (!take(want)) {
+                        misses++;
+                        continue;
+                    }
+                    misses = 0;
+                    if (++localTaken % 10 == 0) giveBack(want);
+                    else localPages += want;
+                }
+                attempts += localAttempts;
+                pagesTaken += localPages;
+                });
+        }
+        for (auto& w : workers) w.join();
+
+        StressResult r;
+        r.attempts = attempts;
+        r.pagesTaken = pagesTaken;
+        r.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return r;
+    }
+}
+
+void runReservationStressTest() {
+    cout << "\n--- Inventory Reservation Stress Test ---\n";
+    int threadCount = readInt("Number of threads (e.g., 16): ");
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (threadCount <= 0) {
+        cout << "[Error] Thread count must be positive.\n";
+        return;
+    }
+
+    // Synthetic stock: nothing here touches the database
+    const long long paperStock = 2000000;
+    const long long inkStock = paperStock / 20; // jobs average ~25 pages, so paper runs out first
+
+    // Synthetic bill of materials matching the Standard job: paper 1/page, ink 0.01/page
+    const BomLine paperLine = { 1, 10000 };
+    const BomLine inkLine = { 2, 100 };
+
+    // 1. Lock-free counters (what server mode uses)
+    InventoryReservations reservations(nullptr);
+    reservations.seed({ paperLine, inkLine }, { paperStock, inkStock });
+    StressResult cas = hammerStock(threadCount,
+        [&](int pages) { return reservations.reserve(pages); },
+        [&](int pages) { reservations.release(pages); });
+    long long paperLeft = reservations.available(paperLine.inventoryID);
+    long long inkLeft = reservations.available(inkLine.inventoryID);
+
+    // 2. Same rule behind a mutex, for a throughput baseline
+    mutex stockMutex;
+    long long lockedPaper = paperStock, lockedInk = inkStock;
+    StressResult locked = hammerStock(threadCount,
+        [&](int pages) {
+            lock_guard<mutex> lock(stockMutex);
+            long long paper = unitsForPages(paperLine, pages), ink = unitsForPages(inkLine, pages);
+            if (lockedPaper < paper || lockedInk < ink) return false;
+            lockedPaper -= paper;
+            lockedInk -= ink;
+            return true;
+        },
+        [&](int pages) {
+            lock_guard<mutex> lock(stockMutex);
+            lockedPaper += unitsForPages(paperLine, pages);
+            lockedInk += unitsForPages(inkLine, pages);
+        });
+
+    // 3. Check-then-decrement, the pattern createPrintJob used against the table
+    atomic<long long> naivePaper(paperStock);
+    StressResult naive = hammerStock(threadCount,
+        [&](int pages) {
+            long long seen = naivePaper.load();
+            if (seen < pages) return false;
+            this_thread::yield(); // the gap between SELECT and UPDATE
+            naivePaper.store(seen - pages);
+            return true;
+        },
+        [&](int pages) { naivePaper.fetch_add(pages); });
+
+    cout << "Threads: " << threadCount << " | Paper stock: " << paperStock << " | Ink stock: " << inkStock << "\n";
+    cout << "+----------------------+--------------+--------------+---------------+\n";
+    cout << "| " << left << setw(20) << "Strategy" << " | " << setw(12) << "Pages sold" << " | "
+        << setw(12) << "Oversold" << " | " << setw(13) << "Reserv./sec" << " |\n";
+    cout << "+----------------------+--------------+--------------+---------------+\n";
+    auto row = [&](const string& name, const StressResult& r) {
+        long long oversold = r.pagesTaken > paperStock ? r.pagesTaken - paperStock : 0;
+        cout << "| " << left << setw(20) << name << " | " << right << setw(12) << r.pagesTaken << " | "
+            << setw(12) << oversold << " | " << setw(13) << fixed << setprecision(0) << r.attempts / r.seconds << " |\n";
+        };
+    row("CAS counters", cas);
+    row("Mutex", locked);
+    row("Check-then-update", naive);
+    cout << "+----------------------+--------------+--------------+---------------+\n";
+
+    // Conservation: everything sold plus everything left must equal the starting stock
+    bool paperBalanced = cas.pagesTaken + paperLeft == paperStock && paperLeft >= 0;
+    bool inkSane = inkLeft >= 0 && inkLeft <= inkStock;
+    if (paperBalanced && inkSane) {
+        cout << "[PASS] CAS counters: no oversell (sold " << cas.pagesTaken << " + left " << paperLeft
+            << " = " << paperStock << ", ink left " << inkLeft << ").\n";
+    }
+    else {
+        cout << "[FAIL] CAS counters out of balance: sold " << cas.pagesTaken << ", left " << paperLeft
+            << ", ink left " << inkLeft << ".\n";
+    }
+}
+
+// ==========================================
+// MAIN MENU LOOP
+// ==========================================
+
+void runSystemMaintenance(sql::Connection* con) {
+    int choice;
+    do {
+        cout << "\n=====================================\n";
+        cout << "   System Maintenance Module\n";
+        cout << "=====================================\n";
+        cout << "1. Login Throughput Benchmark\n";
+        cout << "2. Replay Offline Journal (" << pendingJournalEntries() << " pending)\n";
+        cout << "3. Print Queue Simulation\n";
+        cout << "4. Inventory Reservation Stress Test\n";
+        cout << "5. Monthly Partition Maintenance\n";
+        cout << "6. Archive Closed Years\n";
+        cout << "7. Query Plan Check\n";
+        cout << "8. Stored Procedure Benchmark\n";
+        cout << "9. Streaming Memory Benchmark\n";
+        cout << "10. Repository Benchmark\n";
+        cout << "11. Aggregation Kernel Benchmark\n";
+        cout << "12. Read Replica Status\n";
+        cout << "13. Exit\n";
+        cout << "=====================================\n";
+
+        choice = readInt("Enter your choice (1-13): ");
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+        switch (choice) {
+        case 1: runLoginThroughputBenchmark(con); break;
+        case 2: runJournalReplay(con); break;
+        case 3: runPrintQueueSimulation(); break;
+        case 4: runReservationStressTest(); break;
+        case 5: runPartitionMaintenance(con); break;
+        case 6: runColdArchive(con); break;
+        case 7: runQueryPlanCheck(con); break;
+        case 8: runStoredProcedureBenchmark(con); break;
+        case 9: runStreamingMemoryBenchmark(con); break;
+        case 10: runRepositoryBenchmark(con); break;
+        case 11: runAggregationKernelBenchmark(); break;
+        case 12: runReplicaStatus(); break;
+        case 13: cout << "Exiting System Maintenance...\n"; break;
+        default: cout << "[Error] Invalid option\n"; break;
+        }
+
+    } while (choice != 13);
+}
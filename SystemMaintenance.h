@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mysql_connection.h>
+#include <cppconn/driver.h>
+#include <cppconn/exception.h>
+#include <cppconn/resultset.h>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+
+// ==========================================
+// FUNCTION DECLARATIONS
+// ==========================================
+
+// Main Menu Entry Point (Admin only)
+void runSystemMaintenance(sql::Connection* con);
+
+// Measures logins/sec for a range of scrypt cost settings on this machine
+void runLoginThroughputBenchmark(sql::Connection* con);
+
+// Replays journaled offline writes now (normally done automatically on the next write)
+void runJournalReplay(sql::Connection* con);
+
+// Runs queued print jobs (and optional synthetic peak load) through N simulated printers
+void runPrintQueueSimulation();
+
+// Many threads reserving the same stock: checks for oversell and measures reservations/sec
+void runReservationStressTest();
@@ -0,0 +1,315 @@
+#include "TablePartitioning.h"
+#include "db.h"          // getConfigInt()
+#include "ColdArchive.h" // ensureArchiveTable(), archiveRows()
+#include "RowCounts.h"   // adjustRowCount()
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <limits>
+#include <memory>
+#include <cppconn/statement.h>
+#include <cppconn/prepared_statement.h>
+#include <cppconn/resultset.h>
+#include <cppconn/exception.h>
+
+using namespace std;
+using namespace sql;
+
+const char* const PARTITIONED_TABLES[2] = { "payment", "inventoryconsumption" };
+
+// ==========================================
+// HELPERS
+// ==========================================
+// Months are handled as one integer (year * 12 + month - 1) so stepping past
+// December needs no special case.
+
+namespace {
+    const char* const PARTITION_COLUMN = "TimeStamp";
+
+    string monthDate(int ym) {
+        ostringstream oss;
+        oss << (ym / 12) << "-" << setw(2) << setfill('0') << (ym % 12 + 1) << "-01";
+        return oss.str();
+    }
+
+    string partitionName(int ym) {
+        ostringstream oss;
+        oss << "p" << (ym / 12) << setw(2) << setfill('0') << (ym % 12 + 1);
+        return oss.str();
+    }
+
+    // TIMESTAMP columns can only be range-partitioned through UNIX_TIMESTAMP();
+    // DATETIME/DATE use RANGE COLUMNS. Both prune on plain TimeStamp comparisons.
+    bool isTimestampColumn(Connection* con, const string& table) {
+        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+            "SELECT DATA_TYPE FROM information_schema.COLUMNS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND COLUMN_NAME = ?"
+        ));
+        pstmt->setString(1, table);
+        pstmt->setString(2, PARTITION_COLUMN);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        if (!res->next()) throw SQLException("Table " + table + " has no TimeStamp column");
+        return res->getString(1) == "timestamp";
+    }
+
+    string upperBound(bool timestamp, int ym) {
+        return timestamp ? "UNIX_TIMESTAMP('" + monthDate(ym) + " 00:00:00')" : "'" + monthDate(ym) + "'";
+    }
+
+    // Partition holding month ym: everything before the first day of the next month
+    string partitionDef(bool timestamp, int ym) {
+        return "PARTITION " + partitionName(ym) + " VALUES LESS THAN (" + upperBound(timestamp, ym + 1) + ")";
+    }
+
+    int currentMonth(Connection* con) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        unique_ptr<ResultSet> res(stmt->executeQuery("SELECT YEAR(CURDATE()) * 12 + MONTH(CURDATE()) - 1"));
+        res->next();
+        return res->getInt(1);
+    }
+
+    bool tableExists(Connection* con, const string& table) {
+        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+            "SELECT 1 FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?"
+        ));
+        pstmt->setString(1, table);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        return res->next();
+    }
+
+    // Copy of the table's structure without partitions (archive / exchange target)
+    void createPlainCopy(Connection* con, const string& source, const string& target) {
+        unique_ptr<Statement> stmt(con->createStatement());
+        stmt->execute("CREATE TABLE `" + target + "` LIKE `" + source + "`");
+        stmt->execute("ALTER TABLE `" + target + "` REMOVE PARTITIONING");
+    }
+}
+
+// ==========================================
+// INSPECTION
+// ==========================================
+
+bool isPartitionedByMonth(sql::Connection* con, const std::string& table) {
+    unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+        "SELECT 1 FROM information_schema.PARTITIONS "
+        "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND PARTITION_NAME = 'pmax'"
+    ));
+    pstmt->setString(1, table);
+    unique_ptr<ResultSet> res(pstmt->executeQuery());
+    return res->next();
+}
+
+std::vector<MonthPartition> listMonthPartitions(sql::Connection* con, const std::string& table) {
+    vector<MonthPartition> partitions;
+    unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+        "SELECT PARTITION_NAME, TABLE_ROWS FROM information_schema.PARTITIONS "
+        "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND PARTITION_NAME LIKE 'p______' "
+        "ORDER BY PARTITION_ORDINAL_POSITION"
+    ));
+    pstmt->setString(1, table);
+    unique_ptr<ResultSet> res(pstmt->executeQuery());
+    while (res->next()) {
+        MonthPartition p;
+        p.name = res->getString("PARTITION_NAME");
+        try {
+            p.year = stoi(p.name.substr(1, 4));
+            p.month = stoi(p.name.substr(5, 2));
+        }
+        catch (exception&) {
+            continue; // not one of ours
+        }
+        p.rows = res->isNull("TABLE_ROWS") ? 0 : res->getInt64("TABLE_ROWS");
+        partitions.push_back(p);
+    }
+    return partitions;
+}
+
+std::vector<std::string> foreignKeysBlockingPartitioning(sql::Connection* con, const std::string& table) {
+    vector<string> keys;
+    unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+        "SELECT TABLE_NAME, CONSTRAINT_NAME FROM information_schema.REFERENTIAL_CONSTRAINTS "
+        "WHERE CONSTRAINT_SCHEMA = DATABASE() AND (TABLE_NAME = ? OR REFERENCED_TABLE_NAME = ?)"
+    ));
+    pstmt->setString(1, table);
+    pstmt->setString(2, table);
+    unique_ptr<ResultSet> res(pstmt->executeQuery());
+    while (res->next()) keys.push_back(res->getString(1) + "." + res->getString(2));
+    return keys;
+}
+
+// ==========================================
+// CONVERSION & MAINTENANCE
+// ==========================================
+
+void partitionTableByMonth(sql::Connection* con, const std::string& table, int monthsAhead) {
+    if (isPartitionedByMonth(con, table)) return;
+    bool timestamp = isTimestampColumn(con, table);
+    unique_ptr<Statement> stmt(con->createStatement());
+
+    // 1. Unique keys other than the primary key cannot be widened silently
+    {
+        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+            "SELECT INDEX_NAME FROM information_schema.STATISTICS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND NON_UNIQUE = 0 AND INDEX_NAME <> 'PRIMARY' "
+            "GROUP BY INDEX_NAME HAVING SUM(COLUMN_NAME = ?) = 0"
+        ));
+        pstmt->setString(1, table);
+        pstmt->setString(2, PARTITION_COLUMN);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        if (res->next()) {
+            throw SQLException("Unique index " + res->getString(1) + " on " + table +
+                " does not include TimeStamp; add it or drop the index first");
+        }
+    }
+
+    // 2. Foreign keys are not supported on partitioned InnoDB tables
+    for (const string& key : foreignKeysBlockingPartitioning(con, table)) {
+        size_t dot = key.find('.');
+        stmt->execute("ALTER TABLE `" + key.substr(0, dot) + "` DROP FOREIGN KEY `" + key.substr(dot + 1) + "`");
+    }
+
+    // 3. The primary key must contain the partition column
+    vector<string> pkColumns;
+    {
+        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(
+            "SELECT COLUMN_NAME FROM information_schema.STATISTICS "
+            "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND INDEX_NAME = 'PRIMARY' ORDER BY SEQ_IN_INDEX"
+        ));
+        pstmt->setString(1, table);
+        unique_ptr<ResultSet> res(pstmt->executeQuery());
+        while (res->next()) pkColumns.push_back(res->getString(1));
+    }
+    bool pkHasColumn = false;
+    for (const string& column : pkColumns) pkHasColumn = pkHasColumn || column == PARTITION_COLUMN;
+    if (!pkColumns.empty() && !pkHasColumn) {
+        string columns;
+        for (const string& column : pkColumns) columns += "`" + column + "`, ";
+        stmt->execute("ALTER TABLE `" + table + "` DROP PRIMARY KEY, ADD PRIMARY KEY (" + columns + "`" + PARTITION_COLUMN + "`)");
+    }
+
+    // 4. One partition per month from the oldest row, plus the catch-all
+    int now = currentMonth(con);
+    int first = now;
+    {
+        unique_ptr<ResultSet> res(stmt->executeQuery(
+            "SELECT YEAR(MIN(TimeStamp)) * 12 + MONTH(MIN(TimeStamp)) - 1 FROM `" + table + "`"
+        ));
+        if (res->next() && !res->isNull(1) && res->getInt(1) < now) first = res->getInt(1);
+    }
+
+    string sql = "ALTER TABLE `" + table + "` PARTITION BY " +
+        (timestamp ? string("RANGE (UNIX_TIMESTAMP(TimeStamp))") : string("RANGE COLUMNS (TimeStamp)")) + " (";
+    for (int ym = first; ym <= now + monthsAhead; ym++) sql += partitionDef(timestamp, ym) + ", ";
+    sql += "PARTITION pmax VALUES LESS THAN (MAXVALUE))";
+    stmt->execute(sql);
+}
+
+int addFuturePartitions(sql::Connection* con, const std::string& table, int monthsAhead) {
+    vector<MonthPartition> partitions = listMonthPartitions(con, table);
+    if (partitions.empty()) return 0;
+
+    int last = partitions.back().year * 12 + partitions.back().month - 1;
+    int target = currentMonth(con) + monthsAhead;
+    if (last >= target) return 0;
+
+    // Splitting pmax only moves the rows it holds, which is none while maintenance keeps up
+    bool timestamp = isTimestampColumn(con, table);
+    string sql = "ALTER TABLE `" + table + "` REORGANIZE PARTITION pmax INTO (";
+    for (int ym = last + 1; ym <= target; ym++) sql += partitionDef(timestamp, ym) + ", ";
+    sql += "PARTITION pmax VALUES LESS THAN (MAXVALUE))";
+
+    unique_ptr<Statement> stmt(con->createStatement());
+    stmt->execute(sql);
+    return target - last;
+}
+
+int archiveOldPartitions(sql::Connection* con, const std::string& table, int keepMonths) {
+    if (keepMonths <= 0) return 0;
+    const string staging = table + "_exchange";
+    unique_ptr<Statement> stmt(con->createStatement());
+
+    ensureArchiveTable(con, table);
+
+    // Moves whatever the staging table holds into the archive (aggregates included)
+    // and leaves it empty, so a run interrupted at any point can simply be repeated
+    auto drainStaging = [&]() {
+        try {
+            con->setAutoCommit(false);
+            // The exchanged rows left the live table without firing its delete trigger
+            adjustRowCount(con, table, -archiveRows(con, table, staging, "1 = 1"));
+            con->commit();
+            con->setAutoCommit(true);
+        }
+        catch (SQLException&) {
+            try {
+                con->rollback();
+                con->setAutoCommit(true);
+            }
+            catch (SQLException&) {}
+            throw;
+        }
+        stmt->execute("DROP TABLE `" + staging + "`");
+    };
+
+    // Rows left behind by an interrupted run were already taken out of the live table
+    if (tableExists(con, staging)) drainStaging();
+
+    int cutoff = currentMonth(con) - keepMonths;
+    int archived = 0;
+    for (const MonthPartition& p : listMonthPartitions(con, table)) {
+        if (p.year * 12 + p.month - 1 >= cutoff) break;
+
+        // EXCHANGE swaps the month out as a metadata change; the copy into the
+        // archive then runs against the staging table, not the live one
+        createPlainCopy(con, table, staging);
+        stmt->execute("ALTER TABLE `" + table + "` EXCHANGE PARTITION " + p.name + " WITH TABLE `" + staging + "`");
+        drainStaging();
+        stmt->execute("ALTER TABLE `" + table + "` DROP PARTITION " + p.name);
+        archived++;
+    }
+    return archived;
+}
+
+// ==========================================
+// MAINTENANCE COMMAND
+// ==========================================
+
+void runPartitionMaintenance(sql::Connection* con) {
+    const int monthsAhead = getConfigInt("PARTITION_MONTHS_AHEAD", 3);
+    const int keepMonths = getConfigInt("PARTITION_ARCHIVE_AFTER_MONTHS", 0);
+
+    cout << "\n--- Monthly Partition Maintenance ---\n";
+    cout << "Months pre-created ahead: " << monthsAhead << " | Archive after: "
+        << (keepMonths > 0 ? to_string(keepMonths) + " months" : string("never")) << "\n";
+
+    for (const char* table : PARTITIONED_TABLES) {
+        try {
+            if (!isPartitionedByMonth(con, table)) {
+                cout << "\n[" << table << "] Not partitioned.\n";
+                vector<string> keys = foreignKeysBlockingPartitioning(con, table);
+                for (const string& key : keys) cout << "  Foreign key " << key << " will be dropped.\n";
+
+                cout << "Partition " << table << " by month now? This rebuilds the table (y/n): ";
+                string answer;
+                getline(cin, answer);
+                if (answer.empty() || tolower(answer[0]) != 'y') continue;
+
+                partitionTableByMonth(con, table, monthsAhead);
+                cout << "  Converted.\n";
+            }
+
+            int added = addFuturePartitions(con, table, monthsAhead);
+            int archived = archiveOldPartitions(con, table, keepMonths);
+
+            vector<MonthPartition> partitions = listMonthPartitions(con, table);
+            long long rows = 0;
+            for (const MonthPartition& p : partitions) rows += p.rows;
+            cout << "\n[" << table << "] " << partitions.size() << " month partitions";
+            if (!partitions.empty()) cout << " (" << partitions.front().name << " .. " << partitions.back().name << ")";
+            cout << ", ~" << rows << " rows. Added " << added << ", archived " << archived << ".\n";
+        }
+        catch (SQLException& e) {
+            cerr << "[Error] Partition maintenance on " << table << " failed: " << e.what() << endl;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mysql_connection.h>
+
+// ==========================================
+// MONTHLY PARTITIONS (payment, inventoryconsumption)
+// ==========================================
+// Both tables only grow and every report filters one month (or year) on
+// TimeStamp, so they are RANGE-partitioned by month: partition pYYYYMM holds
+// that month, and a catch-all pmax keeps inserts working if maintenance is late.
+// Reports use `TimeStamp >= start AND TimeStamp < end` so MySQL prunes to the
+// partitions in range.
+//
+// Maintenance pre-creates PARTITION_MONTHS_AHEAD empty months by splitting pmax
+// (cheap while pmax is empty) and, if PARTITION_ARCHIVE_AFTER_MONTHS > 0, moves
+// older months to the cold archive (ColdArchive.h) with EXCHANGE PARTITION,
+// folding them into the archive aggregates, and drops them.
+//
+// MySQL requires the partition column in every unique key and allows no foreign
+// keys on partitioned tables, so conversion widens the primary key with TimeStamp
+// and drops foreign keys on (or pointing at) the table.
+
+struct MonthPartition {
+    std::string name;   // pYYYYMM
+    int year = 0;
+    int month = 0;
+    long long rows = 0; // optimizer estimate
+};
+
+// Tables this module manages
+extern const char* const PARTITIONED_TABLES[2];
+
+bool isPartitionedByMonth(sql::Connection* con, const std::string& table);
+
+// Month partitions in order (pmax excluded)
+std::vector<MonthPartition> listMonthPartitions(sql::Connection* con, const std::string& table);
+
+// Foreign keys that conversion would drop, as "table.constraint"
+std::vector<std::string> foreignKeysBlockingPartitioning(sql::Connection* con, const std::string& table);
+
+// Rebuilds the table partitioned by month, from its oldest row to monthsAhead past
+// the current month. Throws sql::SQLException.
+void partitionTableByMonth(sql::Connection* con, const std::string& table, int monthsAhead);
+
+// Splits pmax so every month up to monthsAhead exists; returns partitions added
+int addFuturePartitions(sql::Connection* con, const std::string& table, int monthsAhead);
+
+// Moves months ending before (current month - keepMonths) to <table>_archive and
+// the monthly archive aggregates; returns partitions archived
+int archiveOldPartitions(sql::Connection* con, const std::string& table, int keepMonths);
+
+// System Maintenance command: converts (with confirmation), pre-creates and archives
+void runPartitionMaintenance(sql::Connection* con);
@@ -0,0 +1,133 @@
+#include "XDevApiRepository.h"
+#include "db.h"
+#include <mysqlx/xdevapi.h>
+#include <iostream>
+#include <future>
+#include <mutex>
+
+using namespace std;
+
+namespace {
+    // Sessions a single repository call can hold at once (salesTotals uses three)
+    const int X_POOL_SIZE = 8;
+
+    mutex g_clientMutex;
+    unique_ptr<mysqlx::Client> g_client;
+    bool g_clientFailed = false;
+
+    // "tcp://localhost:3306" -> "localhost"
+    string hostFromConfig() {
+        string host = getConfigValue("DB_HOST", "tcp://localhost:3306");
+        size_t scheme = host.find("://");
+        if (scheme != string::npos) host = host.substr(scheme + 3);
+        size_t port = host.rfind(':');
+        if (port != string::npos) host = host.substr(0, port);
+        return host;
+    }
+
+    // Process-wide pooled client, created on first use; null once it has failed
+    mysqlx::Client* sharedClient() {
+        lock_guard<mutex> lock(g_clientMutex);
+        if (g_client || g_clientFailed) return g_client.get();
+        try {
+            g_client.reset(new mysqlx::Client(
+                mysqlx::SessionOption::HOST, hostFromConfig(),
+                mysqlx::SessionOption::PORT, getConfigInt("XDEVAPI_PORT", 33060),
+                mysqlx::SessionOption::USER, getConfigValue("DB_USER"),
+                mysqlx::SessionOption::PWD, getConfigValue("DB_PASS"),
+                mysqlx::SessionOption::DB, getConfigValue("DB_NAME"),
+                mysqlx::ClientOption::POOLING, true,
+                mysqlx::ClientOption::POOL_MAX_SIZE, X_POOL_SIZE));
+            // Fail now rather than on the first report if the port is closed
+            mysqlx::Session probe = g_client->getSession();
+            probe.sql("SELECT 1").execute();
+        }
+        catch (const mysqlx::Error& e) {
+            cerr << "[X DevAPI] Unavailable (" << e.what() << "); using the JDBC backend." << endl;
+            g_client.reset();
+            g_clientFailed = true;
+        }
+        return g_client.get();
+    }
+
+    double firstDouble(mysqlx::SqlResult res, double fallback) {
+        mysqlx::Row row = res.fetchOne();
+        return (!row || row[0].isNull()) ? fallback : row[0].get<double>();
+    }
+
+    // One value from a query on its own pooled session; NULL or no row reads as `fallback`
+    template <typename... Args>
+    double queryDouble(mysqlx::Client* client, double fallback, const string& sql, int first, Args... rest) {
+        mysqlx::Session session = client->getSession();
+        return firstDouble(session.sql(sql).bind(first, rest...).execute(), fallback);
+    }
+
+    // Amounts are cast to CHAR by the query so they arrive as exact decimal text.
+    // False when there is no row or the value is NULL.
+    bool firstMoney(mysqlx::SqlResult res, Money& amount) {
+        mysqlx::Row row = res.fetchOne();
+        return row && !row[0].isNull() && Money::parse(row[0].get<string>(), amount);
+    }
+
+    Money queryMoney(mysqlx::Client* client, const string& sql) {
+        mysqlx::Session session = client->getSession();
+        Money amount;
+        firstMoney(session.sql(sql).execute(), amount);
+        return amount;
+    }
+
+    class XDevApiRepository : public ShopRepository {
+    public:
+        explicit XDevApiRepository(mysqlx::Client* client) : client_(client) {}
+
+        const char* backendName() const override { return "xdevapi"; }
+
+        PaymentCheck checkPayment(int userID, int jobID) override {
+            // Both lookups are in flight before either answer is read
+            auto paid = async(launch::async, [=]() {
+                return queryDouble(client_, 0.0, "SELECT EXISTS (SELECT 1 FROM payment WHERE JobID = ?)", jobID);
+                });
+            auto cost = async(launch::async, [=]() {
+                mysqlx::Session session = client_->getSession();
+                PaymentCheck found;
+                found.jobFound = firstMoney(session.sql(
+                    "SELECT CAST(JobCost AS CHAR) FROM printjob WHERE JobID = ? AND UserID = ? LIMIT 1")
+                    .bind(jobID, userID).execute(), found.jobCost);
+                return found;
+                });
+
+            PaymentCheck check = cost.get();
+            check.alreadyPaid = paid.get() > 0;
+            return check;
+        }
+
+        SalesTotals salesTotals() override {
+            auto jobCost = async(launch::async, [=]() {
+                return queryMoney(client_, "SELECT CAST(SUM(JobCost) AS CHAR) FROM printjob");
+                });
+            auto operationCost = async(launch::async, [=]() {
+                return queryMoney(client_,
+                    "SELECT CAST(ROUND(SUM(cl.QuantityUsed * i.UnitCost), 2) AS CHAR) "
+                    "FROM inventoryconsumption cl JOIN inventory i ON cl.InventoryID = i.InventoryID");
+                });
+            auto revenue = async(launch::async, [=]() {
+                return queryMoney(client_, "SELECT CAST(SUM(Amount) AS CHAR) FROM payment WHERE PaymentStatus = 'Complete'");
+                });
+
+            SalesTotals totals;
+            totals.jobCost = jobCost.get();
+            totals.operationCost = operationCost.get();
+            totals.revenue = revenue.get();
+            return totals;
+        }
+
+    private:
+        mysqlx::Client* client_;
+    };
+}
+
+std::unique_ptr<ShopRepository> makeXDevApiRepository() {
+    mysqlx::Client* client = sharedClient();
+    if (!client) return nullptr;
+    return std::unique_ptr<ShopRepository>(new XDevApiRepository(client));
+}
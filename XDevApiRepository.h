@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ShopRepository.h"
+
+// ==========================================
+// X DEVAPI BACKEND (DB_BACKEND=xdevapi)
+// ==========================================
+// Talks X Protocol to the server's mysqlx port (XDEVAPI_PORT, default 33060)
+// with the DB_HOST/DB_USER/DB_PASS/DB_NAME credentials. A process-wide pooled
+// mysqlx::Client hands each independent query its own session, and the queries
+// of one repository call run concurrently, so the call takes about as long as
+// its slowest query rather than the sum of all of them.
+//
+// This connector release has no executeAsync(), so the overlap comes from
+// std::async over pooled sessions rather than pipelining on one session.
+
+// Null when the X Protocol port cannot be reached (the reason is printed once)
+std::unique_ptr<ShopRepository> makeXDevApiRepository();
@@ -3,14 +3,22 @@
 #include <cppconn/prepared_statement.h>
 #include <iostream>
 #include "utils.h"
+#include "PasswordHash.h"
+#include "ResilientConnection.h"
+#include "QueryPlanCheck.h"
 #include <fstream>
+#include <future>
 #include <map>
+#include <vector>
 // Helper to read the config file
 std::map<std::string, std::string> loadConfig(const std::string& filename) {
     std::map<std::string, std::string> config;
     std::ifstream file(filename);
     std::string line;
     while (std::getline(file, line)) {
+        // Tolerate CRLF files and allow '#' comment lines
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
         size_t delimiter = line.find('=');
         if (delimiter != std::string::npos) {
             std::string key = line.substr(0, delimiter);
@@ -21,6 +29,23 @@ std::map<std::string, std::string> loadConfig(const std::string& filename) {
     return config;
 }
 
+std::string getConfigValue(const std::string& key, const std::string& fallback) {
+    static const std::map<std::string, std::string> config = loadConfig("config.ini");
+    auto it = config.find(key);
+    return (it != config.end() && !it->second.empty()) ? it->second : fallback;
+}
+
+int getConfigInt(const std::string& key, int fallback) {
+    std::string value = getConfigValue(key);
+    if (value.empty()) return fallback;
+    try {
+        return std::stoi(value);
+    }
+    catch (...) {
+        return fallback;
+    }
+}
+
 
 /*const std::string server = "tcp://139.162.57.13:3306";
 const std::string username = "print";
@@ -53,12 +78,60 @@ sql::Connection* connectDB() {
         std::cout << "Database connection successful!\n";
     }
     catch (sql::SQLException& e) {
+        // No exit(1) here: the caller decides whether to retry or quit
         std::cout << "Database connection error: " << e.what() << "\n";
-        exit(1);
+        delete con;
+        return nullptr;
     }
     return con;
 }
 
+namespace {
+    const char* const SQL_LOGIN = "SELECT UserID, Role, Password FROM user WHERE FullName = ?";
+    const PlanRegistration planLogin("login", "db.cpp", SQL_LOGIN, { "Seed Customer 17" });
+}
+
+// Non-interactive credential check shared by the console login and server mode
+bool authenticateUser(sql::Connection* con, const std::string& username, const std::string& password,
+    int& userID, std::string& role) {
+    // Look the account up by (indexed) name only; the password is checked client-side
+    struct Account { int userID; std::string role; std::string stored; };
+    std::vector<Account> accounts = withReadRetry(con, [&]() {
+        std::vector<Account> rows;
+        sql::PreparedStatement* stmt = cachedStatement(con, SQL_LOGIN);
+        stmt->setString(1, username);
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
+        while (res->next()) {
+            rows.push_back({ res->getInt("UserID"), res->getString("Role"), res->getString("Password") });
+        }
+        return rows;
+        });
+
+    for (const Account& account : accounts) {
+        const std::string& stored = account.stored;
+
+        // scrypt is deliberately slow, so verify on a worker thread
+        std::future<bool> check = std::async(std::launch::async, verifyPassword, password, stored);
+        if (!check.get()) continue;
+
+        // Upgrade legacy plain-text rows (and hashes made with old cost settings)
+        ScryptParams params = loadScryptParams();
+        if (stored != "N/A" && needsRehash(stored, params)) {
+            std::unique_ptr<sql::PreparedStatement> upd(
+                con->prepareStatement("UPDATE user SET Password = ? WHERE UserID = ?")
+            );
+            upd->setString(1, hashPassword(password, params));
+            upd->setInt(2, account.userID);
+            upd->executeUpdate();
+        }
+
+        userID = account.userID;
+        role = account.role;
+        return true;
+    }
+    return false;
+}
+
 /*bool login(sql::Connection* con, std::string& role) {
     std::string username, password;
     std::cout << "=== Login ===\n";
@@ -78,17 +151,9 @@ bool login(sql::Connection* con, std::string& role) {
     // ************************
 
     try {
-        std::unique_ptr<sql::PreparedStatement> stmt(
-            con->prepareStatement("SELECT Role FROM user WHERE FullName = ? AND Password = ?")
-        );
-        stmt->setString(1, username);
-        stmt->setString(2, password);
-
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery());
-        if (res->next()) {
-            role = res->getString("Role");
-            return true;
-        }
+        int userID = 0;
+        std::cout << "Verifying credentials...\n";
+        if (authenticateUser(con, username, password, userID, role)) return true;
         std::cout << "Invalid login.\n";
         return false;
     }
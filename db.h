@@ -1,7 +1,17 @@
 
 #pragma once
 #include <string>
+#include <map>
 #include <mysql_connection.h>
 
+// Config file helpers (config.ini is read once and cached)
+std::map<std::string, std::string> loadConfig(const std::string& filename);
+std::string getConfigValue(const std::string& key, const std::string& fallback = "");
+int getConfigInt(const std::string& key, int fallback);
+
 sql::Connection* connectDB();
 bool login(sql::Connection* con, std::string& role);
+
+// Checks a name/password pair without prompting; throws sql::SQLException on DB errors
+bool authenticateUser(sql::Connection* con, const std::string& username, const std::string& password,
+    int& userID, std::string& role);
@@ -9,6 +9,8 @@
 #include "InventoryManagement.h"
 #include "SalesAnalysis.h"
 #include "ReportGeneration.h"
+#include "SystemMaintenance.h"
+#include "OfflineJournal.h"
 
 using namespace std;
 
@@ -218,6 +220,7 @@ void MainMenu(sql::Connection* con) {
     while (!login(con, role)) {
         cout << "Login failed. Please try again.\n";
     }
+    syncJournalIfPending(con);
 
     // MAIN MENU LOOP
     while (true) {
@@ -234,6 +237,7 @@ void MainMenu(sql::Connection* con) {
         if (role == "Admin") {
             
             cout << "5. Report Generation\n";
+            cout << "6. System Maintenance\n";
         }
 
         cout << "7. Logout\n";
@@ -282,6 +286,13 @@ void MainMenu(sql::Connection* con) {
             }
             break;
 
+        case 6:
+            if (role == "Admin") {
+                cout << "[System Maintenance Module]\n";
+                runSystemMaintenance(con);
+            }
+            break;
+
         case 7:
             cout << "Logging out...\n";
             return;
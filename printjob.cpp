@@ -2,25 +2,64 @@
 #include "utils.h" // For readInt, cin.ignore, clearScreen (assuming it's here)
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <iomanip>
 #include <cppconn/prepared_statement.h>
 #include <cppconn/resultset.h>
 #include <cppconn/statement.h> // Include for statement and last_insert_id
+#include "OfflineJournal.h"
+#include "ResilientConnection.h"
+#include "ConsumptionForecast.h"
+#include "BillOfMaterials.h"
+#include "StoredProcedures.h"
+#include "Repositories.h"
+#include "CustomerDirectory.h"
+#include "RowCounts.h"
+#include "ListPager.h"
+#include "QueryPlanCheck.h"
+#include "Money.h"
+#include <map>
+#include <algorithm>
 
 using namespace std;
 using namespace sql;
 
+namespace {
+    const char* const SQL_CUSTOMER_CHECK = "SELECT 1 FROM user WHERE UserID = ? AND Role = 'Customer' LIMIT 1";
+    const char* const SQL_CUSTOMER_SEARCH = "SELECT UserID, FullName, Email FROM user WHERE FullName LIKE ? AND Role = 'Customer'";
+    const char* const SQL_JOB_DETAILS = "SELECT UserID, PageCount, TimeStamp, CostPerPage, JobCost FROM printjob WHERE JobID = ?";
+    const char* const SQL_JOBS_FOR_USER = "SELECT JobID, PageCount, TimeStamp, JobCost FROM printjob WHERE UserID = ? ORDER BY TimeStamp DESC";
+    const char* const SQL_JOB_LIST =
+        "SELECT p.JobID, p.UserID, u.FullName, p.PageCount, p.JobCost "
+        "FROM printjob p JOIN user u ON p.UserID = u.UserID "
+        "ORDER BY p.JobID DESC";
+    // hasMaterials() builds the IN list; this is its shape for the two standard materials
+    const char* const SQL_STOCK_CHECK_SHAPE = "SELECT InventoryID, Quantity FROM inventory WHERE InventoryID IN (?, ?)";
+
+    const PlanRegistration planCustomerCheck("customer_check", "printjob.cpp", SQL_CUSTOMER_CHECK, { "17" });
+    const PlanRegistration planCustomerSearch("customer_search", "printjob.cpp", SQL_CUSTOMER_SEARCH, { "%Customer 17%" });
+    const PlanRegistration planJobDetails("job_details", "printjob.cpp", SQL_JOB_DETAILS, { "17" });
+    const PlanRegistration planJobsForUser("jobs_for_user", "printjob.cpp", SQL_JOBS_FOR_USER, { "17" });
+    const PlanRegistration planJobList("job_list", "printjob.cpp", SQL_JOB_LIST, {});
+    const PlanRegistration planStockCheck("stock_check", "printjob.cpp", SQL_STOCK_CHECK_SHAPE, { "1", "2" });
+}
+
 // --- Helper Functions (No Change, but assumed isCustomerUser is defined elsewhere) ---
 bool isCustomerUser(Connection* con, int userID) {
     try {
-        unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT 1 FROM user WHERE UserID = ? AND Role = 'Customer' LIMIT 1")
-        );
-        pstmt->setInt(1, userID);
-        unique_ptr<ResultSet> res(pstmt->executeQuery());
-        return res->next(); // True only if user is a Customer
+        return withReadRetry(con, [&]() {
+            PreparedStatement* pstmt = cachedStatement(con, SQL_CUSTOMER_CHECK);
+            pstmt->setInt(1, userID);
+            unique_ptr<ResultSet> res(pstmt->executeQuery());
+            return res->next(); // True only if user is a Customer
+        });
     }
     catch (SQLException& e) {
+        if (isConnectionLost(e)) {
+            // Offline: accept the ID now so the job is journaled; the replay re-checks it
+            markDatabaseOffline();
+            return true;
+        }
         cerr << "Database Error (Customer User Check): " << e.what() << endl;
         return false;
     }
@@ -29,14 +68,19 @@ bool isCustomerUser(Connection* con, int userID) {
 bool doesUserExist(sql::Connection* con, int userID) {
     // NOTE: This should ideally be replaced by isCustomerUser for job creation context
     try {
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement("SELECT 1 FROM user WHERE UserID = ? LIMIT 1")
-        );
-        pstmt->setInt(1, userID);
-        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-        return res->next(); // True if user exists
+        return withReadRetry(con, [&]() {
+            sql::PreparedStatement* pstmt = cachedStatement(con, "SELECT 1 FROM user WHERE UserID = ? LIMIT 1");
+            pstmt->setInt(1, userID);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            return res->next(); // True if user exists
+        });
     }
     catch (sql::SQLException& e) {
+        if (isConnectionLost(e)) {
+            // Offline: accept the ID now, the journal replay re-checks it
+            markDatabaseOffline();
+            return true;
+        }
         cerr << "Database Error (User Check): " << e.what() << endl;
         return false;
     }
@@ -44,12 +88,12 @@ bool doesUserExist(sql::Connection* con, int userID) {
 
 bool doesJobExist(sql::Connection* con, int jobID) {
     try {
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement("SELECT 1 FROM printjob WHERE JobID = ? LIMIT 1")
-        );
-        pstmt->setInt(1, jobID);
-        unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-        return res->next(); // True if job exists
+        return withReadRetry(con, [&]() {
+            sql::PreparedStatement* pstmt = cachedStatement(con, "SELECT 1 FROM printjob WHERE JobID = ? LIMIT 1");
+            pstmt->setInt(1, jobID);
+            unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+            return res->next(); // True if job exists
+        });
     }
     catch (sql::SQLException& e) {
         cerr << "Database Error (Job Check): " << e.what() << endl;
@@ -57,39 +101,42 @@ bool doesJobExist(sql::Connection* con, int jobID) {
     }
 }
 
-bool isInventorySufficient(sql::Connection* con, int pageCount) {
-    try {
-        // Query both Paper and Ink quantities
-        std::unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement("SELECT ItemType, Quantity FROM inventory WHERE ItemType IN ('Paper', 'Ink')")
-        );
-
-        std::unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-
-        int paperLeft = 0;
-        int inkLeft = 0;
+// Checks current stock against a list of needs, naming the first item that is short
+static bool hasMaterials(sql::Connection* con, const std::vector<MaterialNeed>& needs) {
+    if (needs.empty()) return true;
 
-        while (res->next()) {
-            std::string type = res->getString("ItemType");
-            if (type == "Paper") paperLeft = res->getInt("Quantity");
-            if (type == "Ink") inkLeft = res->getInt("Quantity");
-        }
+    std::string ids;
+    for (const MaterialNeed& need : needs) ids += (ids.empty() ? "" : ",") + std::to_string(need.inventoryID);
 
-        // Logic: 1 unit of Ink is required for every 100 pages (Adjust ratio as needed)
-        int inkRequired = (pageCount + 99) / 100;
-
-        if (paperLeft < pageCount) {
-            std::cout << "[Error] Insufficient Paper. Need: " << pageCount << ", Have: " << paperLeft << std::endl;
-            return false;
-        }
-        if (inkLeft < inkRequired) {
-            std::cout << "[Error] Insufficient Ink. Need: " << inkRequired << " units, Have: " << inkLeft << std::endl;
-            return false;
-        }
+    std::map<int, long long> left;
+    withReadRetry(con, [&]() {
+        std::unique_ptr<sql::Statement> stmt(con->createStatement());
+        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(
+            "SELECT InventoryID, Quantity FROM inventory WHERE InventoryID IN (" + ids + ")"));
+        left.clear();
+        while (res->next()) left[res->getInt("InventoryID")] = res->getInt64("Quantity");
+        });
+
+    for (const MaterialNeed& need : needs) {
+        if (need.units <= 0 || left[need.inventoryID] >= need.units) continue;
+        std::cout << "[Error] Insufficient " << materialName(con, need.inventoryID) << ". Need: " << need.units
+            << ", Have: " << left[need.inventoryID] << std::endl;
+        return false;
+    }
+    return true;
+}
 
-        return true;
+bool isInventorySufficient(sql::Connection* con, int pageCount) {
+    try {
+        // Every item the job type's bill of materials draws from, in one query
+        return hasMaterials(con, materialsForPages(bomForJobType(con), pageCount));
     }
     catch (sql::SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline();
+            std::cout << "[Offline] Stock check deferred until the database is back." << std::endl;
+            return true;
+        }
         std::cerr << "Database Error: " << e.what() << std::endl;
         return false;
     }
@@ -151,78 +198,118 @@ bool isInventorySufficient(sql::Connection* con, int pageCount) {
         cerr << "Error creating print job: " << e.what() << endl;
     }
 }*/
-//test cretae print job with auto consumption 
-void createPrintJob(sql::Connection* con, int userID, int pageCount, double costPerPage) {
+// Inserts the job row plus its bill-of-materials consumption. Shared by createPrintJob and
+// the offline journal replay; the caller owns the transaction.
+int insertPrintJobRecord(sql::Connection* con, int userID, int pageCount, double costPerPage,
+    const std::string& timeStamp, StockUpdate stock, int queuePriority) {
     int newJobID = -1;
 
-    try {
-        // 1. Insert the Print Job into the database
-        unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement(
-                "INSERT INTO printjob (UserID, PageCount, CostPerPage, TimeStamp) "
-                "VALUES (?, ?, ?, NOW())"
-            )
-        );
-        pstmt->setInt(1, userID);
-        pstmt->setInt(2, pageCount);
-        pstmt->setDouble(3, costPerPage);
-        pstmt->executeUpdate();
+    // 1. Insert the Print Job (journal replays keep their original timestamp)
+    const bool queued = queuePriority >= 0;
+    unique_ptr<sql::PreparedStatement> pstmt(
+        con->prepareStatement(
+            timeStamp.empty()
+            ? "INSERT INTO printjob (UserID, PageCount, CostPerPage, Status, Priority, TimeStamp) VALUES (?, ?, ?, ?, ?, NOW())"
+            : "INSERT INTO printjob (UserID, PageCount, CostPerPage, Status, Priority, TimeStamp) VALUES (?, ?, ?, ?, ?, ?)"
+        )
+    );
+    pstmt->setInt(1, userID);
+    pstmt->setInt(2, pageCount);
+    pstmt->setDouble(3, costPerPage);
+    pstmt->setString(4, queued ? "Queued" : "Done");
+    pstmt->setInt(5, queued ? std::min(queuePriority, MAX_QUEUE_PRIORITY) : 0);
+    if (!timeStamp.empty()) pstmt->setString(6, timeStamp);
+    pstmt->executeUpdate();
+
+    // Retrieve the generated JobID
+    std::unique_ptr<sql::Statement> stmt(con->createStatement());
+    std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT LAST_INSERT_ID() AS last_id"));
+    if (res->next()) {
+        newJobID = res->getInt("last_id");
+    }
+    if (newJobID == -1) return -1;
 
-        // Retrieve the generated JobID
-        std::unique_ptr<sql::Statement> stmt(con->createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT LAST_INSERT_ID() AS last_id"));
-        if (res->next()) {
-            newJobID = res->getInt("last_id");
-        }
+    // Stock is batched by the reservation service, which also writes the usage log
+    if (stock == StockUpdate::Deferred) return newJobID;
 
-        if (newJobID != -1) {
-            // 2. Record Consumption for Paper
-            // Update inventory Quantity (Stock Left)
-            unique_ptr<sql::PreparedStatement> paperUpdate(
-                con->prepareStatement("UPDATE inventory SET Quantity = Quantity - ? WHERE ItemType = 'Paper'")
-            );
-            paperUpdate->setInt(1, pageCount);
-            paperUpdate->executeUpdate();
+    // 2. Take and log every item on the bill of materials
+    std::vector<MaterialNeed> needs = materialsForPages(bomForJobType(con), pageCount);
+    applyMaterialUsage(con, needs, stock == StockUpdate::Guarded);
+    logMaterialUsage(con, needs);
 
-            // Log usage for reports (Total Consumed)
-            unique_ptr<sql::PreparedStatement> paperLog(
-                con->prepareStatement("INSERT INTO inventoryconsumption (InventoryID, QuantityUsed) SELECT InventoryID, ? FROM inventory WHERE ItemType = 'Paper'")
-            );
-            paperLog->setInt(1, pageCount);
-            paperLog->executeUpdate();
+    return newJobID;
+}
 
-            // 3. Record Consumption for Ink
-            // Use the same ratio (1 unit per 100 pages) as isInventorySufficient
-            int inkUsed = (pageCount + 99) / 100;
+// The job rules on any backend: customers only, and every bill-of-materials item
+// must be in stock before the job is written
+int placePrintJob(UserRepo& users, PrintJobRepo& jobs, InventoryRepo& inventory, BomRange bom,
+    int userID, int pageCount, double costPerPage, const std::string& timeStamp, int queuePriority, std::string& error) {
+    if (pageCount <= 0) {
+        error = "Page count must be positive.";
+        return -1;
+    }
+    if (!users.isCustomer(userID)) {
+        error = "User " + std::to_string(userID) + " is not a customer.";
+        return -1;
+    }
+    int shortItem = 0;
+    if (!inventory.take(materialsForPages(bom, pageCount), shortItem)) {
+        error = "Insufficient stock of item #" + std::to_string(shortItem) + ".";
+        return -1;
+    }
+    return jobs.addJob(userID, pageCount, costPerPage, timeStamp, queuePriority);
+}
 
-            unique_ptr<sql::PreparedStatement> inkUpdate(
-                con->prepareStatement("UPDATE inventory SET Quantity = Quantity - ? WHERE ItemType = 'Ink'")
-            );
-            inkUpdate->setInt(1, inkUsed);
-            inkUpdate->executeUpdate();
+int placePrintJobRecord(sql::Connection* con, int userID, int pageCount, double costPerPage,
+    int queuePriority, std::string& error) {
+    std::unique_ptr<Repositories> repos = makeMySqlRepositories(con);
+    return placePrintJob(*repos, *repos, *repos, bomForJobType(con), userID, pageCount, costPerPage, "", queuePriority, error);
+}
 
-            unique_ptr<sql::PreparedStatement> inkLog(
-                con->prepareStatement("INSERT INTO inventoryconsumption (InventoryID, QuantityUsed) SELECT InventoryID, ? FROM inventory WHERE ItemType = 'Ink'")
-            );
-            inkLog->setInt(1, inkUsed);
-            inkLog->executeUpdate();
+//test cretae print job with auto consumption 
+void createPrintJob(sql::Connection* con, int userID, int pageCount, double costPerPage) {
+    // Push any offline work first so IDs and stock stay in order
+    syncJournalIfPending(con);
+
+    if (!isDatabaseOnline()) {
+        std::string key = journalPrintJob(userID, pageCount, costPerPage);
+        std::cout << "\n[Offline] Print Job saved to the local journal (" << key << ").\n";
+        std::cout << "It will be recorded when the database connection returns." << std::endl;
+        return;
+    }
 
-            // 4. Retrieve and display JobCost
-            std::unique_ptr<sql::PreparedStatement> costPstmt(
-                con->prepareStatement("SELECT JobCost FROM printjob WHERE JobID = ?")
-            );
-            costPstmt->setInt(1, newJobID);
-            std::unique_ptr<sql::ResultSet> costRes(costPstmt->executeQuery());
+    try {
+        // Stock check, job, consumption and cost in one CALL; it commits or writes nothing
+        Money jobCost;
+        std::string error;
+        int newJobID = runWrite(con, [&]() {
+            return callCreateJob(con, userID, pageCount, costPerPage, jobCost, error);
+            });
+
+        if (newJobID == -1) {
+            std::cout << "[Error] " << error << std::endl;
+            return;
+        }
 
-            if (costRes->next()) {
-                double jobCost = costRes->getDouble("JobCost");
-                std::cout << "\n[Success] Print Job & Consumption recorded!" << std::endl;
-                std::cout << "JobID: " << newJobID << " | Calculated Cost: $" << std::fixed << std::setprecision(2) << jobCost << std::endl;
-                std::cout << "Materials Used: " << pageCount << " pages and " << inkUsed << " units of ink." << std::endl;
-            }
+        std::cout << "\n[Success] Print Job & Consumption recorded!" << std::endl;
+        std::cout << "JobID: " << newJobID << " | Calculated Cost: $" << jobCost << std::endl;
+        std::cout << "Materials Used:";
+        for (const MaterialNeed& need : materialsForPages(bomForJobType(con), pageCount)) {
+            std::cout << " " << need.units << " x " << materialName(con, need.inventoryID) << ";";
         }
+        std::cout << std::endl;
+
+        // Fold this job's usage into the daily rollup and warn if stock runs short
+        reportStockAlerts(con);
     }
     catch (sql::SQLException& e) {
+        // The procedure rolls itself back on failure; nothing is left open here
+        if (isConnectionLost(e)) {
+            // runWrite already tried to restore the link; the journal is replayed on the next sync
+            std::string key = journalPrintJob(userID, pageCount, costPerPage);
+            std::cout << "[Offline] Print Job saved to the local journal (" << key << ")." << std::endl;
+            return;
+        }
         cerr << "Error in createPrintJob/Consumption: " << e.what() << endl;
     }
 }
@@ -372,93 +459,36 @@ void createPrintJob(sql::Connection* con, int userID, int pageCount, double cost
     }
 }*/
 void updatePrintJob(sql::Connection* con, int jobID, int newPageCount, double newCostPerPage) {
+    // If the user skipped both inputs, stop here. Do not run SQL.
+    if (newPageCount <= 0 && newCostPerPage <= 0.0) {
+        cout << "No changes requested. Update skipped." << endl;
+        return;
+    }
+
     try {
-        // 1. Fetch the OLD PageCount
+        // Old count, stock check on the per-item difference, job update and inventory
+        // adjustment in one CALL (run once, never replayed)
         int oldPageCount = 0;
-        unique_ptr<PreparedStatement> selectPstmt(
-            con->prepareStatement("SELECT PageCount FROM printjob WHERE JobID = ?")
-        );
-        selectPstmt->setInt(1, jobID);
-        unique_ptr<ResultSet> res(selectPstmt->executeQuery());
+        std::string error;
+        bool updated = runWrite(con, [&]() {
+            return callUpdateJob(con, jobID, newPageCount, newCostPerPage, oldPageCount, error);
+            });
 
-        if (!res->next()) {
-            cout << "[Error] Job ID not found." << endl;
+        if (!updated) {
+            cout << "[Error] Update failed: " << error << endl;
             return;
         }
-        oldPageCount = res->getInt("PageCount");
-
-        // 2. Inventory Logic (Only if pages changed)
-        int pageDiff = 0;
-        int inkDiff = 0;
-        if (newPageCount > 0 && newPageCount != oldPageCount) {
-            pageDiff = newPageCount - oldPageCount;
-            int oldInk = (oldPageCount + 99) / 100;
-            int newInk = (newPageCount + 99) / 100;
-            inkDiff = newInk - oldInk;
-
-            if (pageDiff > 0) {
-                if (!isInventorySufficient(con, pageDiff)) {
-                    cout << "[Error] Update failed: Insufficient inventory." << endl;
-                    return;
-                }
-            }
-        }
-
-        // 3. Build SQL (THE FIX IS HERE)
-        std::string sql = "UPDATE printjob SET ";
-        bool anyChange = false; // changed variable name from 'first' to 'anyChange' for clarity
-
-        if (newPageCount > 0) {
-            sql += "PageCount = ?";
-            anyChange = true;
-        }
-        if (newCostPerPage > 0.0) {
-            if (anyChange) sql += ", "; // Add comma if we already added PageCount
-            sql += "CostPerPage = ?";
-            anyChange = true;
-        }
-
-        // --- CRITICAL CHECK ---
-        // If the user skipped both inputs, stop here. Do not run SQL.
-        if (!anyChange) {
-            cout << "No changes requested. Update skipped." << endl;
-            return;
-        }
-
-        sql += " WHERE JobID = ?";
-
-        // 4. Execute Update
-        unique_ptr<PreparedStatement> pstmt(con->prepareStatement(sql));
-        int idx = 1;
-        if (newPageCount > 0) pstmt->setInt(idx++, newPageCount);
-        if (newCostPerPage > 0.0) pstmt->setDouble(idx++, newCostPerPage);
-        pstmt->setInt(idx++, jobID);
-        pstmt->executeUpdate();
-
-        // 5. Adjust Inventory (if needed)
-        if (pageDiff != 0) {
-            // Adjust Paper
-            unique_ptr<PreparedStatement> paperUpd(
-                con->prepareStatement("UPDATE inventory SET Quantity = Quantity - ? WHERE ItemType = 'Paper'")
-            );
-            paperUpd->setInt(1, pageDiff);
-            paperUpd->executeUpdate();
-
-            // Adjust Ink
-            if (inkDiff != 0) {
-                unique_ptr<PreparedStatement> inkUpd(
-                    con->prepareStatement("UPDATE inventory SET Quantity = Quantity - ? WHERE ItemType = 'Ink'")
-                );
-                inkUpd->setInt(1, inkDiff);
-                inkUpd->executeUpdate();
-            }
-            cout << "[Success] Inventory adjusted." << endl;
-        }
+        if (newPageCount > 0 && newPageCount != oldPageCount) cout << "[Success] Inventory adjusted." << endl;
 
         cout << "[Success] Print Job updated successfully!" << endl;
 
     }
     catch (sql::SQLException& e) {
+        // The procedure rolls itself back on failure; nothing is left open here
+        if (isConnectionLost(e)) {
+            cerr << "[Error] Connection lost - update NOT saved. Please retry." << endl;
+            return;
+        }
         cerr << "Error updating print job: " << e.what() << endl;
     }
 }
@@ -472,7 +502,7 @@ void deletePrintJob(sql::Connection* con, int jobID) {
         );
         pstmt->setInt(1, jobID);
 
-        if (pstmt->executeUpdate() > 0) {
+        if (runWrite(con, [&]() { return pstmt->executeUpdate(); }) > 0) {
             cout << "Job Deleted successfully!" << endl;
         }
         else {
@@ -480,6 +510,10 @@ void deletePrintJob(sql::Connection* con, int jobID) {
         }
     }
     catch (sql::SQLException& e) {
+        if (isConnectionLost(e)) {
+            cerr << "[Error] Connection lost - job NOT deleted. Please retry." << endl;
+            return;
+        }
         cerr << "Error deleting print job: " << e.what() << endl;
     }
 }
@@ -489,7 +523,7 @@ void searchPrintJob(sql::Connection* con, int jobID) {
     try {
         // ... (rest of search logic is fine)
         unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement("SELECT UserID, PageCount, TimeStamp, CostPerPage, JobCost FROM printjob WHERE JobID = ?")
+            con->prepareStatement(SQL_JOB_DETAILS)
         );
         pstmt->setInt(1, jobID);
         unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
@@ -500,7 +534,7 @@ void searchPrintJob(sql::Connection* con, int jobID) {
             cout << left << setw(15) << "Page Count:" << res->getInt("PageCount") << endl;
             cout << left << setw(15) << "Timestamp:" << res->getString("TimeStamp") << endl;
             cout << left << setw(15) << "Cost Per Page:" << fixed << setprecision(2) << res->getDouble("CostPerPage") << endl;
-            cout << left << setw(15) << "Job Cost:" << fixed << setprecision(2) << res->getDouble("JobCost") << endl;
+            cout << left << setw(15) << "Job Cost:" << getMoney(*res, "JobCost") << endl;
         }
         else {
             cout << "Job Not Exist." << endl;
@@ -517,13 +551,9 @@ void searchPrintJob(sql::Connection* con, int jobID) {
 int readCustomers(sql::Connection* con) {
     int customerCount = 0;
     try {
-        // Get Total Count first
-        customerCount = countCustomerUsers(con);
-
-        std::unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement("SELECT UserID, FullName, Email FROM user WHERE Role = 'Customer' ORDER BY UserID ASC")
-        );
-        std::unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+        // Rendered from the in-memory directory; the server is only asked whether it changed
+        std::shared_ptr<const std::vector<CustomerEntry>> customers = customerDirectory(con);
+        customerCount = static_cast<int>(customers->size());
 
         const int ID_W = 10, NAME_W = 25, EMAIL_W = 35;
         const int TOTAL_WIDTH = ID_W + NAME_W + EMAIL_W + 4;
@@ -542,11 +572,11 @@ int readCustomers(sql::Connection* con) {
 
         printHeader();
 
-        while (res->next()) {
+        for (const CustomerEntry& customer : *customers) {
             displayed++;
-            std::cout << "| " << std::left << std::setw(ID_W - 2) << res->getInt("UserID") << " | "
-                << std::left << std::setw(NAME_W - 3) << res->getString("FullName") << " | "
-                << std::left << std::setw(EMAIL_W - 3) << res->getString("Email") << " |" << std::endl;
+            std::cout << "| " << std::left << std::setw(ID_W - 2) << customer.userID << " | "
+                << std::left << std::setw(NAME_W - 3) << customer.fullName << " | "
+                << std::left << std::setw(EMAIL_W - 3) << customer.email << " |" << std::endl;
 
             if (displayed % pageSize == 0 && displayed < customerCount) {
                 std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
@@ -568,16 +598,8 @@ int readCustomers(sql::Connection* con) {
 
 int countCustomerUsers(sql::Connection* con) {
     try {
-        std::unique_ptr<sql::Statement> stmt(con->createStatement());
-        // Use COUNT(*) for maximum efficiency and minimum data transfer
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(
-            "SELECT COUNT(UserID) AS customer_count FROM user WHERE Role = 'Customer'"
-        ));
-
-        if (res->next()) {
-            // Return the count directly
-            return res->getInt("customer_count");
-        }
+        // Maintained per-role counter: one primary-key read per menu pass
+        return static_cast<int>(rowCount(con, "user", "Customer"));
     }
     catch (sql::SQLException& e) {
         // Suppress output (remove cerr/cout lines) but return 0 in case of error
@@ -589,25 +611,24 @@ int countCustomerUsers(sql::Connection* con) {
 
 void readPrintJobs(sql::Connection* con) {
     try {
-        // 1. Get total job count
-        std::unique_ptr<sql::Statement> stmtCount(con->createStatement());
-        std::unique_ptr<sql::ResultSet> resCount(stmtCount->executeQuery("SELECT COUNT(*) FROM printjob"));
-        long long totalJobs = 0;
-        if (resCount->next()) totalJobs = resCount->getInt64(1);
-
-        // 2. Query data
-        std::unique_ptr<sql::Statement> stmt(con->createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery(
-            "SELECT p.JobID, p.UserID, u.FullName, p.PageCount, p.JobCost "
-            "FROM printjob p JOIN user u ON p.UserID = u.UserID "
-            "ORDER BY p.JobID DESC"
-        ));
+        // 1. Get total job count (maintained counter, no table scan)
+        long long totalJobs = rowCount(con, "printjob");
 
         const int JOB_ID_W = 10, USER_ID_W = 10, NAME_W = 25, PAGE_W = 12, COST_W = 12;
         const int TOTAL_WIDTH = JOB_ID_W + USER_ID_W + NAME_W + PAGE_W + COST_W + 6;
-
-        int displayed = 0;
-        int pageSize = 20;
+        const int pageSize = 20;
+
+        // 2. Stream the data; the next page is decoded while this one is read
+        ListPager pager(con, SQL_JOB_LIST,
+            pageSize, [&](sql::ResultSet& res) {
+                std::ostringstream line;
+                line << "| " << std::left << std::setw(JOB_ID_W - 2) << res.getInt("JobID") << " | "
+                    << std::left << std::setw(USER_ID_W - 2) << res.getInt("UserID") << " | "
+                    << std::left << std::setw(NAME_W - 2) << res.getString("FullName") << " | "
+                    << std::left << std::setw(PAGE_W - 2) << res.getInt("PageCount") << " | "
+                    << std::left << std::setw(COST_W - 2) << getMoney(res, "JobCost") << " |";
+                return line.str();
+            }, StreamSource::ReplicaFirst);
 
         auto printHeader = [&]() {
             std::cout << "\n--- Job History (" << totalJobs << " records) ---\n";
@@ -620,26 +641,7 @@ void readPrintJobs(sql::Connection* con) {
             std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
             };
 
-        printHeader();
-
-        while (res->next()) {
-            displayed++;
-            std::cout << "| " << std::left << std::setw(JOB_ID_W - 2) << res->getInt("JobID") << " | "
-                << std::left << std::setw(USER_ID_W - 2) << res->getInt("UserID") << " | "
-                << std::left << std::setw(NAME_W - 2) << res->getString("FullName") << " | "
-                << std::left << std::setw(PAGE_W - 2) << res->getInt("PageCount") << " | "
-                << std::left << std::setw(COST_W - 2) << std::fixed << std::setprecision(2) << res->getDouble("JobCost") << " |" << std::endl;
-
-            if (displayed % pageSize == 0 && displayed < totalJobs) {
-                std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
-                std::cout << ">>> [" << displayed << "/" << totalJobs << "] Enter for more, 's' to stop: ";
-                std::string input;
-                std::getline(std::cin >> std::ws, input);
-                if (!input.empty() && std::tolower(input[0]) == 's') break;
-                printHeader();
-            }
-        }
-        std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
+        browsePages(pager, totalJobs, pageSize, printHeader, "+" + std::string(TOTAL_WIDTH - 2, '-') + "+");
 
     }
     catch (sql::SQLException& e) {
@@ -807,7 +809,7 @@ void readPrintJobs(sql::Connection* con) {
 bool searchUsersByName(sql::Connection* con, string nameInput) {
     try {
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT UserID, FullName, Email FROM user WHERE FullName LIKE ? AND Role = 'Customer'")
+            con->prepareStatement(SQL_CUSTOMER_SEARCH)
         );
         pstmt->setString(1, "%" + nameInput + "%");
         unique_ptr<ResultSet> res(pstmt->executeQuery());
@@ -840,7 +842,7 @@ bool listJobsForUser(sql::Connection* con, int userID) {
     try {
         // We still fetch the data, ordered by newest first
         unique_ptr<PreparedStatement> pstmt(
-            con->prepareStatement("SELECT JobID, PageCount, TimeStamp, JobCost FROM printjob WHERE UserID = ? ORDER BY TimeStamp DESC")
+            con->prepareStatement(SQL_JOBS_FOR_USER)
         );
         pstmt->setInt(1, userID);
         unique_ptr<ResultSet> res(pstmt->executeQuery());
@@ -860,7 +862,7 @@ bool listJobsForUser(sql::Connection* con, int userID) {
         while (res->next()) {
             cout << left << setw(10) << res->getInt("JobID")
                 << setw(15) << res->getInt("PageCount")
-                << "$" << setw(11) << fixed << setprecision(2) << res->getDouble("JobCost")
+                << "$" << setw(11) << getMoney(*res, "JobCost")
                 << setw(25) << res->getString("TimeStamp") << endl;
 
             rowCount++;
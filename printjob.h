@@ -3,6 +3,7 @@
 #include <string>
 #include <memory>
 #include <cppconn/connection.h>
+#include "Repositories.h"
 
 // Forward declaration of the Print Job Management Menu function
 void PrintJobManagementMenu(sql::Connection* con);
@@ -12,6 +13,37 @@ void PrintJobManagementMenu(sql::Connection* con);
 // Create Print Job (based on C1 -> CX3 in flowchart)
 void createPrintJob(sql::Connection* con, int userID, int pageCount, double costPerPage);
 
+// How insertPrintJobRecord touches inventory stock
+enum class StockUpdate {
+    Guarded,   // decrement only if enough is left, else throw (live job creation)
+    Unchecked, // always decrement (the paper is already used)
+    Deferred   // leave stock alone; the caller writes it in batches
+               // (InventoryReservations, ConsumptionBatch during journal replay)
+};
+
+// Queue priority for a job no printer queue owns: it lands as Done
+const int NOT_QUEUED = -1;
+const int MAX_QUEUE_PRIORITY = 9;
+
+// Inserts the job row and its inventory consumption (no transaction handling,
+// no output). Empty timeStamp means NOW(). A queuePriority of 0..MAX_QUEUE_PRIORITY
+// (higher prints first) writes the row as Queued for the server's printers.
+// Returns the new JobID; throws sql::SQLException.
+int insertPrintJobRecord(sql::Connection* con, int userID, int pageCount, double costPerPage,
+    const std::string& timeStamp, StockUpdate stock = StockUpdate::Guarded, int queuePriority = NOT_QUEUED);
+
+// Job rules on any backend (Repositories.h): customer check, then stock for every
+// bill-of-materials line is taken and logged, then the job is added. Returns the
+// JobID, or -1 with `error` set; nothing is written when it is rejected.
+int placePrintJob(UserRepo& users, PrintJobRepo& jobs, InventoryRepo& inventory, BomRange bom,
+    int userID, int pageCount, double costPerPage, const std::string& timeStamp, int queuePriority, std::string& error);
+
+// placePrintJob on the MySQL backend, for server mode when the reservation
+// counters are unavailable. The stock rows stay locked until the caller's
+// transaction ends. No output and no transaction handling; throws sql::SQLException.
+int placePrintJobRecord(sql::Connection* con, int userID, int pageCount, double costPerPage,
+    int queuePriority, std::string& error);
+
 // Read/Search Print Job (based on S1 -> S3 in flowchart)
 void searchPrintJob(sql::Connection* con, int jobID);
 
@@ -21,6 +53,10 @@ void updatePrintJob(sql::Connection* con, int jobID, int newPageCount, double ne
 // Delete Print Job (based on DEL1 -> DX2 in flowchart)
 void deletePrintJob(sql::Connection* con, int jobID);
 
+// True only for users with the 'Customer' role (or when the link is lost: the
+// database is marked offline and the journal replay decides)
+bool isCustomerUser(sql::Connection* con, int userID);
+
 // Helper function to check if a UserID exists (C2 in flowchart)
 bool doesUserExist(sql::Connection* con, int userID);
 
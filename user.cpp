@@ -1,13 +1,25 @@
 #include "user.h"        // <-- VERY IMPORTANT
 #include "utils.h"       // for isValidEmail(), isValidRole()
+#include "PasswordHash.h" // for hashPassword()
+#include "CustomerDirectory.h"
+#include "RowCounts.h"
+#include "ResultStreaming.h"
+#include "QueryPlanCheck.h"
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <map>
 #include <cppconn/prepared_statement.h>
 #include <cppconn/resultset.h>
 #include <cppconn/exception.h>
 
 using namespace std;
+
+namespace {
+    const char* const SQL_USER_LIST = "SELECT UserID, FullName, Email, Role FROM user ORDER BY UserID ASC";
+    const PlanRegistration planUserList("user_list", "user.cpp", SQL_USER_LIST, {});
+}
+
 void createUser(sql::Connection* con, const string& fullName, const string& email, const string& pwd, const string& role) {
     try {
         unique_ptr<sql::PreparedStatement> pstmt(
@@ -22,11 +34,12 @@ void createUser(sql::Connection* con, const string& fullName, const string& emai
             pstmt->setString(3, "N/A"); // Default placeholder for customers
         }
         else {
-            pstmt->setString(3, pwd);   // Standard password for Admin/Staff
+            pstmt->setString(3, hashPassword(pwd));   // Salted scrypt hash for Admin/Staff
         }
 
         pstmt->setString(4, role);
         pstmt->executeUpdate();
+        bumpCustomerDirectoryVersion(con);
 
         if (role == "Customer") {
             cout << "Registration Success (Customer: No password required)\n";
@@ -48,15 +61,18 @@ void createUser(sql::Connection* con, const string& fullName, const string& emai
 
 void readUsers(sql::Connection* con) {
     try {
-        // Step 1: Get Total Count for Perspective
-        std::unique_ptr<sql::Statement> countStmt(con->createStatement());
-        std::unique_ptr<sql::ResultSet> countRes(countStmt->executeQuery("SELECT COUNT(*) FROM user"));
-        long long totalUsers = 0;
-        if (countRes->next()) totalUsers = countRes->getInt64(1);
+        // Step 1: Get Total Count for Perspective (maintained counters, no table scan)
+        long long totalUsers = rowCount(con, "user");
+        std::map<std::string, long long> byRole = userCountsByRole(con);
+        std::string roleSummary;
+        for (const auto& role : byRole) {
+            roleSummary += (roleSummary.empty() ? " (" : ", ") + role.first + ": " + std::to_string(role.second);
+        }
+        if (!roleSummary.empty()) roleSummary += ")";
 
-        // Step 2: Query for data
-        std::unique_ptr<sql::Statement> stmt(con->createStatement());
-        std::unique_ptr<sql::ResultSet> res(stmt->executeQuery("SELECT UserID, FullName, Email, Role FROM user ORDER BY UserID ASC"));
+        // Step 2: Stream the data, one row in memory at a time
+        ResultStream stream(con, SQL_USER_LIST, StreamSource::ReplicaFirst);
+        sql::ResultSet& res = stream.row();
 
         const int ID_W = 8, NAME_W = 25, EMAIL_W = 35, ROLE_W = 12;
         const int TOTAL_WIDTH = ID_W + NAME_W + EMAIL_W + ROLE_W + 5;
@@ -65,7 +81,7 @@ void readUsers(sql::Connection* con) {
         int pageSize = 20;
 
         auto printHeader = [&]() {
-            std::cout << "\nTotal Registered Users: " << totalUsers << "\n";
+            std::cout << "\nTotal Registered Users: " << totalUsers << roleSummary << "\n";
             std::cout << "+" << std::string(TOTAL_WIDTH - 2, '-') << "+" << std::endl;
             std::cout << "| " << std::left << std::setw(ID_W - 2) << "ID" << " | "
                 << std::left << std::setw(NAME_W - 3) << "FullName" << " | "
@@ -76,11 +92,11 @@ void readUsers(sql::Connection* con) {
 
         printHeader();
 
-        while (res->next()) {
-            std::cout << "| " << std::left << std::setw(ID_W - 2) << res->getInt("UserID") << " | "
-                << std::left << std::setw(NAME_W - 3) << res->getString("FullName") << " | "
-                << std::left << std::setw(EMAIL_W - 3) << res->getString("Email") << " | "
-                << std::left << std::setw(ROLE_W - 2) << res->getString("Role") << " |" << std::endl;
+        while (stream.next()) {
+            std::cout << "| " << std::left << std::setw(ID_W - 2) << res.getInt("UserID") << " | "
+                << std::left << std::setw(NAME_W - 3) << res.getString("FullName") << " | "
+                << std::left << std::setw(EMAIL_W - 3) << res.getString("Email") << " | "
+                << std::left << std::setw(ROLE_W - 2) << res.getString("Role") << " |" << std::endl;
 
             rowCount++;
 
@@ -162,7 +178,7 @@ void updateUser(sql::Connection* con,
         int idx = 1;
         if (!newName.empty())  pstmt->setString(idx++, newName);
         if (!newEmail.empty()) pstmt->setString(idx++, newEmail);
-        if (!newPwd.empty())   pstmt->setString(idx++, newPwd); // TODO: hash in production
+        if (!newPwd.empty())   pstmt->setString(idx++, hashPassword(newPwd));
         if (!newRole.empty())  pstmt->setString(idx++, newRole);
         pstmt->setInt(idx++, userID);
 
@@ -171,6 +187,7 @@ void updateUser(sql::Connection* con,
             std::cout << "No new data. No changes made.\n";
         }
         else {
+            bumpCustomerDirectoryVersion(con);
             std::cout << "User Updated Successfully\n";
         }
 
@@ -192,6 +209,7 @@ void deleteUser(sql::Connection* con, int userID) {
         );
         pstmt->setInt(1, userID);
         pstmt->executeUpdate();
+        bumpCustomerDirectoryVersion(con);
         cout << "User deleted successfully!\n";
     }
     catch (sql::SQLException& e) {
@@ -7,6 +7,8 @@
 #include <cppconn/prepared_statement.h> // Define sql::PreparedStatement
 #include <cppconn/resultset.h>          // Define sql::ResultSet
 #include <conio.h> // Windows specific for _getch()
+#include "OfflineJournal.h"
+#include "QueryPlanCheck.h"
 
 void clearScreen() {
     system("cls");
@@ -64,6 +66,15 @@ void clearScreen() {
     }
 }*/
 // Update this line to accept two parameters
+namespace {
+    const char* const SQL_NAME_SEARCH_USERS =
+        "SELECT u.FullName, u.UserID, u.Email "
+        "FROM user u "
+        "WHERE u.FullName LIKE ? "
+        "GROUP BY u.UserID"; // Hides JID/TID noise
+    const PlanRegistration planNameSearchUsers("name_search_users", "utils.cpp", SQL_NAME_SEARCH_USERS, { "%Customer 17%" });
+}
+
 bool searchIDsByCustomerName(sql::Connection* con, std::string nameInput) {
     // You no longer need to ask for input inside the function because 
     // it's now passed from the 'case 3' menu
@@ -72,12 +83,7 @@ bool searchIDsByCustomerName(sql::Connection* con, std::string nameInput) {
 
     try {
         // SQL optimized to prevent duplicate rows from your 100,000+ transactions
-        std::unique_ptr<sql::PreparedStatement> pstmt(con->prepareStatement(
-            "SELECT u.FullName, u.UserID, u.Email "
-            "FROM user u "
-            "WHERE u.FullName LIKE ? "
-            "GROUP BY u.UserID" // Hides JID/TID noise
-        ));
+        std::unique_ptr<sql::PreparedStatement> pstmt(con->prepareStatement(SQL_NAME_SEARCH_USERS));
         pstmt->setString(1, searchPattern);
         std::unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
 
@@ -96,6 +102,11 @@ bool searchIDsByCustomerName(sql::Connection* con, std::string nameInput) {
         return false;
     }
     catch (sql::SQLException& e) {
+        if (isConnectionLost(e)) {
+            markDatabaseOffline();
+            std::cout << "[Offline] Customer search unavailable. Enter the User ID directly.\n";
+            return true;
+        }
         return false;
     }
 }